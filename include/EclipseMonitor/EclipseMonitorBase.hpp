@@ -118,6 +118,16 @@ public:
 
 	virtual void Update(const std::vector<uint8_t>& hdrBinary) = 0;
 
+	/**
+	 * @brief Update the monitor with a header binary that is stored in a
+	 *        buffer owned by the caller (e.g., a receive buffer), without
+	 *        copying it into a vector first
+	 *
+	 * @param hdrBinary Pointer to the beginning of the header binary
+	 * @param hdrSize   Size of the header binary, in bytes
+	 */
+	virtual void Update(const uint8_t* hdrBinary, size_t hdrSize) = 0;
+
 	virtual void EndBootstrapI()
 	{
 		m_phase = Phases::BootstrapII;
@@ -7,7 +7,9 @@
 
 
 #include <cstdint>
+#include <cstring>
 
+#include <algorithm>
 #include <tuple>
 #include <type_traits>
 #include <vector>
@@ -110,8 +112,86 @@ struct RealNumTypeTraits<Internal::Obj::RealNumType::UInt64> :
 {}; // struct RealNumTypeTraits<Internal::Obj::RealNumType::UInt64>
 
 
+/**
+ * @brief Whether the given iterator type refers to contiguous bytes, so the
+ *        input can be checked and read a whole chunk at a time
+ *
+ */
+template<typename _It>
+struct AbiIsContiguousIt :
+	std::integral_constant<
+		bool,
+		std::is_same<_It, uint8_t*>::value ||
+		std::is_same<_It, const uint8_t*>::value ||
+		std::is_same<_It, std::vector<uint8_t>::iterator>::value ||
+		std::is_same<_It, std::vector<uint8_t>::const_iterator>::value
+	>
+{}; // struct AbiIsContiguousIt
+
+
+/**
+ * @brief Get the pointer to the next `len` bytes of a contiguous input,
+ *        after checking they are all in the input
+ *
+ */
+template<typename _It>
+inline const uint8_t* AbiContiguousRead(size_t len, _It begin, _It end)
+{
+	if (len > static_cast<size_t>(end - begin))
+	{
+		throw Exception("ABI parser - unexpected end of input");
+	}
+	return len == 0 ? nullptr : &(*begin);
+}
+
+
+/**
+ * @brief Check if the given bytes are all zeros, by comparing 8 bytes at a
+ *        time
+ *
+ */
+inline bool AbiIsZeroBytes(const uint8_t* ptr, size_t len)
+{
+	uint64_t acc = 0;
+	for (; len >= sizeof(uint64_t); len -= sizeof(uint64_t))
+	{
+		uint64_t word = 0;
+		std::memcpy(&word, ptr, sizeof(word));
+		acc |= word;
+		ptr += sizeof(uint64_t);
+	}
+	for (; len > 0; --len)
+	{
+		acc |= *(ptr++);
+	}
+	return acc == 0;
+}
+
+
+/**
+ * @brief Load a big-endian unsigned integer from the given bytes; the
+ *        fixed-size loop is compiled into a single load and byte swap
+ *
+ */
+template<typename _T>
+inline _T AbiLoadBigEndian(const uint8_t* ptr)
+{
+	_T res = 0;
+	for (size_t i = 0; i < sizeof(_T); ++i)
+	{
+		res = static_cast<_T>((res << 8) | ptr[i]);
+	}
+	return res;
+}
+
+
 template<bool _CheckVal, typename _It>
-inline _It AbiParserSkipPadding(size_t skipLen, _It begin, _It end)
+inline _It AbiParserSkipPadding(
+	size_t skipLen,
+	_It begin,
+	_It end,
+	std::false_type /* IsContiguous? - false */
+)
 {
 	for (size_t i = 0; i < skipLen; ++i)
 	{
@@ -131,12 +211,44 @@ inline _It AbiParserSkipPadding(size_t skipLen, _It begin, _It end)
 }
 
 
+template<bool _CheckVal, typename _It>
+inline _It AbiParserSkipPadding(
+	size_t skipLen,
+	_It begin,
+	_It end,
+	std::true_type /* IsContiguous? - true */
+)
+{
+	const uint8_t* ptr = AbiContiguousRead(skipLen, begin, end);
+	if (_CheckVal && (skipLen > 0) && !AbiIsZeroBytes(ptr, skipLen))
+	{
+		throw Exception(
+			"ABI parser - there are non-zero bytes in skipped bytes"
+		);
+	}
+	return begin + skipLen;
+}
+
+
+template<bool _CheckVal, typename _It>
+inline _It AbiParserSkipPadding(size_t skipLen, _It begin, _It end)
+{
+	return AbiParserSkipPadding<_CheckVal>(
+		skipLen,
+		begin,
+		end,
+		AbiIsContiguousIt<_It>()
+	);
+}
+
+
 template<typename _SrcIt, typename _DestIt>
 inline _SrcIt AbiParserCopyBytes(
 	size_t len,
 	_SrcIt begin,
 	_SrcIt end,
-	_DestIt dest
+	_DestIt dest,
+	std::false_type /* IsContiguous? - false */
 )
 {
 	for (size_t i = 0; i < len; ++i)
@@ -151,6 +263,39 @@ inline _SrcIt AbiParserCopyBytes(
 }
 
 
+template<typename _SrcIt, typename _DestIt>
+inline _SrcIt AbiParserCopyBytes(
+	size_t len,
+	_SrcIt begin,
+	_SrcIt end,
+	_DestIt dest,
+	std::true_type /* IsContiguous? - true */
+)
+{
+	const uint8_t* ptr = AbiContiguousRead(len, begin, end);
+	std::copy(ptr, ptr + len, dest);
+	return begin + len;
+}
+
+
+template<typename _SrcIt, typename _DestIt>
+inline _SrcIt AbiParserCopyBytes(
+	size_t len,
+	_SrcIt begin,
+	_SrcIt end,
+	_DestIt dest
+)
+{
+	return AbiParserCopyBytes(
+		len,
+		begin,
+		end,
+		dest,
+		AbiIsContiguousIt<_SrcIt>()
+	);
+}
+
+
 template<bool _CheckVal, typename _SrcIt, typename _DestIt>
 inline _SrcIt AbiParserCopyBytesThenSkip(
 	size_t copyLen,
@@ -218,6 +363,12 @@ struct AbiCodecImpl<
 	~AbiCodecImpl() = default;
 
 
+	size_t GetNumOfChunks() const
+	{
+		return 1;
+	}
+
+
 	template<typename _ItType>
 	std::tuple<
 		Primitive, /* Parsed value */
@@ -225,6 +376,49 @@ struct AbiCodecImpl<
 		size_t     /* Number of chunks consumed */
 	>
 	ToPrimitive(_ItType begin, _ItType end) const
+	{
+		return ToPrimitive(begin, end, AbiIsContiguousIt<_ItType>());
+	}
+
+private:
+
+	template<typename _ItType>
+	std::tuple<Primitive, _ItType, size_t>
+	ToPrimitive(
+		_ItType begin,
+		_ItType end,
+		std::true_type /* IsContiguous? - true */
+	) const
+	{
+		// check the bounds of the whole chunk at once
+		const uint8_t* ptr = AbiContiguousRead(
+			AbiParserConst::sk_chunkSize(),
+			begin,
+			end
+		);
+		if (!AbiIsZeroBytes(ptr, sk_skipLeadSize))
+		{
+			throw Exception(
+				"ABI parser - there are non-zero bytes in skipped bytes"
+			);
+		}
+
+		Primitive res = AbiLoadBigEndian<Primitive>(ptr + sk_skipLeadSize);
+
+		return std::make_tuple(
+			res,
+			begin + AbiParserConst::sk_chunkSize(),
+			1
+		);
+	}
+
+	template<typename _ItType>
+	std::tuple<Primitive, _ItType, size_t>
+	ToPrimitive(
+		_ItType begin,
+		_ItType end,
+		std::false_type /* IsContiguous? - false */
+	) const
 	{
 		// Skip the leading zero bytes that are larger than the target type
 		begin = AbiParserSkipPadding<true>(
@@ -274,6 +468,12 @@ struct AbiCodecImpl<
 	~AbiCodecImpl() = default;
 
 
+	size_t GetNumOfChunks() const
+	{
+		return 1;
+	}
+
+
 	template<typename _ItType>
 	std::tuple<
 		Primitive,  /* Parsed value */
@@ -319,6 +519,12 @@ struct AbiCodecImpl<
 	~AbiCodecImpl() = default;
 
 
+	size_t GetNumOfChunks() const
+	{
+		return 1;
+	}
+
+
 	template<typename _ItType>
 	std::tuple<
 		Primitive, /* Parsed value */
@@ -443,6 +649,12 @@ struct AbiCodecImpl<
 	~AbiCodecImpl() = default;
 
 
+	size_t GetNumOfChunks() const
+	{
+		return m_size * m_itemParser.GetNumOfHeadChunks();
+	}
+
+
 	template<typename _ItType>
 	std::tuple<
 		Primitive, /* Parsed value */
@@ -770,6 +982,16 @@ struct AbiParserHeadOnlyTypes
 	// LCOV_EXCL_STOP
 
 
+	/**
+	 * @brief Get the number of chunks in the head part
+	 *
+	 */
+	size_t GetNumOfHeadChunks() const
+	{
+		return m_headCodec.GetNumOfChunks();
+	}
+
+
 	template<typename _ItType>
 	std::tuple<
 		HeadPrimitive, /* Parsed value */
@@ -834,6 +1056,16 @@ struct AbiParserHeadTailTypes
 	// LCOV_EXCL_STOP
 
 
+	/**
+	 * @brief Get the number of chunks in the head part (i.e., the offset)
+	 *
+	 */
+	size_t GetNumOfHeadChunks() const
+	{
+		return m_headCodec.GetNumOfChunks();
+	}
+
+
 	template<typename _ItType>
 	std::tuple<
 		HeadPrimitive, /* Parsed value */
@@ -899,9 +1131,7 @@ struct AbiParserHeadTailTypes
 		begin = std::next(blockBegin, static_cast<_ItDiffType>(offset));
 
 		// parse the tail
-		Primitive res;
-		std::tie(res, std::ignore, std::ignore) =
-			TailToPrimitive(begin, end);
+		Primitive res = std::get<0>(TailToPrimitive(begin, end));
 
 		return std::make_tuple(res, headEnd);
 	}
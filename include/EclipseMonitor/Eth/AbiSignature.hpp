@@ -0,0 +1,904 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "../Exceptions.hpp"
+#include "AbiParser.hpp"
+#include "AbiViewParser.hpp"
+#include "DataTypes.hpp"
+
+
+namespace EclipseMonitor
+{
+namespace Eth
+{
+
+
+enum class AbiTypeKind : uint8_t
+{
+	UInt,
+	Int,
+	Address,
+	Bool,
+	FixedBytes, // bytes<M>
+	Bytes,
+	String,
+	FixedList,  // T[k]
+	List,       // T[]
+	Tuple,
+}; // enum class AbiTypeKind
+
+
+/**
+ * @brief One type in a decode plan, with everything needed to decode it
+ *        computed when the plan is compiled
+ *
+ */
+struct AbiTypeNode
+{
+	AbiTypeKind m_kind;
+	bool m_isDynamic;
+	// the size taken in the heads of the enclosing type
+	size_t m_headSize;
+	// number of bits for integers, M for bytes<M>, and k for T[k]
+	size_t m_param;
+	// the size of the heads of the items, for T[k] and tuples
+	size_t m_blockSize;
+	// the node of the items, for T[k] and T[]
+	size_t m_itemIdx;
+	// the range in the list of fields, for tuples
+	size_t m_fieldsBegin;
+	size_t m_numFields;
+}; // struct AbiTypeNode
+
+
+/**
+ * @brief A field of a tuple in a decode plan
+ *
+ */
+struct AbiTupleField
+{
+	size_t m_nodeIdx;
+	// the offset of the field's head from the beginning of the tuple
+	size_t m_headOffset;
+}; // struct AbiTupleField
+
+
+class AbiValueView;
+
+
+/**
+ * @brief A decode plan compiled from an ABI type string, such as
+ *        "(address,uint256,bytes32[],string)".
+ *        The type string is only interpreted once, when the plan is
+ *        compiled; the types are stored in a flat list, with the head
+ *        offsets of tuple fields and whether each type is dynamic computed
+ *        in advance, so decoding a payload only follows the plan.
+ *
+ */
+class AbiDecodePlan
+{
+public: // static members:
+
+	/**
+	 * @brief Compile the given ABI type string into a decode plan
+	 *
+	 */
+	static AbiDecodePlan Compile(const std::string& signature)
+	{
+		AbiDecodePlan plan;
+		size_t pos = 0;
+		plan.m_rootIdx = plan.CompileType(signature, pos);
+		if (pos != signature.size())
+		{
+			throw Exception(
+				"ABI signature - unexpected character at " +
+				std::to_string(pos)
+			);
+		}
+		return plan;
+	}
+
+public:
+
+	// LCOV_EXCL_START
+	~AbiDecodePlan() = default;
+	// LCOV_EXCL_STOP
+
+	const AbiTypeNode& GetNode(size_t idx) const
+	{
+		return m_nodes[idx];
+	}
+
+	const AbiTupleField& GetField(size_t idx) const
+	{
+		return m_fields[idx];
+	}
+
+	const AbiTypeNode& GetRoot() const
+	{
+		return m_nodes[m_rootIdx];
+	}
+
+	/**
+	 * @brief Decode the given payload; the whole payload is validated
+	 *        here, and the values are read when they are accessed through
+	 *        the returned view.
+	 *        Payloads whose tails overlap too much to be validated in
+	 *        linear time are rejected.
+	 *        Both the plan and the payload must outlive the view.
+	 *
+	 */
+	AbiValueView Decode(const uint8_t* data, size_t size) const;
+
+	/**
+	 * @brief Get where the value of the given node starts, given the
+	 *        beginning of the heads block it is in, and its head
+	 *
+	 */
+	const uint8_t* ResolveValue(
+		const AbiTypeNode& node,
+		const uint8_t* headsBegin,
+		size_t headsSize,
+		const uint8_t* head,
+		const uint8_t* end
+	) const
+	{
+		if (!node.m_isDynamic)
+		{
+			return head;
+		}
+
+		// the tail must be after all heads, and be aligned to chunks
+		const uint64_t offset = ReadUInt64(head);
+		if ((offset < headsSize) ||
+			(offset > static_cast<uint64_t>(end - headsBegin)) ||
+			((offset % AbiParserConst::sk_chunkSize()) != 0))
+		{
+			throw Exception("ABI parser - invalid offset");
+		}
+		return headsBegin + static_cast<size_t>(offset);
+	}
+
+	/**
+	 * @brief Read a chunk holding an unsigned integer that must fit in
+	 *        64 bits
+	 *
+	 */
+	static uint64_t ReadUInt64(const uint8_t* chunk)
+	{
+		if (!EthInternal::AbiIsZeroBytes(chunk, 24))
+		{
+			throw Exception("ABI parser - the value is too large");
+		}
+		return EthInternal::AbiLoadBigEndian<uint64_t>(chunk + 24);
+	}
+
+	static bool IsAllBytes(
+		const uint8_t* begin,
+		const uint8_t* end,
+		uint8_t val
+	)
+	{
+		return std::all_of(
+			begin,
+			end,
+			[val](uint8_t b) { return b == val; }
+		);
+	}
+
+private:
+
+	AbiDecodePlan() :
+		m_nodes(),
+		m_fields(),
+		m_rootIdx(0)
+	{}
+
+	size_t AddNode(const AbiTypeNode& node)
+	{
+		m_nodes.push_back(node);
+		return m_nodes.size() - 1;
+	}
+
+	static AbiTypeNode NewNode(AbiTypeKind kind, bool isDynamic)
+	{
+		AbiTypeNode node;
+		node.m_kind = kind;
+		node.m_isDynamic = isDynamic;
+		node.m_headSize = AbiParserConst::sk_chunkSize();
+		node.m_param = 0;
+		node.m_blockSize = 0;
+		node.m_itemIdx = 0;
+		node.m_fieldsBegin = 0;
+		node.m_numFields = 0;
+		return node;
+	}
+
+	static size_t ParseNum(
+		const std::string& str,
+		size_t begin,
+		size_t end
+	)
+	{
+		static constexpr size_t sk_maxSize =
+			std::numeric_limits<size_t>::max();
+
+		if ((begin == end) || (str[begin] == '0'))
+		{
+			throw Exception("ABI signature - invalid number in " + str);
+		}
+		size_t res = 0;
+		for (size_t i = begin; i < end; ++i)
+		{
+			if ((str[i] < '0') || (str[i] > '9'))
+			{
+				throw Exception("ABI signature - invalid number in " + str);
+			}
+			size_t digit = static_cast<size_t>(str[i] - '0');
+			if (res > ((sk_maxSize - digit) / 10))
+			{
+				throw Exception("ABI signature - the number is too large");
+			}
+			res = (res * 10) + digit;
+		}
+		return res;
+	}
+
+	static AbiTypeNode CompileElementary(const std::string& name)
+	{
+		static const std::string sk_uintPrefix = "uint";
+		static const std::string sk_intPrefix = "int";
+		static const std::string sk_bytesPrefix = "bytes";
+
+		if (name == "address")
+		{
+			return NewNode(AbiTypeKind::Address, false);
+		}
+		else if (name == "bool")
+		{
+			return NewNode(AbiTypeKind::Bool, false);
+		}
+		else if (name == "string")
+		{
+			return NewNode(AbiTypeKind::String, true);
+		}
+		else if (name == sk_bytesPrefix)
+		{
+			return NewNode(AbiTypeKind::Bytes, true);
+		}
+		else if (name.compare(0, sk_bytesPrefix.size(), sk_bytesPrefix) == 0)
+		{
+			AbiTypeNode node = NewNode(AbiTypeKind::FixedBytes, false);
+			node.m_param = ParseNum(name, sk_bytesPrefix.size(), name.size());
+			if (node.m_param > AbiParserConst::sk_chunkSize())
+			{
+				throw Exception("ABI signature - invalid type " + name);
+			}
+			return node;
+		}
+
+		AbiTypeNode node = NewNode(AbiTypeKind::UInt, false);
+		size_t prefixSize = 0;
+		if (name.compare(0, sk_uintPrefix.size(), sk_uintPrefix) == 0)
+		{
+			prefixSize = sk_uintPrefix.size();
+		}
+		else if (name.compare(0, sk_intPrefix.size(), sk_intPrefix) == 0)
+		{
+			node.m_kind = AbiTypeKind::Int;
+			prefixSize = sk_intPrefix.size();
+		}
+		else
+		{
+			throw Exception("ABI signature - invalid type " + name);
+		}
+
+		// `uint` and `int` are aliases of `uint256` and `int256`
+		node.m_param = (name.size() == prefixSize) ?
+			256 :
+			ParseNum(name, prefixSize, name.size());
+		if ((node.m_param > 256) || ((node.m_param % 8) != 0))
+		{
+			throw Exception("ABI signature - invalid type " + name);
+		}
+		return node;
+	}
+
+	size_t CompileTuple(const std::string& sig, size_t& pos)
+	{
+		// skip the '('
+		++pos;
+
+		std::vector<size_t> fieldNodes;
+		if ((pos < sig.size()) && (sig[pos] == ')'))
+		{
+			++pos;
+		}
+		else
+		{
+			while (true)
+			{
+				fieldNodes.push_back(CompileType(sig, pos));
+				if (pos >= sig.size())
+				{
+					throw Exception("ABI signature - missing ')' in " + sig);
+				}
+				const char ch = sig[pos++];
+				if (ch == ')')
+				{
+					break;
+				}
+				else if (ch != ',')
+				{
+					throw Exception(
+						"ABI signature - unexpected character at " +
+						std::to_string(pos - 1)
+					);
+				}
+			}
+		}
+
+		// the fields are only added after all nested types are compiled,
+		// so the fields of one tuple are next to each other
+		AbiTypeNode node = NewNode(AbiTypeKind::Tuple, false);
+		node.m_fieldsBegin = m_fields.size();
+		node.m_numFields = fieldNodes.size();
+		for (size_t fieldNode : fieldNodes)
+		{
+			const AbiTypeNode& field = m_nodes[fieldNode];
+			AbiTupleField tupleField;
+			tupleField.m_nodeIdx = fieldNode;
+			tupleField.m_headOffset = node.m_blockSize;
+			m_fields.push_back(tupleField);
+
+			node.m_isDynamic = node.m_isDynamic || field.m_isDynamic;
+			node.m_blockSize += field.m_headSize;
+		}
+		if (!node.m_isDynamic)
+		{
+			node.m_headSize = node.m_blockSize;
+		}
+		return AddNode(node);
+	}
+
+	size_t CompileType(const std::string& sig, size_t& pos)
+	{
+		size_t nodeIdx = 0;
+		if ((pos < sig.size()) && (sig[pos] == '('))
+		{
+			nodeIdx = CompileTuple(sig, pos);
+		}
+		else
+		{
+			size_t nameBegin = pos;
+			while ((pos < sig.size()) &&
+				(((sig[pos] >= 'a') && (sig[pos] <= 'z')) ||
+				((sig[pos] >= '0') && (sig[pos] <= '9'))))
+			{
+				++pos;
+			}
+			nodeIdx = AddNode(
+				CompileElementary(sig.substr(nameBegin, pos - nameBegin))
+			);
+		}
+
+		// array suffixes, e.g., `T[2][]`
+		while ((pos < sig.size()) && (sig[pos] == '['))
+		{
+			size_t lenEnd = sig.find(']', pos);
+			if (lenEnd == std::string::npos)
+			{
+				throw Exception("ABI signature - missing ']' in " + sig);
+			}
+
+			const AbiTypeNode& item = m_nodes[nodeIdx];
+			if (item.m_headSize == 0)
+			{
+				throw Exception("ABI signature - the item type is empty");
+			}
+			AbiTypeNode node = NewNode(AbiTypeKind::List, true);
+			node.m_itemIdx = nodeIdx;
+			if (lenEnd != (pos + 1))
+			{
+				node.m_kind = AbiTypeKind::FixedList;
+				node.m_param = ParseNum(sig, pos + 1, lenEnd);
+				if (node.m_param >
+					(std::numeric_limits<size_t>::max() / item.m_headSize))
+				{
+					throw Exception("ABI signature - the array is too large");
+				}
+				node.m_isDynamic = item.m_isDynamic;
+				node.m_blockSize = node.m_param * item.m_headSize;
+				if (!node.m_isDynamic)
+				{
+					node.m_headSize = node.m_blockSize;
+				}
+			}
+			nodeIdx = AddNode(node);
+			pos = lenEnd + 1;
+		}
+		return nodeIdx;
+	}
+
+	std::vector<AbiTypeNode> m_nodes;
+	std::vector<AbiTupleField> m_fields;
+	size_t m_rootIdx;
+
+}; // class AbiDecodePlan
+
+
+/**
+ * @brief A view of a value decoded by a `AbiDecodePlan`; both the plan and
+ *        the payload must outlive the view
+ *
+ */
+class AbiValueView
+{
+public:
+
+	AbiValueView(
+		const AbiDecodePlan& plan,
+		const AbiTypeNode& node,
+		const uint8_t* data,
+		const uint8_t* end
+	) :
+		m_plan(&plan),
+		m_node(&node),
+		m_data(data),
+		m_end(end)
+	{}
+
+	// LCOV_EXCL_START
+	~AbiValueView() = default;
+	// LCOV_EXCL_STOP
+
+	AbiTypeKind GetKind() const
+	{
+		return m_node->m_kind;
+	}
+
+	/**
+	 * @brief Get the number of items of a tuple, `T[k]`, or `T[]`
+	 *
+	 */
+	size_t GetNumOfItems() const
+	{
+		switch (m_node->m_kind)
+		{
+		case AbiTypeKind::Tuple:
+			return m_node->m_numFields;
+		case AbiTypeKind::FixedList:
+			return m_node->m_param;
+		case AbiTypeKind::List:
+			return static_cast<size_t>(AbiDecodePlan::ReadUInt64(m_data));
+		default:
+			throw Exception("ABI parser - the value has no items");
+		}
+	}
+
+	/**
+	 * @brief Get the item at the given index of a tuple, `T[k]`, or `T[]`
+	 *
+	 */
+	AbiValueView GetItem(size_t idx) const
+	{
+		if (idx >= GetNumOfItems())
+		{
+			throw Exception("ABI parser - the index is out of range");
+		}
+
+		const AbiTypeNode* item = nullptr;
+		const uint8_t* headsBegin = m_data;
+		size_t headsSize = m_node->m_blockSize;
+		size_t headOffset = 0;
+		if (m_node->m_kind == AbiTypeKind::Tuple)
+		{
+			const AbiTupleField& field =
+				m_plan->GetField(m_node->m_fieldsBegin + idx);
+			item = &(m_plan->GetNode(field.m_nodeIdx));
+			headOffset = field.m_headOffset;
+		}
+		else
+		{
+			item = &(m_plan->GetNode(m_node->m_itemIdx));
+			headOffset = idx * item->m_headSize;
+			if (m_node->m_kind == AbiTypeKind::List)
+			{
+				headsBegin += AbiParserConst::sk_chunkSize();
+				headsSize = GetNumOfItems() * item->m_headSize;
+			}
+		}
+
+		return AbiValueView(
+			*m_plan,
+			*item,
+			m_plan->ResolveValue(
+				*item,
+				headsBegin,
+				headsSize,
+				headsBegin + headOffset,
+				m_end
+			),
+			m_end
+		);
+	}
+
+	AbiValueView operator[](size_t idx) const
+	{
+		return GetItem(idx);
+	}
+
+	/**
+	 * @brief Get the value of a `uint<M>` that fits in 64 bits
+	 *
+	 */
+	uint64_t AsUInt64() const
+	{
+		CheckKind(AbiTypeKind::UInt);
+		return AbiDecodePlan::ReadUInt64(m_data);
+	}
+
+	/**
+	 * @brief Get the value of a `int<M>` that fits in 64 bits
+	 *
+	 */
+	int64_t AsInt64() const
+	{
+		CheckKind(AbiTypeKind::Int);
+		const uint8_t sign = (m_data[24] & 0x80U) ? 0xFFU : 0x00U;
+		if (!AbiDecodePlan::IsAllBytes(m_data, m_data + 24, sign))
+		{
+			throw Exception("ABI parser - the value is too large");
+		}
+		return static_cast<int64_t>(
+			EthInternal::AbiLoadBigEndian<uint64_t>(m_data + 24)
+		);
+	}
+
+	bool AsBool() const
+	{
+		CheckKind(AbiTypeKind::Bool);
+		return m_data[AbiParserConst::sk_chunkSize() - 1] != 0;
+	}
+
+	ContractAddr AsAddress() const
+	{
+		CheckKind(AbiTypeKind::Address);
+		ContractAddr res;
+		std::copy(
+			m_data + (AbiParserConst::sk_chunkSize() - res.size()),
+			m_data + AbiParserConst::sk_chunkSize(),
+			res.begin()
+		);
+		return res;
+	}
+
+	/**
+	 * @brief Get the data of a `bytes<M>`, `bytes`, or `string`
+	 *
+	 */
+	AbiBytesView AsBytes() const
+	{
+		switch (m_node->m_kind)
+		{
+		case AbiTypeKind::FixedBytes:
+			return AbiBytesView(m_data, m_node->m_param);
+		case AbiTypeKind::Bytes:
+		case AbiTypeKind::String:
+			return AbiBytesView(
+				m_data + AbiParserConst::sk_chunkSize(),
+				static_cast<size_t>(AbiDecodePlan::ReadUInt64(m_data))
+			);
+		default:
+			throw Exception("ABI parser - the value is not bytes");
+		}
+	}
+
+	std::string AsString() const
+	{
+		CheckKind(AbiTypeKind::String);
+		return AsBytes().ToString();
+	}
+
+private:
+
+	void CheckKind(AbiTypeKind kind) const
+	{
+		if (m_node->m_kind != kind)
+		{
+			throw Exception("ABI parser - unexpected type of value");
+		}
+	}
+
+	const AbiDecodePlan* m_plan;
+	const AbiTypeNode* m_node;
+	const uint8_t* m_data;
+	const uint8_t* m_end;
+
+}; // class AbiValueView
+
+
+namespace EthInternal
+{
+
+
+/**
+ * @brief Resolve where the value of the given node starts, and charge the
+ *        offset chunk to the budget if the value is in the tail
+ *
+ */
+inline const uint8_t* AbiPlanResolve(
+	const AbiDecodePlan& plan,
+	const AbiTypeNode& node,
+	const uint8_t* headsBegin,
+	size_t headsSize,
+	const uint8_t* head,
+	const uint8_t* end,
+	size_t& budget
+)
+{
+	if (node.m_isDynamic)
+	{
+		AbiViewChargeBudget(budget, 1);
+	}
+	return plan.ResolveValue(node, headsBegin, headsSize, head, end);
+}
+
+
+/**
+ * @brief Validate the encoding of the value of the given node, which starts
+ *        at `data`
+ *
+ * @param budget The number of chunks that can still be validated; since
+ *               offsets may point to the same tail, a small payload could
+ *               otherwise take exponential time to validate, so every
+ *               resolved offset and every value that is not a block is
+ *               charged one chunk; it's initialized to the number of chunks
+ *               in the payload, which is enough for any payload without
+ *               overlapping values
+ */
+inline void AbiPlanValidate(
+	const AbiDecodePlan& plan,
+	const AbiTypeNode& node,
+	const uint8_t* data,
+	const uint8_t* end,
+	size_t& budget
+)
+{
+	static constexpr size_t sk_chunkSize = AbiParserConst::sk_chunkSize();
+
+	const bool isBlock = (node.m_kind == AbiTypeKind::Tuple ||
+		node.m_kind == AbiTypeKind::FixedList);
+	const size_t remaining = static_cast<size_t>(end - data);
+	const size_t size = isBlock ? node.m_blockSize : sk_chunkSize;
+	if (size > remaining)
+	{
+		throw Exception("ABI parser - unexpected end of input");
+	}
+
+	// blocks are charged by their members
+	if (!isBlock)
+	{
+		AbiViewChargeBudget(budget, 1);
+	}
+
+	switch (node.m_kind)
+	{
+	case AbiTypeKind::UInt:
+	case AbiTypeKind::Address:
+	{
+		const size_t valSize = (node.m_kind == AbiTypeKind::UInt) ?
+			(node.m_param / 8) :
+			std::tuple_size<ContractAddr>::value;
+		if (!AbiIsZeroBytes(data, sk_chunkSize - valSize))
+		{
+			throw Exception(
+				"ABI parser - there are non-zero bytes in skipped bytes"
+			);
+		}
+		break;
+	}
+	case AbiTypeKind::Int:
+	{
+		const size_t padSize = sk_chunkSize - (node.m_param / 8);
+		const uint8_t sign = (data[padSize] & 0x80U) ? 0xFFU : 0x00U;
+		if (!AbiDecodePlan::IsAllBytes(data, data + padSize, sign))
+		{
+			throw Exception("ABI parser - invalid sign extension");
+		}
+		break;
+	}
+	case AbiTypeKind::Bool:
+		if (!AbiIsZeroBytes(data, sk_chunkSize - 1) ||
+			(data[sk_chunkSize - 1] > 1))
+		{
+			throw Exception("ABI parser - invalid bool value");
+		}
+		break;
+	case AbiTypeKind::FixedBytes:
+		if (!AbiIsZeroBytes(data + node.m_param, sk_chunkSize - node.m_param))
+		{
+			throw Exception(
+				"ABI parser - there are non-zero bytes in skipped bytes"
+			);
+		}
+		break;
+	case AbiTypeKind::Bytes:
+	case AbiTypeKind::String:
+	{
+		const uint64_t len = AbiDecodePlan::ReadUInt64(data);
+		const size_t dataRemaining = remaining - sk_chunkSize;
+		if (len > dataRemaining)
+		{
+			throw Exception("ABI parser - unexpected end of input");
+		}
+		const size_t paddedSize = AbiCeilingDiv(
+			static_cast<size_t>(len),
+			sk_chunkSize
+		) * sk_chunkSize;
+		AbiParserSkipPadding<true>(
+			paddedSize - static_cast<size_t>(len),
+			data + sk_chunkSize + static_cast<size_t>(len),
+			end
+		);
+		break;
+	}
+	case AbiTypeKind::FixedList:
+	case AbiTypeKind::List:
+	{
+		const AbiTypeNode& item = plan.GetNode(node.m_itemIdx);
+		const uint8_t* headsBegin = data;
+		size_t len = node.m_param;
+		if (node.m_kind == AbiTypeKind::List)
+		{
+			headsBegin += sk_chunkSize;
+			const uint64_t maxLen =
+				(remaining - sk_chunkSize) / item.m_headSize;
+			const uint64_t len64 = AbiDecodePlan::ReadUInt64(data);
+			if (len64 > maxLen)
+			{
+				throw Exception("ABI parser - unexpected end of input");
+			}
+			len = static_cast<size_t>(len64);
+		}
+		const size_t headsSize = len * item.m_headSize;
+		for (size_t i = 0; i < len; ++i)
+		{
+			AbiPlanValidate(
+				plan,
+				item,
+				AbiPlanResolve(
+					plan,
+					item,
+					headsBegin,
+					headsSize,
+					headsBegin + (i * item.m_headSize),
+					end,
+					budget
+				),
+				end,
+				budget
+			);
+		}
+		break;
+	}
+	case AbiTypeKind::Tuple:
+		for (size_t i = 0; i < node.m_numFields; ++i)
+		{
+			const AbiTupleField& field =
+				plan.GetField(node.m_fieldsBegin + i);
+			const AbiTypeNode& fieldNode = plan.GetNode(field.m_nodeIdx);
+			AbiPlanValidate(
+				plan,
+				fieldNode,
+				AbiPlanResolve(
+					plan,
+					fieldNode,
+					data,
+					node.m_blockSize,
+					data + field.m_headOffset,
+					end,
+					budget
+				),
+				end,
+				budget
+			);
+		}
+		break;
+	}
+}
+
+
+} // namespace EthInternal
+
+
+inline AbiValueView AbiDecodePlan::Decode(
+	const uint8_t* data,
+	size_t size
+) const
+{
+	const AbiTypeNode& root = GetRoot();
+	const uint8_t* end = data + size;
+	size_t budget = size / AbiParserConst::sk_chunkSize();
+	EthInternal::AbiPlanValidate(*this, root, data, end, budget);
+	return AbiValueView(*this, root, data, end);
+}
+
+
+/**
+ * @brief A cache of decode plans, so each ABI type string is only compiled
+ *        once, no matter how many subscriptions use it
+ *
+ */
+class AbiDecodePlanCache
+{
+public:
+
+	using PlanPtr = std::shared_ptr<const AbiDecodePlan>;
+
+public:
+
+	AbiDecodePlanCache() :
+		m_mutex(),
+		m_plans()
+	{}
+
+	// LCOV_EXCL_START
+	~AbiDecodePlanCache() = default;
+	// LCOV_EXCL_STOP
+
+	/**
+	 * @brief Get the plan of the given ABI type string, which is compiled
+	 *        if it is not in the cache yet
+	 *
+	 */
+	PlanPtr Get(const std::string& signature)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		auto it = m_plans.find(signature);
+		if (it != m_plans.end())
+		{
+			return it->second;
+		}
+
+		PlanPtr plan = std::make_shared<const AbiDecodePlan>(
+			AbiDecodePlan::Compile(signature)
+		);
+		m_plans.emplace(signature, plan);
+		return plan;
+	}
+
+	size_t GetNumOfPlans() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_plans.size();
+	}
+
+private:
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<std::string, PlanPtr> m_plans;
+
+}; // class AbiDecodePlanCache
+
+
+} // namespace Eth
+} // namespace EclipseMonitor
@@ -0,0 +1,683 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "../Exceptions.hpp"
+#include "../Internal/SimpleObj.hpp"
+#include "AbiParser.hpp"
+
+
+namespace EclipseMonitor
+{
+namespace Eth
+{
+
+
+// ==========
+// View types
+// ==========
+
+
+/**
+ * @brief A view of the data of a `bytes` or `string` value inside an
+ *        ABI-encoded buffer; the buffer must outlive the view
+ *
+ */
+class AbiBytesView
+{
+public:
+
+	AbiBytesView() :
+		m_data(nullptr),
+		m_size(0)
+	{}
+
+	AbiBytesView(const uint8_t* data, size_t size) :
+		m_data(data),
+		m_size(size)
+	{}
+
+	// LCOV_EXCL_START
+	~AbiBytesView() = default;
+	// LCOV_EXCL_STOP
+
+	const uint8_t* data() const
+	{
+		return m_data;
+	}
+
+	size_t size() const
+	{
+		return m_size;
+	}
+
+	bool empty() const
+	{
+		return m_size == 0;
+	}
+
+	const uint8_t* begin() const
+	{
+		return m_data;
+	}
+
+	const uint8_t* end() const
+	{
+		return m_data + m_size;
+	}
+
+	std::vector<uint8_t> ToBytes() const
+	{
+		return std::vector<uint8_t>(begin(), end());
+	}
+
+	std::string ToString() const
+	{
+		return std::string(begin(), end());
+	}
+
+private:
+
+	const uint8_t* m_data;
+	size_t m_size;
+
+}; // class AbiBytesView
+
+
+namespace EthInternal
+{
+
+
+/**
+ * @brief Charge the given number of chunks to the validation budget.
+ *        A list view validates the tails of all its dynamic items when it's
+ *        created, so, without a budget, tails that many offsets point to
+ *        would be validated over and over again; the budget starts with the
+ *        number of chunks in the input, which is enough for any input
+ *        without overlapping tails
+ *
+ */
+inline void AbiViewChargeBudget(size_t& budget, size_t numOfChunks)
+{
+	if (numOfChunks > budget)
+	{
+		throw Exception("ABI parser - too many overlapping values");
+	}
+	budget -= numOfChunks;
+}
+
+
+inline size_t AbiViewInitBudget(const uint8_t* begin, const uint8_t* end)
+{
+	return static_cast<size_t>(end - begin) / AbiParserConst::sk_chunkSize();
+}
+
+
+/**
+ * @brief Parse a tail with a parser that shares the validation budget
+ *        (i.e., a list view parser)
+ *
+ */
+template<typename _Parser>
+inline auto AbiTailToPrimitiveInBudget(
+	const _Parser& parser,
+	const uint8_t* begin,
+	const uint8_t* end,
+	size_t& budget,
+	int /* preferred overload */
+) -> decltype(parser.TailToPrimitive(begin, end, budget))
+{
+	return parser.TailToPrimitive(begin, end, budget);
+}
+
+
+/**
+ * @brief Parse a tail with any other parser, which is charged for the
+ *        chunks it consumed
+ *
+ */
+template<typename _Parser>
+inline auto AbiTailToPrimitiveInBudget(
+	const _Parser& parser,
+	const uint8_t* begin,
+	const uint8_t* end,
+	size_t& budget,
+	long /* fallback overload */
+) -> decltype(parser.TailToPrimitive(begin, end))
+{
+	auto res = parser.TailToPrimitive(begin, end);
+	AbiViewChargeBudget(budget, std::get<2>(res));
+	return res;
+}
+
+
+/**
+ * @brief Parse the item at the given index of a list whose heads start at
+ *        `headsBegin`, where the offsets of dynamic items are relative to
+ *        `headsBegin`
+ *
+ * @return the parsed item, and where the parsing of the item stopped
+ */
+template<typename _ItemParser>
+inline std::tuple<typename _ItemParser::Primitive, const uint8_t*>
+AbiListItemToPrimitive(
+	const _ItemParser& itemParser,
+	const uint8_t* headsBegin,
+	const uint8_t* end,
+	size_t size,
+	size_t idx,
+	size_t& budget,
+	std::false_type /* HasTail? - false */
+)
+{
+	const size_t headSize =
+		itemParser.GetNumOfHeadChunks() * AbiParserConst::sk_chunkSize();
+	auto res = itemParser.HeadToPrimitive(
+		headsBegin + (idx * headSize),
+		headsBegin + (size * headSize)
+	);
+	(void)end;
+	(void)budget;
+	return std::make_tuple(std::get<0>(res), std::get<1>(res));
+}
+
+
+template<typename _ItemParser>
+inline std::tuple<typename _ItemParser::Primitive, const uint8_t*>
+AbiListItemToPrimitive(
+	const _ItemParser& itemParser,
+	const uint8_t* headsBegin,
+	const uint8_t* end,
+	size_t size,
+	size_t idx,
+	size_t& budget,
+	std::true_type /* HasTail? - true */
+)
+{
+	static constexpr size_t sk_chunkSize = AbiParserConst::sk_chunkSize();
+
+	uint64_t offset = 0;
+	std::tie(offset, std::ignore, std::ignore) = itemParser.HeadToPrimitive(
+		headsBegin + (idx * sk_chunkSize),
+		end
+	);
+
+	// the tail must be after all heads, and be aligned to chunks
+	const size_t totalSize = static_cast<size_t>(end - headsBegin);
+	if ((offset < (size * sk_chunkSize)) ||
+		(offset > totalSize) ||
+		((offset % sk_chunkSize) != 0))
+	{
+		throw Exception("ABI parser - invalid offset");
+	}
+
+	AbiViewChargeBudget(budget, 1);
+	auto res = AbiTailToPrimitiveInBudget(
+		itemParser,
+		headsBegin + static_cast<size_t>(offset),
+		end,
+		budget,
+		0
+	);
+	return std::make_tuple(std::get<0>(res), std::get<1>(res));
+}
+
+
+} // namespace EthInternal
+
+
+/**
+ * @brief A view of a `T[]` value inside an ABI-encoded buffer, whose items
+ *        are only parsed when they are accessed; the buffer must outlive
+ *        the view.
+ *        The number of items, and the offsets and tails of dynamic items
+ *        are checked when the view is created, within a budget of the
+ *        number of chunks in the input (see `AbiViewChargeBudget`); thus,
+ *        the item parser should be a `AbiViewParser` as well, if the items
+ *        shouldn't be copied.
+ *
+ * @tparam _ItemParser The parser of the items, which can be either a
+ *                     `AbiParser` or a `AbiViewParser`
+ */
+template<typename _ItemParser>
+class AbiListView
+{
+public: // static members:
+
+	using ItemParser = _ItemParser;
+	using ItemPrimitive = typename ItemParser::Primitive;
+
+public:
+
+	AbiListView() :
+		m_itemParser(),
+		m_headsBegin(nullptr),
+		m_end(nullptr),
+		m_size(0)
+	{}
+
+	AbiListView(
+		ItemParser itemParser,
+		const uint8_t* headsBegin,
+		const uint8_t* end,
+		size_t size
+	) :
+		m_itemParser(std::move(itemParser)),
+		m_headsBegin(headsBegin),
+		m_end(end),
+		m_size(size)
+	{}
+
+	// LCOV_EXCL_START
+	~AbiListView() = default;
+	// LCOV_EXCL_STOP
+
+	size_t size() const
+	{
+		return m_size;
+	}
+
+	bool empty() const
+	{
+		return m_size == 0;
+	}
+
+	/**
+	 * @brief Parse the item at the given index
+	 *
+	 */
+	ItemPrimitive Get(size_t idx) const
+	{
+		if (idx >= m_size)
+		{
+			throw Exception("ABI parser - the index is out of range");
+		}
+		size_t budget = EthInternal::AbiViewInitBudget(m_headsBegin, m_end);
+		return std::get<0>(
+			EthInternal::AbiListItemToPrimitive(
+				m_itemParser,
+				m_headsBegin,
+				m_end,
+				m_size,
+				idx,
+				budget,
+				std::integral_constant<bool, ItemParser::sk_hasTail>()
+			)
+		);
+	}
+
+	ItemPrimitive operator[](size_t idx) const
+	{
+		return Get(idx);
+	}
+
+	/**
+	 * @brief Parse all items into a vector
+	 *
+	 */
+	std::vector<ItemPrimitive> ToVector() const
+	{
+		std::vector<ItemPrimitive> res;
+		res.reserve(m_size);
+		for (size_t i = 0; i < m_size; ++i)
+		{
+			res.push_back(Get(i));
+		}
+		return res;
+	}
+
+private:
+
+	ItemParser m_itemParser;
+	const uint8_t* m_headsBegin;
+	const uint8_t* m_end;
+	size_t m_size;
+
+}; // class AbiListView
+
+
+// ==========
+// Essential view parser implementations
+// ==========
+
+
+namespace EthInternal
+{
+
+
+template<
+	Internal::Obj::ObjCategory _DataType,
+	typename... _Args
+>
+struct AbiViewCodecImpl;
+
+
+// ==========
+// AbiViewCodecImpl for bytes and string types
+// ==========
+
+
+template<>
+struct AbiViewCodecImpl<
+	Internal::Obj::ObjCategory::Bytes
+>
+{
+	using Primitive = AbiBytesView;
+	using DynLenParser = AbiCodecImpl<
+		Internal::Obj::ObjCategory::Integer,
+		std::integral_constant<
+			Internal::Obj::RealNumType,
+			Internal::Obj::RealNumType::UInt64
+		>
+	>;
+
+	AbiViewCodecImpl() = default;
+	~AbiViewCodecImpl() = default;
+
+
+	std::tuple<
+		Primitive,      /* Parsed value */
+		const uint8_t*, /* Pointer to where the parsing stopped */
+		size_t          /* Number of chunks consumed */
+	>
+	ToPrimitive(const uint8_t* begin, const uint8_t* end) const
+	{
+		// first, parse the length of the bytes
+		uint64_t len = 0;
+		size_t chunkConsumed = 0;
+		std::tie(len, begin, chunkConsumed) =
+			DynLenParser().ToPrimitive(begin, end);
+
+		if (len > static_cast<uint64_t>(end - begin))
+		{
+			throw Exception("ABI parser - unexpected end of input");
+		}
+		size_t size = static_cast<size_t>(len);
+		size_t numChunk = EthInternal::AbiCeilingDiv(
+			size,
+			AbiParserConst::sk_chunkSize()
+		);
+		size_t paddingSize =
+			(numChunk * AbiParserConst::sk_chunkSize()) - size;
+
+		// the data stays in the input; only the padding is checked
+		Primitive res(begin, size);
+		begin = EthInternal::AbiParserSkipPadding<true>(
+			paddingSize,
+			begin + size,
+			end
+		);
+
+		return std::make_tuple(res, begin, chunkConsumed + numChunk);
+	}
+
+}; // struct AbiViewCodecImpl<Internal::Obj::ObjCategory::Bytes>
+
+
+// ==========
+// AbiViewCodecImpl for T[] types
+// ==========
+
+
+template<typename _ItemParser>
+struct AbiViewCodecImpl<
+	Internal::Obj::ObjCategory::List,
+	_ItemParser
+>
+{
+	using ItemParser = _ItemParser;
+	using Primitive = AbiListView<ItemParser>;
+	using DynLenParser = AbiCodecImpl<
+		Internal::Obj::ObjCategory::Integer,
+		std::integral_constant<
+			Internal::Obj::RealNumType,
+			Internal::Obj::RealNumType::UInt64
+		>
+	>;
+
+	AbiViewCodecImpl(ItemParser itemParser) :
+		m_itemParser(std::move(itemParser))
+	{}
+	~AbiViewCodecImpl() = default;
+
+
+	std::tuple<
+		Primitive,      /* Parsed value */
+		const uint8_t*, /* Pointer to where the parsing stopped */
+		size_t          /* Number of chunks consumed */
+	>
+	ToPrimitive(const uint8_t* begin, const uint8_t* end) const
+	{
+		size_t budget = AbiViewInitBudget(begin, end);
+		return ToPrimitive(begin, end, budget);
+	}
+
+
+	/**
+	 * @brief Parse the list, validating the tails of dynamic items within
+	 *        the given budget, which is shared with the enclosing views
+	 *
+	 */
+	std::tuple<
+		Primitive,      /* Parsed value */
+		const uint8_t*, /* Pointer to where the parsing stopped */
+		size_t          /* Number of chunks consumed */
+	>
+	ToPrimitive(const uint8_t* begin, const uint8_t* end, size_t& budget) const
+	{
+		using _HasTail = std::integral_constant<bool, ItemParser::sk_hasTail>;
+
+		AbiViewChargeBudget(budget, 1);
+
+		// first, parse the length of the list
+		uint64_t len = 0;
+		size_t chunkConsumed = 0;
+		std::tie(len, begin, chunkConsumed) =
+			DynLenParser().ToPrimitive(begin, end);
+
+		// make sure all heads are in the input
+		const size_t headSize =
+			m_itemParser.GetNumOfHeadChunks() * AbiParserConst::sk_chunkSize();
+		const uint64_t maxLen = (headSize == 0) ?
+			0 :
+			static_cast<uint64_t>(end - begin) / headSize;
+		if (len > maxLen)
+		{
+			throw Exception("ABI parser - unexpected end of input");
+		}
+		size_t size = static_cast<size_t>(len);
+
+		// static items end with the heads; dynamic items end with the
+		// furthest tail, since tails are not necessarily in the same order
+		// as the heads; every dynamic item is parsed here, so a bad offset
+		// or tail is rejected before the view is handed out
+		const uint8_t* listEnd = begin + (size * headSize);
+		for (size_t i = 0; _HasTail::value && (i < size); ++i)
+		{
+			const uint8_t* itemEnd = std::get<1>(
+				EthInternal::AbiListItemToPrimitive(
+					m_itemParser,
+					begin,
+					end,
+					size,
+					i,
+					budget,
+					_HasTail()
+				)
+			);
+			listEnd = std::max(listEnd, itemEnd);
+		}
+		chunkConsumed +=
+			static_cast<size_t>(listEnd - begin) /
+				AbiParserConst::sk_chunkSize();
+
+		return std::make_tuple(
+			Primitive(m_itemParser, begin, end, size),
+			listEnd,
+			chunkConsumed
+		);
+	}
+
+private:
+
+	ItemParser m_itemParser;
+
+}; // struct AbiViewCodecImpl<Internal::Obj::ObjCategory::List, _Item>
+
+
+} // namespace EthInternal
+
+
+// ==========
+// AbiViewParser general template
+// ==========
+
+
+/**
+ * @brief The parsers that decode values into views of the input, instead of
+ *        copying them into containers like `AbiParser` does. They have the
+ *        same interface as `AbiParser`, except that they only accept
+ *        contiguous input given as `const uint8_t*` pointers.
+ *
+ */
+template<
+	Internal::Obj::ObjCategory _DataType,
+	typename... _Args
+>
+struct AbiViewParser;
+
+
+// ==========
+// AbiViewParser for bytes types
+// ==========
+
+
+template<>
+struct AbiViewParser<
+	Internal::Obj::ObjCategory::Bytes,
+	std::true_type /* IsDynamic? - true */
+> :
+	EthInternal::AbiParserHeadTailTypes<
+		EthInternal::AbiViewCodecImpl<
+			Internal::Obj::ObjCategory::Bytes
+		>
+	>
+{
+	using Base = EthInternal::AbiParserHeadTailTypes<
+		EthInternal::AbiViewCodecImpl<
+			Internal::Obj::ObjCategory::Bytes
+		>
+	>;
+	using Codec = typename Base::Codec;
+
+
+	AbiViewParser() :
+		Base(Codec())
+	{}
+	// LCOV_EXCL_START
+	virtual ~AbiViewParser() = default;
+	// LCOV_EXCL_STOP
+}; // struct AbiViewParser<Internal::Obj::ObjCategory::Bytes, true>
+
+
+// ==========
+// AbiViewParser for string type
+// ==========
+
+
+template<>
+struct AbiViewParser<
+	Internal::Obj::ObjCategory::String
+> :
+	AbiViewParser<
+		Internal::Obj::ObjCategory::Bytes,
+		std::true_type
+	>
+{
+	using Base = AbiViewParser<
+		Internal::Obj::ObjCategory::Bytes,
+		std::true_type
+	>;
+
+
+	AbiViewParser() :
+		Base()
+	{}
+	// LCOV_EXCL_START
+	virtual ~AbiViewParser() = default;
+	// LCOV_EXCL_STOP
+}; // struct AbiViewParser<Internal::Obj::ObjCategory::String>
+
+
+// ==========
+// AbiViewParser for list types (T[])
+// ==========
+
+
+template<typename _ItemParser>
+struct AbiViewParser<
+	Internal::Obj::ObjCategory::List,
+	_ItemParser,
+	std::true_type /* IsLenDynamic? - true */
+> :
+	EthInternal::AbiParserHeadTailTypes<
+		EthInternal::AbiViewCodecImpl<
+			Internal::Obj::ObjCategory::List,
+			_ItemParser
+		>
+	>
+{
+	using Base = EthInternal::AbiParserHeadTailTypes<
+		EthInternal::AbiViewCodecImpl<
+			Internal::Obj::ObjCategory::List,
+			_ItemParser
+		>
+	>;
+	using Codec = typename Base::Codec;
+
+
+	explicit AbiViewParser(_ItemParser itemParser) :
+		Base(Codec(std::move(itemParser)))
+	{}
+	// LCOV_EXCL_START
+	virtual ~AbiViewParser() = default;
+	// LCOV_EXCL_STOP
+
+	using Base::TailToPrimitive;
+
+	/**
+	 * @brief Parse the tail within the validation budget of the enclosing
+	 *        view
+	 *
+	 */
+	std::tuple<
+		typename Codec::Primitive, /* Parsed value */
+		const uint8_t*,            /* Pointer to where the parsing stopped */
+		size_t                     /* Number of chunks consumed */
+	>
+	TailToPrimitive(
+		const uint8_t* begin,
+		const uint8_t* end,
+		size_t& budget
+	) const
+	{
+		return this->m_tailCodec.ToPrimitive(begin, end, budget);
+	}
+}; // struct AbiViewParser<Internal::Obj::ObjCategory::List, _Item, true>
+
+
+} // namespace Eth
+} // namespace EclipseMonitor
@@ -8,8 +8,11 @@
 #include <functional>
 #include <vector>
 #include <memory>
+#include <utility>
 
 #include "../Exceptions.hpp"
+#include "../Internal/SimpleObj.hpp"
+#include "../Internal/SortedWindow.hpp"
 #include "../MonitorReport.hpp"
 
 #include "HeaderNode.hpp"
@@ -22,11 +25,26 @@ namespace Eth
 {
 
 
+/**
+ * @brief Keeps track of the current checkpoint window, the candidate window
+ *        that will become the next checkpoint, and (during the runtime phase)
+ *        the last checkpoint node with all its descendants.
+ *        Both windows live in one ring of `2 * checkpointSize` slots that is
+ *        allocated once; the candidate window always follows the current
+ *        window in the ring, so completing a checkpoint only moves the
+ *        boundary between them.
+ *        The difficulty values of both windows, and of the last
+ *        `checkpointSize` headers added, are kept sorted as headers are
+ *        added, so the median (or any other percentile) is always available
+ *        without sorting or allocating.
+ *
+ */
 class CheckpointMgr
 {
 public: // Static members
 
 	using OnCompleteCallback = std::function<void()>;
+	using DiffWindow = Internal::SortedWindow<Difficulty>;
 
 public:
 	CheckpointMgr(
@@ -34,9 +52,15 @@ public:
 		OnCompleteCallback onComplete) :
 		m_chkptSize(static_cast<size_t>(mConf.get_checkpointSize().GetVal())),
 		m_onComplete(onComplete),
-		m_currWindow(),
-		m_candidate(),
-		m_lastNode()
+		m_ring(2 * (m_chkptSize > 0 ? m_chkptSize : 1)),
+		m_currBegin(0),
+		m_currSize(0),
+		m_candSize(0),
+		m_lastNode(),
+		m_isLastNodeCandidate(false),
+		m_currDiffs(m_chkptSize),
+		m_candDiffs(m_chkptSize),
+		m_recentDiffs(m_chkptSize)
 	{}
 
 	// LCOV_EXCL_START
@@ -45,7 +69,7 @@ public:
 
 	size_t GetNumOfCandidates() const
 	{
-		return m_candidate.size() +
+		return m_candSize +
 			(((m_lastNode != nullptr) && m_isLastNodeCandidate) ? 1 : 0);
 	}
 
@@ -73,14 +97,13 @@ public:
 			// 1. if there is last node, move it to candidate
 			if (m_lastNode != nullptr)
 			{
-				m_candidate.emplace_back(m_lastNode->ReleaseHeader());
+				PushCandidate(m_lastNode->ReleaseHeader());
 			}
-			// 2. clean current window
-			m_currWindow.clear();
-			// 3. move candidate to current window
-			m_currWindow.swap(m_candidate);
+			// 2. & 3. the candidate window becomes the current window
+			RollOver();
 			// 4. finally add the new node to the last node
 			m_lastNode = std::move(node);
+			AddLastNodeDiff(m_currDiffs);
 			// 5. and mark it as non-candidate
 			m_isLastNodeCandidate = false;
 			// 6. call the callback
@@ -94,15 +117,18 @@ public:
 			{
 				if (m_isLastNodeCandidate)
 				{
-					m_candidate.emplace_back(m_lastNode->ReleaseHeader());
+					PushCandidate(m_lastNode->ReleaseHeader());
 				}
 				else
 				{
-					m_currWindow.emplace_back(m_lastNode->ReleaseHeader());
+					// the candidate window is always empty right after the
+					// roll over, so the current window can still grow
+					PushCurrWindow(m_lastNode->ReleaseHeader());
 				}
 			}
 			// 2. finally add the new node to the last node
 			m_lastNode = std::move(node);
+			AddLastNodeDiff(m_candDiffs);
 			// 3. and mark it as candidate
 			m_isLastNodeCandidate = true;
 		}
@@ -131,17 +157,17 @@ public:
 		}
 
 		// 1. add the new header to the candidate window
-		m_candidate.emplace_back(std::move(header));
+		m_candDiffs.Push(header->GetDiff());
+		m_recentDiffs.Push(header->GetDiff());
+		PushCandidate(std::move(header));
 
 		// 2. Check if the candidate window is completed
 		// after adding this header
 		if (GetNumOfCandidates() >= m_chkptSize)
 		{
 			// The candidate window is completed
-			// 2.1. clean current window
-			m_currWindow.clear();
-			// 2.2. move candidate to current window
-			m_currWindow.swap(m_candidate);
+			// 2.1. & 2.2. the candidate window becomes the current window
+			RollOver();
 			// 2.6. call the callback
 			m_onComplete();
 		}
@@ -159,21 +185,45 @@ public:
 	 */
 	Difficulty GetDiffMedian() const
 	{
-		std::vector<Difficulty> diffs;
-		IterateCurrWindow(
-			[&diffs](const HeaderMgr& header) {
-				diffs.push_back(header.GetDiff());
-			}
-		);
+		// the value at the position of (size * 50 / 100), i.e., (size // 2)
+		return GetDiffPercentile(50);
+	}
+
+	/**
+	 * @brief Get the difficulty value at the given percentile for blocks
+	 *        within the current window; see `Internal::SortedWindow` for how
+	 *        the position is chosen
+	 *
+	 * @param percent The percentile, within [0, 100]
+	 */
+	Difficulty GetDiffPercentile(size_t percent) const
+	{
+		if (m_currDiffs.IsEmpty())
+		{
+			throw Exception("There is no header in the checkpoint");
+		}
+		return m_currDiffs.GetPercentile(percent);
+	}
 
-		// reference: https://en.cppreference.com/w/cpp/algorithm/nth_element
-		// When the size of the checkpoint is a even number, to get the
-		// statistical median value, we need to take the average of
-		// the two middle elements.
-		auto mit = diffs.begin() + (diffs.size() / 2);
-		std::nth_element(diffs.begin(), mit, diffs.end());
+	/**
+	 * @brief Get the difficulty values of the current window, sorted in
+	 *        ascending order
+	 *
+	 */
+	const DiffWindow& GetCurrWindowDiffs() const
+	{
+		return m_currDiffs;
+	}
 
-		return *mit;
+	/**
+	 * @brief Get the difficulty values of the last `checkpointSize` headers
+	 *        added, regardless of the window boundaries, sorted in ascending
+	 *        order; this is a sliding window that moves on every header
+	 *
+	 */
+	const DiffWindow& GetRecentDiffs() const
+	{
+		return m_recentDiffs;
 	}
 
 	void EndBootstrapPhase(std::shared_ptr<SyncState> syncState)
@@ -182,17 +232,21 @@ public:
 		{
 			throw Exception("Checkpoint manager is already in runtime phase");
 		}
-		if (m_candidate.size() != 0)
+		if (m_candSize != 0)
 		{
 			throw Exception("There are still headers in candidate window");
 		}
+		if (m_currSize == 0)
+		{
+			throw Exception("There is no header in the checkpoint");
+		}
 
 		m_lastNode = Internal::Obj::Internal::make_unique<HeaderNode>(
-			std::move(m_currWindow.back()),
+			std::move(GetSlot(m_currSize - 1).m_header),
 			std::move(syncState)
 		);
 		m_isLastNodeCandidate = false;
-		m_currWindow.pop_back();
+		--m_currSize;
 	}
 
 	HeaderNode* GetLastNodePtr() const
@@ -215,13 +269,13 @@ public:
 		{
 			return m_lastNode->GetHeader();
 		}
-		else if (!m_candidate.empty())
+		else if (m_candSize != 0)
 		{
-			return *m_candidate.back();
+			return *GetSlot(m_currSize + m_candSize - 1).m_header;
 		}
-		else if (!m_currWindow.empty())
+		else if (m_currSize != 0)
 		{
-			return *m_currWindow.back();
+			return *GetSlot(m_currSize - 1).m_header;
 		}
 		else
 		{
@@ -232,8 +286,8 @@ public:
 	bool IsEmpty() const
 	{
 		return (m_lastNode == nullptr) &&
-			m_candidate.empty() &&
-			m_currWindow.empty();
+			(m_candSize == 0) &&
+			(m_currSize == 0);
 	}
 
 	/**
@@ -245,12 +299,12 @@ public:
 	 */
 	std::pair<BlockNumber, BlockNumber> GetCheckpointBlkNumRange() const
 	{
-		if (m_currWindow.empty())
+		if (m_currSize == 0)
 		{
 			throw Exception("There is no header in the checkpoint");
 		}
 
-		auto begin = m_currWindow.front()->GetNumber();
+		auto begin = GetSlot(0).m_blkNum;
 		return std::make_pair(
 			begin,
 			begin + m_chkptSize - 1
@@ -260,9 +314,9 @@ public:
 	template<typename _CallBackFuncType>
 	void IterateCurrWindow(_CallBackFuncType callback) const
 	{
-		for (const auto& header : m_currWindow)
+		for (size_t i = 0; i < m_currSize; ++i)
 		{
-			callback(*header);
+			callback(*(GetSlot(i).m_header));
 		}
 		if ((m_lastNode != nullptr) && !m_isLastNodeCandidate)
 		{
@@ -270,13 +324,276 @@ public:
 		}
 	}
 
+	/**
+	 * @brief Encode the state of this checkpoint manager into a list, which
+	 *        is used in the snapshot of the monitor state.
+	 *        The last node and all its descendants are encoded in pre-order,
+	 *        each with the index of its parent node in the list.
+	 *
+	 */
+	Internal::Obj::List ToSnapshot() const
+	{
+		Internal::Obj::List currWindow;
+		currWindow.reserve(m_currSize);
+		for (size_t i = 0; i < m_currSize; ++i)
+		{
+			currWindow.push_back(GetSlot(i).m_header->ToSnapshot());
+		}
+
+		Internal::Obj::List candidate;
+		candidate.reserve(m_candSize);
+		for (size_t i = 0; i < m_candSize; ++i)
+		{
+			candidate.push_back(
+				GetSlot(m_currSize + i).m_header->ToSnapshot()
+			);
+		}
+
+		Internal::Obj::List nodes;
+		if (m_lastNode != nullptr)
+		{
+			std::vector<std::pair<const HeaderNode*, uint64_t> > stack;
+			stack.emplace_back(m_lastNode.get(), 0);
+			while (!stack.empty())
+			{
+				const HeaderNode* node = stack.back().first;
+				uint64_t parentIdx = stack.back().second;
+				stack.pop_back();
+
+				uint64_t nodeIdx = static_cast<uint64_t>(nodes.size());
+				Internal::Obj::List nodeSnapshot;
+				nodeSnapshot.push_back(node->GetHeader().ToSnapshot());
+				nodeSnapshot.push_back(
+					PrimitiveTypeTrait<uint64_t>::ToBytes(parentIdx)
+				);
+				nodes.push_back(nodeSnapshot);
+
+				// children are pushed in reverse order, so they are encoded
+				// (and later restored) in their original order
+				for (size_t i = node->GetNumOfChildren(); i > 0; --i)
+				{
+					stack.emplace_back(node->GetChild(i - 1), nodeIdx);
+				}
+			}
+		}
+
+		Internal::Obj::List snapshot;
+		snapshot.push_back(currWindow);
+		snapshot.push_back(candidate);
+		snapshot.push_back(nodes);
+		snapshot.push_back(
+			PrimitiveTypeTrait<uint8_t>::ToBytes(static_cast<uint8_t>(
+				((m_lastNode != nullptr) && m_isLastNodeCandidate) ? 1 : 0
+			))
+		);
+		return snapshot;
+	}
+
+	/**
+	 * @brief Restore the state from the list generated by `ToSnapshot`.
+	 *        The completion callback is not called, since the checkpoint
+	 *        was completed before the snapshot was taken.
+	 *
+	 * @param snapshot  The list generated by `ToSnapshot`
+	 * @param syncState The sync state given to all restored nodes
+	 */
+	void RestoreFromSnapshot(
+		const Internal::Obj::ListBaseObj& snapshot,
+		std::shared_ptr<SyncState> syncState
+	)
+	{
+		if (!IsEmpty())
+		{
+			throw Exception("Checkpoint manager is not empty");
+		}
+		if (snapshot.size() != 4)
+		{
+			throw Exception("Invalid checkpoint snapshot");
+		}
+
+		const auto& currWindow = snapshot[0].AsList();
+		const auto& candidate = snapshot[1].AsList();
+		if ((currWindow.size() > m_chkptSize) ||
+			(candidate.size() >= m_chkptSize) ||
+			(currWindow.size() + candidate.size() > m_ring.size()))
+		{
+			throw Exception("Invalid checkpoint snapshot");
+		}
+		for (const auto& header : currWindow)
+		{
+			PushCurrWindow(HeaderMgr::FromSnapshot(header.AsList()));
+		}
+		for (const auto& header : candidate)
+		{
+			PushCandidate(HeaderMgr::FromSnapshot(header.AsList()));
+		}
+		for (size_t i = 0; i < m_currSize + m_candSize; ++i)
+		{
+			const Difficulty diff = GetSlot(i).m_header->GetDiff();
+			(i < m_currSize ? m_currDiffs : m_candDiffs).Push(diff);
+			m_recentDiffs.Push(diff);
+		}
+
+		const auto& nodes = snapshot[2].AsList();
+		std::vector<HeaderNode*> nodePtrs;
+		nodePtrs.reserve(nodes.size());
+		for (const auto& nodeObj : nodes)
+		{
+			const auto& nodeSnapshot = nodeObj.AsList();
+			if (nodeSnapshot.size() != 2)
+			{
+				throw Exception("Invalid checkpoint snapshot");
+			}
+			auto header = HeaderMgr::FromSnapshot(nodeSnapshot[0].AsList());
+
+			if (nodePtrs.empty())
+			{
+				m_lastNode = Internal::Obj::Internal::make_unique<HeaderNode>(
+					std::move(header),
+					syncState
+				);
+				nodePtrs.push_back(m_lastNode.get());
+				continue;
+			}
+
+			uint64_t parentIdx = PrimitiveTypeTrait<uint64_t>::FromBytes(
+				nodeSnapshot[1].AsBytes()
+			);
+			// parents always come before their children
+			if (parentIdx >= nodePtrs.size())
+			{
+				throw Exception("Invalid checkpoint snapshot");
+			}
+			nodePtrs.push_back(
+				nodePtrs[static_cast<size_t>(parentIdx)]->AddChild(
+					std::move(header),
+					syncState
+				)
+			);
+		}
+
+		m_isLastNodeCandidate =
+			(PrimitiveTypeTrait<uint8_t>::FromBytes(snapshot[3].AsBytes()) != 0);
+		if (m_lastNode != nullptr)
+		{
+			// the last node is always the newest header in both windows
+			const Difficulty diff = m_lastNode->GetHeader().GetDiff();
+			(m_isLastNodeCandidate ? m_candDiffs : m_currDiffs).Push(diff);
+			m_recentDiffs.Push(diff);
+		}
+	}
+
+private: // static members:
+
+	/**
+	 * @brief A slot in the window ring; the block number is kept next to
+	 *        the header pointer, so the range of the current window can be
+	 *        read without visiting the header
+	 *
+	 */
+	struct WindowSlot
+	{
+		WindowSlot() :
+			m_header(),
+			m_blkNum(0)
+		{}
+
+		std::unique_ptr<HeaderMgr> m_header;
+		BlockNumber m_blkNum;
+	}; // struct WindowSlot
+
 private:
+
+	/**
+	 * @brief Get the slot at the given offset from the beginning of the
+	 *        current window; offsets beyond the current window refer to the
+	 *        candidate window
+	 *
+	 */
+	WindowSlot& GetSlot(size_t offset)
+	{
+		return m_ring[(m_currBegin + offset) % m_ring.size()];
+	}
+
+	const WindowSlot& GetSlot(size_t offset) const
+	{
+		return m_ring[(m_currBegin + offset) % m_ring.size()];
+	}
+
+	/**
+	 * @brief Store the header in the given slot; the header left in the slot
+	 *        from an earlier window (if any) is released here
+	 *
+	 */
+	static void FillSlot(WindowSlot& slot, std::unique_ptr<HeaderMgr> header)
+	{
+		slot.m_blkNum = header->GetNumber();
+		slot.m_header = std::move(header);
+	}
+
+	void PushCurrWindow(std::unique_ptr<HeaderMgr> header)
+	{
+		if ((m_candSize != 0) || (m_currSize >= m_chkptSize))
+		{
+			throw Exception("The current window cannot take more headers");
+		}
+		FillSlot(GetSlot(m_currSize), std::move(header));
+		++m_currSize;
+	}
+
+	void PushCandidate(std::unique_ptr<HeaderMgr> header)
+	{
+		if (m_currSize + m_candSize >= m_ring.size())
+		{
+			throw Exception("The candidate window cannot take more headers");
+		}
+		FillSlot(GetSlot(m_currSize + m_candSize), std::move(header));
+		++m_candSize;
+	}
+
+	/**
+	 * @brief Turn the candidate window into the current window, by moving
+	 *        the boundary in the ring. Slots of the old current window are
+	 *        reused by the new candidate window.
+	 *
+	 */
+	void RollOver()
+	{
+		m_currBegin = (m_currBegin + m_currSize) % m_ring.size();
+		m_currSize = m_candSize;
+		m_candSize = 0;
+
+		m_currDiffs.Swap(m_candDiffs);
+		m_candDiffs.Clear();
+	}
+
+	/**
+	 * @brief Record the difficulty of the new last node, which joins the
+	 *        given window
+	 *
+	 */
+	void AddLastNodeDiff(DiffWindow& window)
+	{
+		const Difficulty diff = m_lastNode->GetHeader().GetDiff();
+		window.Push(diff);
+		m_recentDiffs.Push(diff);
+	}
+
 	size_t m_chkptSize;
 	OnCompleteCallback m_onComplete;
-	std::vector<std::unique_ptr<HeaderMgr> > m_currWindow;
-	std::vector<std::unique_ptr<HeaderMgr> > m_candidate;
+	std::vector<WindowSlot> m_ring;
+	size_t m_currBegin;
+	size_t m_currSize;
+	size_t m_candSize;
 	std::unique_ptr<HeaderNode> m_lastNode;
 	bool m_isLastNodeCandidate;
+	// difficulty values of the current window, including the last node
+	// if it's not a candidate
+	DiffWindow m_currDiffs;
+	// difficulty values of the candidate window, including the last node
+	// if it's a candidate
+	DiffWindow m_candDiffs;
+	DiffWindow m_recentDiffs;
 
 }; // class CheckpointMgr
 
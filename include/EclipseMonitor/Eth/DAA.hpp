@@ -5,6 +5,11 @@
 
 #pragma once
 
+#include <cstddef>
+
+#include <iterator>
+#include <limits>
+
 #include "../Exceptions.hpp"
 
 #include "DataTypes.hpp"
@@ -43,26 +48,29 @@ public:
 
 protected:
 
-	static DiffType CalcBomb(
-		const BlkNumType& periodCount,
-		const BlkNumType& blkNBig2,
-		const DiffType&   diffBig1,
-		const DiffType&   diffBig2)
+	/**
+	 * @brief Calculate the difficulty bomb, 2^(periodCount - 2), with a
+	 *        single shift; like the multiplication it replaces, the result
+	 *        wraps to 0 once it no longer fits in `DiffType`
+	 *
+	 */
+	static DiffType CalcBomb(const BlkNumType& periodCount)
 	{
-		if (periodCount <= blkNBig2)
+		static constexpr BlkNumType sk_numOfDiffBits =
+			static_cast<BlkNumType>(std::numeric_limits<DiffType>::digits);
+
+		if (periodCount <= 2)
 		{
 			// reference: https://pkg.go.dev/math/big#Int.Exp
-			return diffBig1;
+			return DiffType(1);
+		}
+		else if ((periodCount - 2) >= sk_numOfDiffBits)
+		{
+			return DiffType(0);
 		}
 		else
 		{
-			BlkNumType exp = periodCount - blkNBig2;
-			DiffType y = diffBig1;
-			for (BlkNumType i = 0; i < exp; i++)
-			{
-				y *= diffBig2;
-			}
-			return y;
+			return DiffType(1) << (periodCount - 2);
 		}
 	}
 }; // class DAABase
@@ -219,7 +227,6 @@ public:
 
 		static const BlkNumType sk_blkNBig0      = BlkNumType(0);
 		static const BlkNumType sk_blkNBig1      = BlkNumType(1);
-		static const BlkNumType sk_blkNBig2      = BlkNumType(2);
 		static const BlkNumType sk_expDiffPeriod = BlkNumType(100000);
 
 		bool isReducing = false;
@@ -323,7 +330,7 @@ public:
 		BlkNumType periodCount = fakeBlockNumber / sk_expDiffPeriod;
 		if (periodCount > sk_blkNBig1)
 		{
-			y = CalcBomb(periodCount, sk_blkNBig2, sk_diffBig1, sk_diffBig2);
+			y = CalcBomb(periodCount);
 			x += y;
 		}
 
@@ -387,13 +394,10 @@ public:
 		const TimeType& currTime
 	) const
 	{
-		static const DiffType sk_diffBig1  = DiffType(1);
-		static const DiffType sk_diffBig2  = DiffType(2);
 		static const DiffType sk_minDiff   =
 			DiffType(Params::GetMinimumDifficulty());
 
 		static const BlkNumType sk_blkNBig1      = BlkNumType(1);
-		static const BlkNumType sk_blkNBig2      = BlkNumType(2);
 		static const BlkNumType sk_expDiffPeriod = BlkNumType(100000);
 
 		// Frontier algorithm:
@@ -427,8 +431,7 @@ public:
 		BlkNumType periodCount = fakeBlockNumber / sk_expDiffPeriod;
 		if (periodCount > sk_blkNBig1)
 		{
-			DiffType bombVal =
-				CalcBomb(periodCount, sk_blkNBig2, sk_diffBig1, sk_diffBig2);
+			DiffType bombVal = CalcBomb(periodCount);
 			diff += bombVal;
 		}
 
@@ -453,41 +456,31 @@ public: // static members:
 
 	static const Base& GetCalculator(const BlkNumType& blkNum)
 	{
-		if (ChainConfig::IsBlockOfParis(blkNum))
-		{
-			throw Exception("Blocks since Paris fork no longer use DAA");
-		}
-		else if (ChainConfig::IsBlockOfGrayGlacier(blkNum))
-		{
-			return EthashDAACalculator::GetEip5133();
-		}
-		else if (ChainConfig::IsBlockOfArrowGlacier(blkNum))
-		{
-			return EthashDAACalculator::GetEip4345();
-		}
-		else if (ChainConfig::IsBlockOfLondon(blkNum))
-		{
-			return EthashDAACalculator::GetEip3554();
-		}
-		else if (ChainConfig::IsBlockOfMuirGlacier(blkNum))
-		{
-			return EthashDAACalculator::GetEip2384();
-		}
-		else if (ChainConfig::IsBlockOfConstantinople(blkNum))
-		{
-			return EthashDAACalculator::GetConstantinople();
-		}
-		else if (ChainConfig::IsBlockOfByzantium(blkNum))
-		{
-			return EthashDAACalculator::GetByzantium();
-		}
-		else if (ChainConfig::IsBlockOfHomestead(blkNum))
-		{
-			return EthashDAACalculator::GetHomestead();
-		}
-		else
+		return GetCalculator(ChainConfig::GetFork(blkNum));
+	}
+
+	static const Base& GetCalculator(Forks fork)
+	{
+		switch (fork)
 		{
+		case Forks::Frontier:
 			return EthashDAACalculatorFrontier::GetInstance();
+		case Forks::Homestead:
+			return EthashDAACalculator::GetHomestead();
+		case Forks::Byzantium:
+			return EthashDAACalculator::GetByzantium();
+		case Forks::Constantinople:
+			return EthashDAACalculator::GetConstantinople();
+		case Forks::MuirGlacier:
+			return EthashDAACalculator::GetEip2384();
+		case Forks::London:
+			return EthashDAACalculator::GetEip3554();
+		case Forks::ArrowGlacier:
+			return EthashDAACalculator::GetEip4345();
+		case Forks::GrayGlacier:
+			return EthashDAACalculator::GetEip5133();
+		default:
+			throw Exception("Blocks since Paris fork no longer use DAA");
 		}
 	}
 
@@ -508,6 +501,57 @@ public:
 		return calculator(parent, current);
 	}
 
+	/**
+	 * @brief Calculate the difficulty values of a sequence of consecutive
+	 *        headers, where each header (except the first one) is the child
+	 *        of the one before it.
+	 *        The calculator is only looked up again when the sequence crosses
+	 *        a fork.
+	 *
+	 * @param begin The iterator to the first header (i.e., the parent of the
+	 *              first difficulty value calculated); dereferencing it must
+	 *              give a `const HeaderMgr&`
+	 * @param end   The iterator past the last header
+	 * @param out   The output iterator receiving (end - begin - 1) values
+	 * @return the output iterator past the last value written
+	 */
+	template<typename _HeaderItType, typename _DiffItType>
+	_DiffItType CalcBatch(
+		_HeaderItType begin,
+		_HeaderItType end,
+		_DiffItType out
+	) const
+	{
+		if (begin == end)
+		{
+			return out;
+		}
+
+		const DAABase* calculator = nullptr;
+		BlkNumType forkBegin = 0;
+		BlkNumType forkEnd = 0;
+		_HeaderItType parent = begin;
+		for (_HeaderItType it = std::next(begin); it != end; ++it, ++out)
+		{
+			const HeaderMgr& parentHdr = *parent;
+			const HeaderMgr& currHdr = *it;
+			const BlkNumType blkNum = currHdr.GetNumber();
+			if ((calculator == nullptr) ||
+				(blkNum < forkBegin) ||
+				(blkNum >= forkEnd))
+			{
+				Forks fork = ChainConfig::GetFork(blkNum);
+				calculator = &GetCalculator(fork);
+				forkBegin =
+					ChainConfig::sk_forkSchedule[static_cast<size_t>(fork)];
+				forkEnd = ChainConfig::GetForkEndBlkNum(fork);
+			}
+			*out = (*calculator)(parentHdr, currHdr);
+			parent = it;
+		}
+		return out;
+	}
+
 }; // class EthashDAAImpl
 
 
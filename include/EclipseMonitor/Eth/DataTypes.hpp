@@ -11,6 +11,7 @@
 #include <array>
 
 #include "../DataTypes.hpp"
+#include "../Internal/SimpleObj.hpp"
 #include "../Internal/SimpleRlp.hpp"
 
 namespace EclipseMonitor
@@ -23,15 +24,16 @@ struct PrimitiveTypeTrait
 {
 	using value_type = _PrimitiveType;
 
-	static value_type FromBytes(const Internal::Rlp::BytesObjType& b)
+	static value_type FromBytes(const Internal::Obj::BytesBaseObj& b)
 	{
 		size_t i = 0;
+		const uint8_t* data = b.data();
 		auto res = Internal::Rlp::ParsePrimitiveIntValue<
 			value_type,
 			Internal::Rlp::Endian::native>::Parse(
 				b.size(),
-				[&i, &b](){
-					return b[i++];
+				[&i, &data](){
+					return data[i++];
 				}
 			);
 		return res;
@@ -70,6 +72,8 @@ using ContractAddr = std::array<uint8_t, 20>;
 
 using EventTopic = std::array<uint8_t, 32>;
 
+using FuncSelector = std::array<uint8_t, 4>;
+
 using EventCallbackId = std::uintptr_t;
 
 
@@ -5,8 +5,10 @@
 
 #pragma once
 
+#include <limits>
 #include <memory>
 
+#include "../Internal/Policy.hpp"
 #include "../MonitorReport.hpp"
 
 #include "CheckpointMgr.hpp"
@@ -56,19 +58,110 @@ public:
 		const HeaderMgr& parentHdr,
 		uint64_t currentTime) const = 0;
 
+	/**
+	 * @brief Calculate the earliest time, starting from the time when the
+	 *        parent header is received, at which `CheckEstDifficulty` will
+	 *        fail, so the caller only needs to check it once.
+	 *        The default implementation searches for that time by calling
+	 *        `CheckEstDifficulty`, assuming that once it fails, it will keep
+	 *        failing as the time goes on.
+	 *
+	 * @param parentHdr
+	 * @return the expiry time, or the maximum value of uint64_t if the
+	 *         parent header never expires
+	 */
+	virtual uint64_t CalcExpiryTime(const HeaderMgr& parentHdr) const
+	{
+		return SearchExpiryTime(
+			parentHdr.GetTrustedTime(),
+			std::numeric_limits<uint64_t>::max(),
+			[this, &parentHdr](uint64_t currentTime)
+			{
+				return CheckEstDifficulty(parentHdr, currentTime);
+			}
+		);
+	}
+
+protected:
+
+	/**
+	 * @brief Search for the earliest time in range `[begin, end]` at which
+	 *        `isValid` returns false, assuming that once it returns false,
+	 *        it will keep returning false for any later time.
+	 *        It costs O(log(end - begin)) calls to `isValid`.
+	 *
+	 * @return the earliest invalid time, or `end` if `isValid` returns true
+	 *         for the entire range
+	 */
+	template<typename _IsValidFunc>
+	static uint64_t SearchExpiryTime(
+		uint64_t begin,
+		uint64_t end,
+		_IsValidFunc isValid
+	)
+	{
+		if (!isValid(begin))
+		{
+			return begin;
+		}
+
+		// 1. exponential search for an invalid time,
+		//    so that `lo` is valid, and `hi` is invalid (or the end)
+		uint64_t lo = begin;
+		uint64_t hi = begin;
+		uint64_t step = 1;
+		while (true)
+		{
+			hi = ((end - lo) > step) ? (lo + step) : end;
+			if ((hi == end) || !isValid(hi))
+			{
+				break;
+			}
+			lo = hi;
+			step *= 2;
+		}
+
+		// 2. binary search in range (lo, hi]
+		while ((hi - lo) > 1)
+		{
+			uint64_t mid = lo + ((hi - lo) / 2);
+			if (isValid(mid))
+			{
+				lo = mid;
+			}
+			else
+			{
+				hi = mid;
+			}
+		}
+
+		return hi;
+	}
+
 }; // class DiffCheckerBase
 
 
-class PoWDiffChecker : public DiffCheckerBase
+/**
+ * @brief The difficulty checker for Proof-of-Work blocks
+ *
+ * @tparam _DAAType The type of the difficulty estimator held by the checker;
+ *                  it's either a concrete DAA estimator (e.g.,
+ *                  `MainnetDAAEstimator`), or a `std::unique_ptr` to
+ *                  `DAABase`
+ */
+template<typename _DAAType>
+class BasicPoWDiffChecker : public DiffCheckerBase
 {
 public: // static members:
-	using Self = PoWDiffChecker;
+	using Self = BasicPoWDiffChecker<_DAAType>;
 	using Base = DiffCheckerBase;
 
+	using DAAType = _DAAType;
+
 public:
-	PoWDiffChecker(
+	BasicPoWDiffChecker(
 		const MonitorConfig& mConf,
-		std::unique_ptr<DAABase> diffEstimator
+		DAAType diffEstimator
 	) :
 		DiffCheckerBase(),
 		m_minDiffPercent(mConf.get_minDiffPercent().GetVal()),
@@ -77,7 +170,7 @@ public:
 	{}
 
 	// LCOV_EXCL_START
-	virtual ~PoWDiffChecker() = default;
+	virtual ~BasicPoWDiffChecker() = default;
 	// LCOV_EXCL_STOP
 
 	virtual void OnChkptUpd(const CheckpointMgr& chkpt) override
@@ -107,9 +200,46 @@ public:
 	{
 		HeaderMgr estNextHdr;
 		estNextHdr.SetNumber(parentHdr.GetNumber() + 1);
+
+		return CheckEstDifficulty(parentHdr, estNextHdr, currentTime);
+	}
+
+	virtual uint64_t CalcExpiryTime(const HeaderMgr& parentHdr) const override
+	{
+		// the estimated header is reused for all the checks
+		HeaderMgr estNextHdr;
+		estNextHdr.SetNumber(parentHdr.GetNumber() + 1);
+
+		// the parent header expires after the max wait time anyway
+		uint64_t begin = parentHdr.GetTrustedTime();
+		uint64_t end =
+			(m_maxWaitTime < (std::numeric_limits<uint64_t>::max() - begin)) ?
+				(begin + m_maxWaitTime + 1) :
+				std::numeric_limits<uint64_t>::max();
+
+		return Base::SearchExpiryTime(
+			begin,
+			end,
+			[this, &parentHdr, &estNextHdr](uint64_t currentTime)
+			{
+				return CheckEstDifficulty(parentHdr, estNextHdr, currentTime);
+			}
+		);
+	}
+
+
+private:
+
+	bool CheckEstDifficulty(
+		const HeaderMgr& parentHdr,
+		HeaderMgr& estNextHdr,
+		uint64_t currentTime
+	) const
+	{
 		estNextHdr.SetTime(currentTime);
 
-		auto estDiff = (*m_diffEstimator)(parentHdr, estNextHdr);
+		auto estDiff =
+			Internal::GetPolicy(m_diffEstimator)(parentHdr, estNextHdr);
 
 		auto deltaTime = currentTime - parentHdr.GetTrustedTime();
 
@@ -120,15 +250,16 @@ public:
 			(estDiff >= m_minDiff);
 	}
 
-
-private:
 	uint8_t m_minDiffPercent;
 	Difficulty m_minDiff;
 	uint64_t m_maxWaitTime;
 
-	std::unique_ptr<DAABase> m_diffEstimator;
+	DAAType m_diffEstimator;
+
+}; // class BasicPoWDiffChecker
+
 
-}; // class PoWDiffChecker
+using PoWDiffChecker = BasicPoWDiffChecker<std::unique_ptr<DAABase> >;
 
 
 class PoSDiffChecker : public DiffCheckerBase
@@ -171,23 +302,38 @@ public:
 		return true;
 	}
 
+	virtual uint64_t CalcExpiryTime(
+		const HeaderMgr& /* parentHdr */
+	) const override
+	{
+		// At this moment, we don't check anything for Proof-of-Stake,
+		// so it never expires
+		return std::numeric_limits<uint64_t>::max();
+	}
+
 
 private:
 
 }; // class PoSDiffChecker
 
 
-template<typename _NetConfig>
+template<
+	typename _NetConfig,
+	typename _DAAType = std::unique_ptr<DAABase>
+>
 class GenericDiffCheckerImpl : public DiffCheckerBase
 {
 public: // static members:
-	using Self = GenericDiffCheckerImpl<_NetConfig>;
+	using Self = GenericDiffCheckerImpl<_NetConfig, _DAAType>;
 	using Base = DiffCheckerBase;
 
+	using DAAType = _DAAType;
+	using PoWCheckerType = BasicPoWDiffChecker<DAAType>;
+
 public:
 	GenericDiffCheckerImpl(
 		const MonitorConfig& mConf,
-		std::unique_ptr<DAABase> diffEstimator
+		DAAType diffEstimator
 	) :
 		Base(),
 		m_powChecker(mConf, std::move(diffEstimator)),
@@ -241,9 +387,21 @@ public:
 		}
 	}
 
+	virtual uint64_t CalcExpiryTime(const HeaderMgr& parentHdr) const override
+	{
+		if (_NetConfig::IsBlockOfParis(parentHdr.GetNumber() + 1))
+		{
+			return m_posChecker.CalcExpiryTime(parentHdr);
+		}
+		else
+		{
+			return m_powChecker.CalcExpiryTime(parentHdr);
+		}
+	}
+
 private:
 
-	PoWDiffChecker m_powChecker;
+	PoWCheckerType m_powChecker;
 	PoSDiffChecker m_posChecker;
 }; // class GenericDiffCheckerImpl
 
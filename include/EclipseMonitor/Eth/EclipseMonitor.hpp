@@ -5,19 +5,33 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <functional>
+#include <iterator>
+#include <limits>
 #include <memory>
-#include <unordered_map>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include <SimpleObjects/Codec/Hex.hpp>
 
 #include "../EclipseMonitorBase.hpp"
+#include "../Internal/FixedKeyFlatMap.hpp"
+#include "../Internal/Policy.hpp"
 #include "../Internal/SimpleObj.hpp"
+#include "../Metrics.hpp"
+#include "../PlatformInterfaces.hpp"
 
 #include "CheckpointMgr.hpp"
 #include "DiffChecker.hpp"
 #include "EventManager.hpp"
 #include "HeaderMgr.hpp"
+#include "HeaderSummary.hpp"
+#include "MonitorStatus.hpp"
 #include "SyncMsgMgr.hpp"
 #include "Validator.hpp"
 
@@ -27,27 +41,106 @@ namespace Eth
 {
 
 
-class EclipseMonitor : public EclipseMonitorBase
+/**
+ * @brief The eclipse monitor for Ethereum, whose validator and difficulty
+ *        checker are given as policies.
+ *        A policy is either the concrete type held by value (e.g.,
+ *        `Validator<MainnetConfig, MainnetDAA>`), so all calls on it,
+ *        including the ones on the DAA it holds, are statically dispatched
+ *        and can be inlined, or a `std::unique_ptr` to the polymorphic base
+ *        class, so it can be chosen at runtime (see `EclipseMonitor`).
+ *        The network config and the DAA are the policies of the validator
+ *        and the difficulty checker.
+ *
+ * @tparam _ValidatorType   The type of the validator, or a `std::unique_ptr`
+ *                          to `ValidatorBase`
+ * @tparam _DiffCheckerType The type of the difficulty checker, or a
+ *                          `std::unique_ptr` to `DiffCheckerBase`
+ */
+template<typename _ValidatorType, typename _DiffCheckerType>
+class BasicEclipseMonitor : public EclipseMonitorBase
 {
 public: // Static members
 
-	using Self = EclipseMonitor;
+	using Self = BasicEclipseMonitor<_ValidatorType, _DiffCheckerType>;
 	using Base = EclipseMonitorBase;
 
+	using ValidatorType = _ValidatorType;
+	using DiffCheckerType = _DiffCheckerType;
+
 	using OnHeaderConfCallback = std::function<void(const HeaderMgr&)>;
+	/**
+	 * @brief Callback receiving all headers confirmed by a checkpoint at
+	 *        once; the parameters are the block number range (first, last)
+	 *        of the checkpoint, and the summaries of the confirmed headers
+	 *        in the order of block numbers, stored contiguously.
+	 *        The summaries are only valid during the call.
+	 *
+	 */
+	using OnHeadersConfCallback = std::function<
+		void(
+			const std::pair<BlockNumber, BlockNumber>&,
+			const HeaderSummary*,
+			size_t
+		)
+	>;
+	/**
+	 * @brief Map from block hash to the node in the fork tree.
+	 *        Block hashes are uniformly distributed, so they are used as
+	 *        the hash value directly.
+	 *
+	 */
 	using NodeLookUpMap =
-		std::unordered_map<Internal::Obj::Bytes, HeaderNode*>;
+		Internal::FixedKeyFlatMap<
+			std::tuple_size<HeaderMgr::HashType>::value,
+			HeaderNode*
+		>;
+	using NodeLookUpKey = typename NodeLookUpMap::KeyType;
+
+	/**
+	 * @brief The maximum number of headers parsed at a time by `UpdateBatch`
+	 *
+	 */
+	static constexpr size_t sk_batchChunkSize = 256;
+
+	using SnapshotHashType = HeaderMgr::HashType;
+
+	/**
+	 * @brief The version of the snapshot format generated by `TakeSnapshot`
+	 *
+	 */
+	static constexpr uint8_t sk_snapshotVersion = 1;
+
+#if defined(__cpp_lib_atomic_shared_ptr) && __cpp_lib_atomic_shared_ptr != 0
+	using AtomicStatusType = std::atomic<std::shared_ptr<const MonitorStatus> >;
+#else // defined(__cpp_lib_atomic_shared_ptr) && __cpp_lib_atomic_shared_ptr != 0
+	using AtomicStatusType = std::shared_ptr<const MonitorStatus>;
+#endif // defined(__cpp_lib_atomic_shared_ptr) && __cpp_lib_atomic_shared_ptr != 0
+
+	/**
+	 * @brief Verify the integrity of the given snapshot, and get its hash.
+	 *        The hash can be kept in a trusted storage (e.g., sealed by the
+	 *        enclave), so that the snapshot itself can be stored by an
+	 *        untrusted host, and be verified when it is restored.
+	 *
+	 */
+	static SnapshotHashType GetSnapshotHash(const std::vector<uint8_t>& snapshot)
+	{
+		SnapshotHashType hash;
+		VerifySnapshot(snapshot, hash);
+		return hash;
+	}
 
 public:
 
-	EclipseMonitor(
+	BasicEclipseMonitor(
 		const MonitorConfig& conf,
 		TimestamperType timestamper,
 		RandomGeneratorType randGen,
 		OnHeaderConfCallback onHeaderValidated,
 		OnHeaderConfCallback onHeaderConfirmed,
-		std::unique_ptr<ValidatorBase> validator,
-		std::unique_ptr<DiffCheckerBase> diffChecker,
+		ValidatorType validator,
+		DiffCheckerType diffChecker,
 		const ContractAddr& syncContractAddr,
 		const EventTopic& syncEventSign
 	) :
@@ -55,6 +148,8 @@ public:
 
 		m_onHeaderValidated(onHeaderValidated),
 		m_onHeaderConfirmed(onHeaderConfirmed),
+		m_onHeadersConfirmed(),
+		m_confirmedBatch(),
 
 		m_checkpoint(conf, [this](){
 			this->OnCheckpointComplete();
@@ -75,34 +170,271 @@ public:
 
 		m_offlineNodes(),
 		m_activeNodes(),
+		m_expiryQueue(),
+		m_expiryGen(0),
+		m_evictionNodes(),
+		m_evictionQueue(),
+		m_evictionGen(0),
+		m_skippedEvictions(),
 
 		m_startBlockNum(0),
 		m_bootstrapIEndBlkNum(-1),
-		m_planedSyncBlkNum(-1)
-	{}
+		m_planedSyncBlkNum(-1),
+		m_isSyncPlanRestored(false),
+
+		m_bestTip(nullptr),
+		m_status(),
+		m_publishedStatus(nullptr)
+	{
+		PublishStatus();
+	}
+
+	/**
+	 * @brief Construct a new Eclipse Monitor from a snapshot generated by
+	 *        `TakeSnapshot`, so the headers before the snapshot don't need to
+	 *        be replayed.
+	 *        A snapshot taken after the bootstrap I phase is always restored
+	 *        into the bootstrap II phase, and all nodes in the fork tree are
+	 *        restored as offline nodes, since the new monitor instance has
+	 *        to sync with the blockchain again.
+	 *        The planed sync block is restored as well; if the first header
+	 *        received afterwards is already past it, the sync block is
+	 *        re-planned to that header. `RefreshBootstrapPlan` can still be
+	 *        called to plan for a different block.
+	 *
+	 * @param snapshot            The snapshot binary, which can be kept in
+	 *                            an untrusted storage
+	 * @param trustedSnapshotHash The hash of the snapshot obtained from
+	 *                            `GetSnapshotHash` and kept in a trusted
+	 *                            storage; the hash embedded in the snapshot
+	 *                            only detects accidental corruption, since
+	 *                            anyone can recompute it
+	 */
+	BasicEclipseMonitor(
+		const MonitorConfig& conf,
+		TimestamperType timestamper,
+		RandomGeneratorType randGen,
+		OnHeaderConfCallback onHeaderValidated,
+		OnHeaderConfCallback onHeaderConfirmed,
+		ValidatorType validator,
+		DiffCheckerType diffChecker,
+		const ContractAddr& syncContractAddr,
+		const EventTopic& syncEventSign,
+		const std::vector<uint8_t>& snapshot,
+		const SnapshotHashType& trustedSnapshotHash
+	) :
+		BasicEclipseMonitor(
+			conf,
+			std::move(timestamper),
+			std::move(randGen),
+			std::move(onHeaderValidated),
+			std::move(onHeaderConfirmed),
+			std::move(validator),
+			std::move(diffChecker),
+			syncContractAddr,
+			syncEventSign
+		)
+	{
+		RestoreSnapshot(snapshot, trustedSnapshotHash);
+		PublishStatus();
+	}
 
-	virtual ~EclipseMonitor()
+	virtual ~BasicEclipseMonitor()
 	{}
 
+	/**
+	 * @brief Take a snapshot of the monitor state, including the security
+	 *        state, the bootstrap plan, the checkpoint windows, and the fork
+	 *        tree; it can be restored by the constructor that takes a
+	 *        snapshot.
+	 *        The snapshot is an RLP list of the encoded state, and the
+	 *        Keccak-256 hash of it.
+	 *
+	 */
+	std::vector<uint8_t> TakeSnapshot() const
+	{
+		const uint8_t version = sk_snapshotVersion;
+
+		Internal::Obj::List payload;
+		payload.push_back(PrimitiveTypeTrait<uint8_t>::ToBytes(version));
+		payload.push_back(Internal::Obj::Bytes(
+			Internal::AdvRlp::GenericWriter::Write(Base::GetMonitorConfig())
+		));
+		payload.push_back(Internal::Obj::Bytes(
+			Internal::AdvRlp::GenericWriter::Write(Base::GetMonitorSecState())
+		));
+		payload.push_back(PrimitiveTypeTrait<uint8_t>::ToBytes(
+			static_cast<uint8_t>(Base::GetPhase())
+		));
+		payload.push_back(BlkNumTypeTrait::ToBytes(m_startBlockNum));
+		payload.push_back(BlkNumTypeTrait::ToBytes(m_bootstrapIEndBlkNum));
+		payload.push_back(BlkNumTypeTrait::ToBytes(m_planedSyncBlkNum));
+		payload.push_back(m_checkpoint.ToSnapshot());
+
+		std::vector<uint8_t> payloadBin = Internal::Rlp::WriteRlp(payload);
+		const SnapshotHashType hash = Keccak256(payloadBin);
+
+		Internal::Obj::List snapshot;
+		snapshot.push_back(Internal::Obj::Bytes(std::move(payloadBin)));
+		snapshot.push_back(Internal::Obj::Bytes(hash.begin(), hash.end()));
+		return Internal::Rlp::WriteRlp(snapshot);
+	}
+
 	virtual void Update(const std::vector<uint8_t>& hdrBinary) override
 	{
-		BlockNumber blkNum = 0;
-		// 1. check current phase
-		if (Base::GetPhase() == Phases::BootstrapI)
-		{
-			blkNum = UpdateOnBootstrapI(hdrBinary);
-		}
-		// all other phase will be treated like the runtime phase
-		else
-		{
-			blkNum = UpdateOnRuntime(hdrBinary);
-		}
+		UpdateHeader(
+			ParseHeader(hdrBinary, 0)
+		);
+	}
 
-		PhaseChangeCheck(blkNum);
+	virtual void Update(const uint8_t* hdrBinary, size_t hdrSize) override
+	{
+		UpdateHeader(
+			ParseHeader(
+				hdrBinary, hdrSize, 0
+			)
+		);
+	}
 
-		if (Base::GetPhase() != Phases::BootstrapI)
+	/**
+	 * @brief Update the monitor with a batch of headers, which has the same
+	 *        effect as calling `Update` on each of the headers in order.
+	 *        The headers are parsed and hashed by the given worker pool
+	 *        first, and then they are validated and added to the monitor
+	 *        one by one on the calling thread.
+	 *        During the Bootstrap I phase, the linkage between adjacent
+	 *        headers within a chunk is also validated by the worker pool,
+	 *        so only the first header of each chunk needs to be validated
+	 *        against the checkpoint on the calling thread.
+	 *        If any header fails, the headers before it have been processed,
+	 *        and the headers after it will not be processed.
+	 *
+	 * @tparam _ItType The type of the iterator pointing to
+	 *                 `std::vector<uint8_t>` objects
+	 * @param begin      The beginning of the header binary range
+	 * @param end        The end of the header binary range
+	 * @param workerPool The worker pool used to parse the headers; if it's
+	 *                   `nullptr`, headers will be parsed on the calling
+	 *                   thread
+	 */
+	template<typename _ItType>
+	void UpdateBatch(
+		_ItType begin,
+		_ItType end,
+		WorkerPoolBase* workerPool = nullptr
+	)
+	{
+		std::vector<std::unique_ptr<HeaderMgr> > headers;
+		std::vector<std::exception_ptr> errors;
+		// not std::vector<bool>, since its elements are written concurrently
+		std::vector<uint8_t> isLinked;
+		headers.reserve(sk_batchChunkSize);
+		errors.reserve(sk_batchChunkSize);
+		isLinked.reserve(sk_batchChunkSize);
+
+		while (begin != end)
 		{
-			RuntimeMaintenance();
+			// 1. take a chunk of headers, so the memory usage is bounded
+			_ItType chunkBegin = begin;
+			size_t chunkSize = 0;
+			for (; (begin != end) && (chunkSize < sk_batchChunkSize); ++begin)
+			{
+				++chunkSize;
+			}
+			headers.clear();
+			headers.resize(chunkSize);
+			errors.clear();
+			errors.resize(chunkSize);
+			isLinked.clear();
+			isLinked.resize(chunkSize, 0);
+
+			// 2. parse and hash headers in parallel
+			auto parseTask =
+				[&headers, &errors, &chunkBegin](size_t i)
+				{
+					try
+					{
+						_ItType it = chunkBegin;
+						std::advance(it, i);
+						headers[i] =
+							ParseHeader(
+								*it, 0
+							);
+					}
+					catch (...)
+					{
+						errors[i] = std::current_exception();
+					}
+				};
+			if (workerPool != nullptr)
+			{
+				workerPool->ParallelFor(chunkSize, parseTask);
+			}
+			else
+			{
+				for (size_t i = 0; i < chunkSize; ++i)
+				{
+					parseTask(i);
+				}
+			}
+
+			// 3. validate the linkage between adjacent headers in parallel,
+			//    if they are going to be loaded in the Bootstrap I phase
+			if (Base::GetPhase() == Phases::BootstrapI)
+			{
+				auto linkTask =
+					[this, &headers, &errors, &isLinked](size_t i)
+					{
+						// the first header in the chunk is validated against
+						// the checkpoint on the calling thread
+						if ((i == 0) ||
+							(errors[i - 1] != nullptr) ||
+							(errors[i] != nullptr) ||
+							(headers[i]->GetNumber() > m_bootstrapIEndBlkNum))
+						{
+							return;
+						}
+						try
+						{
+							isLinked[i] = ValidateHeader(
+								*headers[i - 1],
+								false,
+								*headers[i],
+								false
+							) ? 1 : 0;
+						}
+						catch (...)
+						{
+							// leave it to the calling thread, so the error
+							// is reported in order
+						}
+					};
+				if (workerPool != nullptr)
+				{
+					workerPool->ParallelFor(chunkSize, linkTask);
+				}
+				else
+				{
+					for (size_t i = 0; i < chunkSize; ++i)
+					{
+						linkTask(i);
+					}
+				}
+			}
+
+			// 4. process headers in order
+			for (size_t i = 0; i < chunkSize; ++i)
+			{
+				if (errors[i] != nullptr)
+				{
+					std::rethrow_exception(errors[i]);
+				}
+				// The linkage result of header i is only valid when header
+				// i - 1 is the last header in the checkpoint, which is the
+				// case as long as we're still in the Bootstrap I phase, since
+				// header i - 1 was successfully added right before this one
+				UpdateHeader(std::move(headers[i]), isLinked[i] != 0);
+			}
 		}
 	}
 
@@ -118,12 +450,133 @@ public:
 		//    point to add the following children
 		auto lastNodePtr = m_checkpoint.GetLastNodePtr();
 		const auto& lastHeader = lastNodePtr->GetHeader();
-		m_offlineNodes[lastHeader.GetHashObj()] = lastNodePtr;
+		m_offlineNodes.InsertOrAssign(lastHeader.GetHash(), lastNodePtr);
+		m_bestTip = lastNodePtr;
 
 		// 3. notify the base class that we're entering the next phase
 		Base::EndBootstrapI();
 	}
 
+	/**
+	 * @brief Bootstrap the monitor from a trusted checkpoint, instead of
+	 *        replaying all headers from the genesis block, and then enter the
+	 *        bootstrap II phase directly.
+	 *        The headers in the checkpoint window are validated against each
+	 *        other (i.e., the hash chain and the difficulty), and the last
+	 *        header must match the checkpoint hash and number in the trusted
+	 *        security state. The difficulty median is then calculated from
+	 *        this window as usual.
+	 *        NOTE: full header binaries are needed, since the hash chain can't
+	 *        be verified otherwise; and `RefreshBootstrapPlan` should be
+	 *        called afterwards to plan for the sync block.
+	 *
+	 * @param windowHeaders   Binaries of all headers in the checkpoint window,
+	 *                        in the order from older one to newer one
+	 * @param trustedSecState The trusted security state, which has the
+	 *                        genesis hash, the checkpoint iteration, and the
+	 *                        checkpoint hash and number of the window
+	 */
+	void BootstrapFromCheckpoint(
+		const std::vector<std::vector<uint8_t> >& windowHeaders,
+		const MonitorSecState& trustedSecState
+	)
+	{
+		if ((Base::GetPhase() != Phases::BootstrapI) || !m_checkpoint.IsEmpty())
+		{
+			throw Exception(
+				"The monitor can only be bootstrapped from a checkpoint before"
+				" any header is added");
+		}
+		const auto chkptSize =
+			Base::GetMonitorConfig().get_checkpointSize().GetVal();
+		if (windowHeaders.size() != chkptSize)
+		{
+			throw Exception(
+				"The number of headers doesn't match the checkpoint size");
+		}
+		if (trustedSecState.get_checkpointIter().GetVal() == 0)
+		{
+			throw Exception("The given security state has no checkpoint");
+		}
+
+		// 1. validate the hash chain and difficulty within the window
+		std::vector<std::unique_ptr<HeaderMgr> > headers;
+		headers.reserve(windowHeaders.size());
+		for (const auto& hdrBinary : windowHeaders)
+		{
+			auto header =
+				ParseHeader(hdrBinary, 0);
+			if (
+				!headers.empty() &&
+				!ValidateHeader(
+					*headers.back(),
+					false,
+					*header,
+					false
+				)
+			)
+			{
+				throw Exception(
+					"The given checkpoint window failed common validation");
+			}
+			headers.push_back(std::move(header));
+		}
+
+		// 2. the last header must be the trusted checkpoint
+		const HeaderMgr& lastHeader = *headers.back();
+		if (
+			(lastHeader.GetHashObj() != trustedSecState.get_checkpointHash()) ||
+			(
+				lastHeader.GetRawHeader().get_Number() !=
+					trustedSecState.get_checkpointNum()
+			)
+		)
+		{
+			throw Exception(
+				"The given checkpoint window doesn't match the trusted"
+				" checkpoint");
+		}
+
+		// 3. add the window to the checkpoint manager; the checkpoint
+		//    iteration will be incremented once the window is completed
+		Base::GetMonitorSecState().get_genesisHash() =
+			trustedSecState.get_genesisHash();
+		Base::GetMonitorSecState().get_checkpointIter() =
+			trustedSecState.get_checkpointIter().GetVal() - 1;
+		m_startBlockNum = headers.front()->GetNumber();
+		m_bootstrapIEndBlkNum = lastHeader.GetNumber();
+		for (auto& header : headers)
+		{
+			NotifyHeaderValidated(*header);
+			m_checkpoint.AddHeader(std::move(header));
+		}
+
+		Base::GetLogger().Info(
+			"Bootstrapped from checkpoint at block #" +
+			std::to_string(m_bootstrapIEndBlkNum)
+		);
+
+		// 4. enter the bootstrap II phase
+		EndBootstrapI();
+
+		PublishStatus();
+	}
+
+	/**
+	 * @brief Set the callback that receives all headers confirmed by each
+	 *        checkpoint in one call. It's called after the per-header
+	 *        confirmed callback given to the constructor, which can be
+	 *        `nullptr` if only the batch is needed.
+	 *
+	 */
+	void SetOnHeadersConfirmed(OnHeadersConfCallback onHeadersConfirmed)
+	{
+		m_onHeadersConfirmed = std::move(onHeadersConfirmed);
+		m_confirmedBatch.reserve(static_cast<size_t>(
+			Base::GetMonitorConfig().get_checkpointSize().GetVal()
+		));
+	}
+
 	std::shared_ptr<EventManager> GetEventManager() const
 	{
 		return m_eventManager;
@@ -137,10 +590,30 @@ public:
 	std::shared_ptr<SyncState> RefreshSyncMsg()
 	{
 		Base::EndBootstrapII();
-		return m_syncMsgMgr.NewSyncState(
+		auto syncState = m_syncMsgMgr.NewSyncState(
 			Base::GetTimestamper(),
 			Base::GetRandomGenerator()
 		);
+
+		PublishStatus();
+		return syncState;
+	}
+
+	/**
+	 * @brief Get the latest status published by the monitor.
+	 *        Unlike other accessors, this one is thread-safe, so it can be
+	 *        called by other threads while the monitor is being updated;
+	 *        the returned status is never modified, so it stays consistent
+	 *        no matter how long it's held by the caller.
+	 *
+	 */
+	std::shared_ptr<const MonitorStatus> GetStatus() const
+	{
+#if defined(__cpp_lib_atomic_shared_ptr) && __cpp_lib_atomic_shared_ptr != 0
+		return m_status.load();
+#else // defined(__cpp_lib_atomic_shared_ptr) && __cpp_lib_atomic_shared_ptr != 0
+		return std::atomic_load(&m_status);
+#endif // defined(__cpp_lib_atomic_shared_ptr) && __cpp_lib_atomic_shared_ptr != 0
 	}
 
 	void RefreshBootstrapPlan(
@@ -176,6 +649,7 @@ public:
 				logPlan = true;
 			}
 			m_planedSyncBlkNum = latestBlkNum;
+			m_isSyncPlanRestored = false;
 			break;
 
 		default:
@@ -184,14 +658,15 @@ public:
 
 		if (logPlan)
 		{
-			Base::GetLogger().Info(
-				std::string("Refresh Bootstrap Plan:\n") +
+			Base::GetLogger().Info([&]()
+			{
+				return std::string("Refresh Bootstrap Plan:\n") +
 				"\tStart  Block#    " + std::to_string(m_startBlockNum)       + ";\n" +
 				"\tLatest Block#    " + std::to_string(latestBlkNum)          + ";\n" +
 				"\tChkpt Size       " + std::to_string(chkptSize)             + ";\n" +
 				"\tBootI Phase End# " + std::to_string(m_bootstrapIEndBlkNum) + ";\n" +
-				"\tPlan Sync Block# " + std::to_string(m_planedSyncBlkNum) + ";\n"
-			);
+				"\tPlan Sync Block# " + std::to_string(m_planedSyncBlkNum) + ";\n";
+			});
 		}
 	}
 
@@ -212,13 +687,71 @@ public:
 
 protected:
 
+	/**
+	 * @brief Update the monitor with a header that has been parsed
+	 *
+	 * @param header       The parsed header; its trusted time will be set
+	 *                     according to the current phase
+	 * @param isLinkValid  Whether the header has already been validated
+	 *                     against the last header in the checkpoint; it's
+	 *                     only used in the Bootstrap I phase
+	 */
+	void UpdateHeader(
+		std::unique_ptr<HeaderMgr> header,
+		bool isLinkValid = false
+	)
+	{
+		const Phases phase = Base::GetPhase();
+		auto start = Metrics::Now();
+
+		BlockNumber blkNum = 0;
+		// 1. check current phase
+		if (Base::GetPhase() == Phases::BootstrapI)
+		{
+			blkNum = UpdateOnBootstrapI(std::move(header), isLinkValid);
+		}
+		// all other phase will be treated like the runtime phase
+		else
+		{
+			header->SetTrustedTime(Base::GetTimestamper().NowInSec());
+			blkNum = UpdateOnRuntime(std::move(header));
+		}
+
+		PhaseChangeCheck(blkNum);
+
+		if (Base::GetPhase() != Phases::BootstrapI)
+		{
+			RuntimeMaintenance();
+		}
+
+		PublishStatus();
+
+		RecordUpdateMetrics(phase, start);
+	}
+
 	BlockNumber UpdateOnBootstrapI(const std::vector<uint8_t>& hdrBinary)
+	{
+		return UpdateOnBootstrapI(
+			ParseHeader(hdrBinary, 0)
+		);
+	}
+
+	BlockNumber UpdateOnBootstrapI(const uint8_t* hdrBinary, size_t hdrSize)
+	{
+		return UpdateOnBootstrapI(
+			ParseHeader(
+				hdrBinary, hdrSize, 0
+			)
+		);
+	}
+
+	BlockNumber UpdateOnBootstrapI(
+		std::unique_ptr<HeaderMgr> header,
+		bool isLinkValid = false
+	)
 	{
 		// We're loading blocks before the latest checkpoint
 
-		std::unique_ptr<HeaderMgr> header =
-			Internal::Obj::Internal::make_unique<HeaderMgr>(
-				hdrBinary, 0);
 		BlockNumber blkNum = header->GetNumber();
 
 		// 1 check if this is the genesis (very first) block
@@ -228,17 +761,18 @@ protected:
 			// 1.a. update the monitor security state
 			Base::GetMonitorSecState().get_genesisHash() = header->GetHashObj();
 
-			using namespace Internal::Obj::Codec;
-			const auto hashStr = Hex::Encode<std::string>(header->GetHash());
-			Base::GetLogger().Info(
-				"Genesis block #" + std::to_string(blkNum) + "; Hash: " + hashStr
-			);
+			Base::GetLogger().Info([&]() -> std::string
+			{
+				using namespace Internal::Obj::Codec;
+				return "Genesis block #" + std::to_string(blkNum) +
+					"; Hash: " + Hex::Encode<std::string>(header->GetHash());
+			});
 		}
-		else
+		else if (!isLinkValid)
 		{
-			// b. it is not the genesis block
+			// b. it is not the genesis block, and it hasn't been validated
 			// 1.b validate the block
-			if (!m_validator->CommonValidate(
+			if (!ValidateHeader(
 					m_checkpoint.GetLastHeader(),
 					false,
 					*header,
@@ -252,7 +786,7 @@ protected:
 		}
 
 		// Callback for validated headers
-		m_onHeaderValidated(*header);
+		NotifyHeaderValidated(*header);
 
 		// Add the header to the checkpoint
 		m_checkpoint.AddHeader(std::move(header));
@@ -263,23 +797,44 @@ protected:
 
 	BlockNumber UpdateOnRuntime(const std::vector<uint8_t>& hdrBinary)
 	{
-		std::unique_ptr<HeaderMgr> header =
-			Internal::Obj::Internal::make_unique<HeaderMgr>(
+		return UpdateOnRuntime(
+			ParseHeader(
 				hdrBinary,
 				Base::GetTimestamper().NowInSec()
-			);
+			)
+		);
+	}
+
+	BlockNumber UpdateOnRuntime(const uint8_t* hdrBinary, size_t hdrSize)
+	{
+		return UpdateOnRuntime(
+			ParseHeader(
+				hdrBinary,
+				hdrSize,
+				Base::GetTimestamper().NowInSec()
+			)
+		);
+	}
+
+	BlockNumber UpdateOnRuntime(std::unique_ptr<HeaderMgr> header)
+	{
 		BlockNumber blkNum = header->GetNumber();
 
+		// a parent hash with invalid length can't be found in the maps
+		NodeLookUpKey parentHash;
+		bool isParentHashValid = ToNodeLookUpKey(
+			header->GetRawHeader().get_ParentHash(),
+			parentHash
+		);
+
 		// Check offline nodes map first
-		if (m_offlineNodes.size() > 0)
+		if (isParentHashValid && !m_offlineNodes.IsEmpty())
 		{
-			auto offNoIt = m_offlineNodes.find(
-				header->GetRawHeader().get_ParentHash()
-			);
-			if (offNoIt != m_offlineNodes.end())
+			HeaderNode* const* offNode = m_offlineNodes.Find(parentHash);
+			if (offNode != nullptr)
 			{
 				// we found the parent node
-				HeaderNode* parentNode = offNoIt->second;
+				HeaderNode* parentNode = *offNode;
 				UpdateOnRuntimeAddChild(
 					parentNode,
 					false,
@@ -291,15 +846,13 @@ protected:
 
 		// if we didn't find the parent node in the offline nodes map,
 		// check the active nodes map then
-		if (header != nullptr)
+		if (isParentHashValid && (header != nullptr))
 		{
-			auto actNoIt = m_activeNodes.find(
-				header->GetRawHeader().get_ParentHash()
-			);
-			if (actNoIt != m_activeNodes.end())
+			HeaderNode* const* actNode = m_activeNodes.Find(parentHash);
+			if (actNode != nullptr)
 			{
 				// we found the parent node
-				HeaderNode* parentNode = actNoIt->second;
+				HeaderNode* parentNode = *actNode;
 				UpdateOnRuntimeAddChild(
 					parentNode,
 					true,
@@ -311,12 +864,13 @@ protected:
 
 		if (header != nullptr)
 		{
-			using namespace Internal::Obj::Codec;
-			std::string blkHashHex = Hex::Encode<std::string>(header->GetHash());
-			Base::GetLogger().Error(
-				"Cannot find the parent of block #" + std::to_string(blkNum) +
-				"; hash: " + blkHashHex
-			);
+			Base::GetLogger().Error([&]() -> std::string
+			{
+				using namespace Internal::Obj::Codec;
+				return "Cannot find the parent of block #" +
+					std::to_string(blkNum) +
+					"; hash: " + Hex::Encode<std::string>(header->GetHash());
+			});
 		}
 
 		return blkNum;
@@ -335,14 +889,15 @@ protected:
 		{
 			// we found a new checkpoint candidate
 
-			// both last node and confirmed child are not active anymore
-			if (m_offlineNodes.size() > 0)
+			// both last node and confirmed child are not active anymore;
+			// the other forks under the last node will be dropped together
+			// with it, so they are not active anymore as well
+			EraseFromLookUpMaps(lastChptNode);
+			if (!m_offlineNodes.IsEmpty())
 			{
-				m_offlineNodes.erase(lastChptNode->GetHeader().GetHashObj());
-				m_offlineNodes.erase(confirmedChild->GetHeader().GetHashObj());
+				m_offlineNodes.Erase(confirmedChild->GetHeader().GetHash());
 			}
-			m_activeNodes.erase(lastChptNode->GetHeader().GetHashObj());
-			m_activeNodes.erase(confirmedChild->GetHeader().GetHashObj());
+			m_activeNodes.Erase(confirmedChild->GetHeader().GetHash());
 
 			// add to checkpoint
 			m_checkpoint.AddNode(std::move(confirmedChild));
@@ -350,18 +905,26 @@ protected:
 
 		// 2. check for expired active nodes
 		auto now = Base::GetTimestamper().NowInSec();
-		for (auto nodePtr : m_activeNodes)
+		while (
+			!m_expiryQueue.empty() &&
+			(m_expiryQueue.top().m_expiryTime <= now)
+		)
 		{
+			const ExpiryEntry& entry = m_expiryQueue.top();
+			HeaderNode* const* node = m_activeNodes.Find(entry.m_hash);
+			// entries of nodes that have already been removed from the
+			// active nodes are simply discarded; a node allocated at the
+			// same address after an eviction has a newer generation
 			if (
-				!m_diffChecker->CheckEstDifficulty(
-					nodePtr.second->GetHeader(),
-					now
-				)
+				(node != nullptr) &&
+				(*node == entry.m_node) &&
+				((*node)->GetExpiryGen() == entry.m_gen)
 			)
 			{
 				// the node is expired
-				m_activeNodes.erase(nodePtr.first);
+				m_activeNodes.Erase(entry.m_hash);
 			}
+			m_expiryQueue.pop();
 		}
 	}
 
@@ -376,6 +939,17 @@ protected:
 			}
 			break;
 		case Phases::BootstrapII:
+			if (m_isSyncPlanRestored)
+			{
+				// the first header after a restore tells whether the
+				// restored plan has already been passed; if so, this header
+				// is the best candidate we have for the sync block
+				m_isSyncPlanRestored = false;
+				if (currBlkNum > m_planedSyncBlkNum)
+				{
+					RefreshBootstrapPlan(currBlkNum);
+				}
+			}
 			if (currBlkNum == m_planedSyncBlkNum)
 			{
 				RefreshSyncMsg();
@@ -398,7 +972,7 @@ private:
 
 		// common validation
 		bool isNewNodeLive = syncState->IsSynced();
-		bool validateRes = m_validator->CommonValidate(
+		bool validateRes = ValidateHeader(
 			parentNode->GetHeader(),
 			isParentNodeLive,
 			*header,
@@ -409,45 +983,61 @@ private:
 		bool diffRes = false;
 		if (validateRes)
 		{
-			diffRes = m_diffChecker->CheckDifficulty(
+			diffRes = CheckHeaderDifficulty(
 				parentNode->GetHeader(),
 				*header
 			);
 		}
 
 		// if both check passed, add it to the parent node
-		if (validateRes && diffRes)
+		if (validateRes && diffRes && !MakeRoomForChild(parentNode))
+		{
+			Base::GetLogger().Error([&]() -> std::string
+			{
+				using namespace Internal::Obj::Codec;
+				return "Fork tree is full, dropped block #" +
+					std::to_string(header->GetNumber()) +
+					"; hash: " + Hex::Encode<std::string>(header->GetHash());
+			});
+		}
+		else if (validateRes && diffRes)
 		{
 			// Callback for validated headers
-			m_onHeaderValidated(*header);
+			NotifyHeaderValidated(*header);
 
-			auto hashObj = header->GetHashObj();
+			const NodeLookUpKey hash = header->GetHash();
 
 			// add the header to the parent node
 			HeaderNode* node =
 				parentNode->AddChild(std::move(header), std::move(syncState));
 			// !!! NOTE: header is invalid after this point !!!
 			// !!! NOTE: syncState is invalid after this point !!!
+			RescheduleEvictionOnPath(node);
+			UpdateBestTipOnAdd(node);
 
 			// add this node also to the active nodes
 			if (isNewNodeLive)
 			{
-				m_activeNodes.insert(std::make_pair(hashObj, node));
+				if (m_activeNodes.Insert(hash, node))
+				{
+					ScheduleExpiry(hash, node);
+					CompactExpiryQueue();
+				}
 			}
 			else
 			{
-				m_offlineNodes.insert(std::make_pair(hashObj, node));
+				m_offlineNodes.Insert(hash, node);
 			}
 		}
 		else
 		{
-			using namespace Internal::Obj::Codec;
-			BlockNumber blkNum = header->GetNumber();
-			std::string blkHashHex = Hex::Encode<std::string>(header->GetHash());
-			Base::GetLogger().Error(
-				"Validation failed on block #" + std::to_string(blkNum) +
-				"; hash: " + blkHashHex
-			);
+			Base::GetLogger().Error([&]() -> std::string
+			{
+				using namespace Internal::Obj::Codec;
+				return "Validation failed on block #" +
+					std::to_string(header->GetNumber()) +
+					"; hash: " + Hex::Encode<std::string>(header->GetHash());
+			});
 		}
 	}
 
@@ -462,14 +1052,20 @@ private:
 
 		// 2. Increment the checkpoint iterations
 		Base::GetMonitorSecState().get_checkpointIter()++;
+		Metrics::AddCount(MetricCounter::CheckpointComplete);
 
 		// 3. update the difficulty checker
-		m_diffChecker->OnChkptUpd(m_checkpoint);
+		Internal::GetPolicy(m_diffChecker).OnChkptUpd(m_checkpoint);
+
+		// 4. the expiry time of active nodes depends on the difficulty
+		//    checker, so they have to be re-calculated
+		RescheduleAllExpiry();
 
 		// on confirmed header callback
 		size_t i = 0;
 		BlockNumber startBlock = 0;
 		BlockNumber endBlock = 0;
+		m_confirmedBatch.clear();
 		m_checkpoint.IterateCurrWindow(
 			[this, &i, &startBlock, &endBlock](const HeaderMgr& header)
 			{
@@ -477,59 +1073,990 @@ private:
 					startBlock = header.GetNumber();
 				}
 				endBlock = header.GetNumber();
-				m_onHeaderConfirmed(header);
+				if (m_onHeaderConfirmed)
+				{
+					NotifyHeaderConfirmed(header);
+				}
+				if (m_onHeadersConfirmed)
+				{
+					m_confirmedBatch.push_back(
+						HeaderSummary::FromHeader(header)
+					);
+				}
 				++i;
 			}
 		);
-		Base::GetLogger().Debug(
-			std::string("Confirmed blocks from: ") +
+		if (m_onHeadersConfirmed)
+		{
+			auto start = Metrics::Now();
+			m_onHeadersConfirmed(
+				std::make_pair(startBlock, endBlock),
+				m_confirmedBatch.data(),
+				m_confirmedBatch.size()
+			);
+			Metrics::AddLatency(MetricLatency::HeaderCallback, start);
+		}
+		Base::GetLogger().Debug([&]()
+		{
+			return std::string("Confirmed blocks from: ") +
 				"block #" + std::to_string(startBlock) +
 				" to block #" + std::to_string(endBlock) +
-				" total: " + std::to_string(i) + " blocks"
-		);
+				" total: " + std::to_string(i) + " blocks";
+		});
 	}
 
 	/**
-	 * @brief `startBlk` and `chkptSize` should be constant, so the plan for
-	 *        when to end bootstrap I phase should solely depend on `latestBlk`
+	 * @brief Make sure a new child can be added to the given parent node,
+	 *        without exceeding the limits on the fork tree; if a limit is
+	 *        reached, the fork branch with the fewest descendants is removed.
+	 *        The child with the most descendants of any node is never removed.
+	 *
+	 * @return true if there is room for the new child, false if the new child
+	 *         should be dropped instead
 	 */
-	static uint64_t CalcBootstrapIEndBlkNum(
-		uint64_t latestBlk,
-		uint64_t startBlk,
-		uint64_t chkptSize
-	)
+	bool MakeRoomForChild(HeaderNode* parentNode)
 	{
-		uint64_t numOfBlocks = latestBlk - startBlk + 1;
-		uint64_t numOfInterval = numOfBlocks / chkptSize;
-		numOfInterval = (numOfInterval > 2) ? numOfInterval - 2 : 0;
-		uint64_t endBlkNum = startBlk + (numOfInterval * chkptSize);
+		const auto& conf = Base::GetMonitorConfig();
+		const size_t maxChildren =
+			static_cast<size_t>(conf.get_maxChildrenPerNode().GetVal());
+		const size_t maxLiveNodes =
+			static_cast<size_t>(conf.get_maxLiveNodes().GetVal());
+
+		// 1. limit on the number of children of the parent node
+		while (
+			(maxChildren != 0) &&
+			(parentNode->GetNumOfChildren() >= maxChildren)
+		)
+		{
+			size_t victimIdx = 0;
+			if (!FindLightestChild(parentNode, victimIdx))
+			{
+				return false;
+			}
+			RemoveSubtree(parentNode, victimIdx);
+		}
 
-		return endBlkNum - 1;
-	}
+		// 2. limit on the number of nodes in the fork tree
+		HeaderNode* rootNode = m_checkpoint.GetLastNodePtr();
+		bool hasRoom = true;
+		while (
+			hasRoom &&
+			(maxLiveNodes != 0) &&
+			(rootNode->GetNumOfDesc() >= maxLiveNodes)
+		)
+		{
+			HeaderNode* victim = PopEvictionCandidate(parentNode);
+			if (victim == nullptr)
+			{
+				hasRoom = false;
+			}
+			else
+			{
+				RemoveSubtree(victim->GetParent(), victim->GetIdxInParent());
+			}
+		}
 
-private:
+		// branches on the path to the parent node are still candidates for
+		// the following headers
+		for (const auto& entry : m_skippedEvictions)
+		{
+			m_evictionQueue.push(entry);
+		}
+		m_skippedEvictions.clear();
 
-	OnHeaderConfCallback m_onHeaderValidated;
-	OnHeaderConfCallback m_onHeaderConfirmed;
+		return hasRoom;
+	}
 
-	CheckpointMgr m_checkpoint;
-	std::unique_ptr<ValidatorBase> m_validator;
-	std::unique_ptr<DiffCheckerBase> m_diffChecker;
+	/**
+	 * @brief Pop the lightest fork branch from the eviction queue, skipping
+	 *        the ones on the path from the root to the given node
+	 *
+	 * @return the root of the branch, or nullptr if there is none
+	 */
+	HeaderNode* PopEvictionCandidate(const HeaderNode* pathEnd)
+	{
+		while (!m_evictionQueue.empty())
+		{
+			const EvictionEntry entry = m_evictionQueue.top();
+			m_evictionQueue.pop();
 
-	std::shared_ptr<EventManager> m_eventManager;
-	SyncMsgMgr m_syncMsgMgr;
+			// entries of nodes that have already been removed from the fork
+			// tree are simply discarded; a node allocated at the same
+			// address after an eviction has a newer generation
+			HeaderNode* const* node = m_evictionNodes.Find(entry.m_hash);
+			if (
+				(node == nullptr) ||
+				(*node != entry.m_node) ||
+				((*node)->GetEvictionGen() != entry.m_gen) ||
+				!IsForkBranch(*node)
+			)
+			{
+				continue;
+			}
 
-	// runtime & forks
-	// TODO sync manager
-	NodeLookUpMap m_offlineNodes;
-	NodeLookUpMap m_activeNodes;
+			if (IsOnPathTo(*node, pathEnd))
+			{
+				m_skippedEvictions.push_back(entry);
+				continue;
+			}
 
-	BlockNumber m_startBlockNum;
-	BlockNumber m_bootstrapIEndBlkNum;
-	BlockNumber m_planedSyncBlkNum;
+			return *node;
+		}
+		return nullptr;
+	}
+
+	/**
+	 * @brief Check if the given node can be evicted together with its
+	 *        descendants, i.e., it has a parent, and it's not the child
+	 *        with the most descendants of its parent
+	 *
+	 */
+	static bool IsForkBranch(const HeaderNode* node)
+	{
+		const HeaderNode* parent = node->GetParent();
+		return (parent != nullptr) &&
+			(node->GetIdxInParent() != parent->GetMaxDescChildIdx());
+	}
+
+	/**
+	 * @brief Check if the given node is the given path end, or one of its
+	 *        ancestors
+	 *
+	 */
+	static bool IsOnPathTo(const HeaderNode* node, const HeaderNode* pathEnd)
+	{
+		for (
+			const HeaderNode* curr = pathEnd;
+			curr != nullptr;
+			curr = curr->GetParent()
+		)
+		{
+			if (curr == node)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Find the child with the fewest descendants, except the one with
+	 *        the most descendants; if there are multiple, the earliest added
+	 *        one is chosen
+	 *
+	 */
+	static bool FindLightestChild(const HeaderNode* node, size_t& outIdx)
+	{
+		bool isFound = false;
+		for (size_t i = 0; i < node->GetNumOfChildren(); ++i)
+		{
+			if (
+				(i != node->GetMaxDescChildIdx()) &&
+				(
+					!isFound ||
+					(node->GetNumOfDescOfChild(i) <
+						node->GetNumOfDescOfChild(outIdx))
+				)
+			)
+			{
+				outIdx = i;
+				isFound = true;
+			}
+		}
+		return isFound;
+	}
+
+	void RemoveSubtree(HeaderNode* parentNode, size_t childIdx)
+	{
+		// only the children with fewer descendants are removed, so the best
+		// tip is never in the subtree; but the heaviest branch may change,
+		// once a node on the path loses to a sibling
+		HeaderNode* forkBefore = FindHeavyPathFork(parentNode);
+
+		EraseFromLookUpMaps(parentNode->GetChild(childIdx));
+		std::unique_ptr<HeaderNode> subtree = parentNode->ReleaseChild(childIdx);
+
+		HeaderNode* forkAfter = FindHeavyPathFork(parentNode);
+		if (forkAfter == nullptr)
+		{
+			m_bestTip = FindHeaviestLeaf(parentNode);
+		}
+		else if (forkAfter != forkBefore)
+		{
+			m_bestTip = FindHeaviestLeaf(
+				forkAfter->GetChild(forkAfter->GetMaxDescChildIdx())
+			);
+		}
+
+		// the remaining children are re-indexed, and any of them may become
+		// the one with the most descendants
+		for (size_t i = 0; i < parentNode->GetNumOfChildren(); ++i)
+		{
+			ScheduleEviction(parentNode->GetChild(i));
+		}
+		RescheduleEvictionOnPath(parentNode);
+
+		const auto& header = subtree->GetHeader();
+		Base::GetLogger().Debug([&]() -> std::string
+		{
+			using namespace Internal::Obj::Codec;
+			return "Removed fork branch starting from block #" +
+				std::to_string(header.GetNumber()) +
+				"; hash: " + Hex::Encode<std::string>(header.GetHash());
+		});
+	}
+
+	/**
+	 * @brief Update the best tip after the given leaf is added.
+	 *        A node can only take over as the child with the most
+	 *        descendants of its parent when a descendant is added to it, so
+	 *        the best tip only changes if it happens above the highest point
+	 *        where the path to the leaf leaves the heaviest branch
+	 *
+	 */
+	void UpdateBestTipOnAdd(HeaderNode* leaf)
+	{
+		HeaderNode* fork = nullptr;
+		bool isTakenOver = false;
+		HeaderNode* node = leaf;
+		for (
+			HeaderNode* parent = node->GetParent();
+			parent != nullptr;
+			node = parent, parent = node->GetParent()
+		)
+		{
+			const size_t idx = node->GetIdxInParent();
+			if (idx != parent->GetMaxDescChildIdx())
+			{
+				fork = parent;
+				isTakenOver = false;
+				continue;
+			}
+
+			// descendants are added one at a time, so the sibling taken
+			// over from has exactly one descendant less
+			const size_t numOfDesc = parent->GetNumOfDescOfChild(idx);
+			for (size_t i = 0; i < parent->GetNumOfChildren(); ++i)
+			{
+				isTakenOver = isTakenOver ||
+					(parent->GetNumOfDescOfChild(i) + 1 == numOfDesc);
+			}
+		}
+
+		if (fork == nullptr)
+		{
+			m_bestTip = leaf;
+		}
+		else if (isTakenOver)
+		{
+			m_bestTip = FindHeaviestLeaf(
+				fork->GetChild(fork->GetMaxDescChildIdx())
+			);
+		}
+	}
+
+	/**
+	 * @brief Find the highest node on the path from the root to the given
+	 *        node, whose child with the most descendants is off the path
+	 *
+	 * @return nullptr if the given node is on the heaviest branch
+	 */
+	static HeaderNode* FindHeavyPathFork(HeaderNode* node)
+	{
+		HeaderNode* fork = nullptr;
+		for (
+			HeaderNode* parent = node->GetParent();
+			parent != nullptr;
+			node = parent, parent = node->GetParent()
+		)
+		{
+			if (node->GetIdxInParent() != parent->GetMaxDescChildIdx())
+			{
+				fork = parent;
+			}
+		}
+		return fork;
+	}
+
+	/**
+	 * @brief Find the end of the heaviest branch under the given node, by
+	 *        following the child with the most descendants
+	 *
+	 */
+	static HeaderNode* FindHeaviestLeaf(HeaderNode* node)
+	{
+		while (node->GetNumOfChildren() > 0)
+		{
+			node = node->GetChild(node->GetMaxDescChildIdx());
+		}
+		return node;
+	}
+
+	/**
+	 * @brief Erase the given node and all its descendants from the look up
+	 *        maps
+	 *
+	 */
+	void EraseFromLookUpMaps(HeaderNode* subtreeRoot)
+	{
+		subtreeRoot->ForEachInSubtree(
+			[this](HeaderNode* node)
+			{
+				const auto& hash = node->GetHeader().GetHash();
+				if (!m_offlineNodes.IsEmpty())
+				{
+					m_offlineNodes.Erase(hash);
+				}
+				m_activeNodes.Erase(hash);
+				m_evictionNodes.Erase(hash);
+			}
+		);
+	}
+
+	void ScheduleExpiry(const NodeLookUpKey& hash, HeaderNode* node)
+	{
+		uint64_t expiryTime = Internal::GetPolicy(m_diffChecker).CalcExpiryTime(
+			node->GetHeader()
+		);
+
+		// a new generation invalidates any earlier entry of this node
+		const uint64_t gen = ++m_expiryGen;
+		node->SetExpiryGen(gen);
+
+		// nodes that never expire (e.g., under PoS) are not queued
+		if (expiryTime != std::numeric_limits<uint64_t>::max())
+		{
+			m_expiryQueue.push(ExpiryEntry(expiryTime, gen, hash, node));
+		}
+	}
+
+	/**
+	 * @brief Rebuild the expiry queue once the stale entries, left by nodes
+	 *        that are removed from the active nodes, outnumber the live
+	 *        ones, so the queue stays bounded by the fork tree limits
+	 *
+	 */
+	void CompactExpiryQueue()
+	{
+		static constexpr size_t sk_minQueueSize = 64;
+
+		const size_t maxQueueSize =
+			std::max(m_activeNodes.Size() * 2, sk_minQueueSize);
+		if (m_expiryQueue.size() > maxQueueSize)
+		{
+			RescheduleAllExpiry();
+		}
+	}
+
+	void RescheduleAllExpiry()
+	{
+		m_expiryQueue = ExpiryQueue();
+		m_activeNodes.ForEach(
+			[this](const NodeLookUpKey& hash, HeaderNode* node)
+			{
+				ScheduleExpiry(hash, node);
+			}
+		);
+	}
+
+	bool IsEvictionEnabled() const
+	{
+		return Base::GetMonitorConfig().get_maxLiveNodes().GetVal() != 0;
+	}
+
+	/**
+	 * @brief Queue the given node for eviction with its current number of
+	 *        descendants, if it's the root of a fork branch
+	 *
+	 */
+	void ScheduleEviction(HeaderNode* node)
+	{
+		if (!IsEvictionEnabled() || !IsForkBranch(node))
+		{
+			return;
+		}
+
+		const NodeLookUpKey hash = node->GetHeader().GetHash();
+		m_evictionNodes.InsertOrAssign(hash, node);
+		QueueEviction(hash, node);
+	}
+
+	void QueueEviction(const NodeLookUpKey& hash, HeaderNode* node)
+	{
+		// a new generation invalidates any earlier entry of this node
+		const uint64_t gen = ++m_evictionGen;
+		node->SetEvictionGen(gen);
+
+		const HeaderNode* parent = node->GetParent();
+		m_evictionQueue.push(EvictionEntry(
+			parent->GetNumOfDescOfChild(node->GetIdxInParent()),
+			gen,
+			hash,
+			node
+		));
+	}
+
+	/**
+	 * @brief Queue the fork branches again after the number of descendants
+	 *        of the given node, and so of all its ancestors, has changed.
+	 *        On the way up, the only nodes whose entries are outdated are
+	 *        the path nodes themselves, and the sibling that a path node has
+	 *        just taken over from as the child with the most descendants
+	 *
+	 */
+	void RescheduleEvictionOnPath(HeaderNode* node)
+	{
+		if (!IsEvictionEnabled())
+		{
+			return;
+		}
+
+		for (
+			HeaderNode* parent = node->GetParent();
+			parent != nullptr;
+			node = parent, parent = node->GetParent()
+		)
+		{
+			const size_t idx = node->GetIdxInParent();
+			if (idx != parent->GetMaxDescChildIdx())
+			{
+				ScheduleEviction(node);
+				continue;
+			}
+
+			// descendants are added one at a time, so the sibling taken
+			// over from has exactly one descendant less
+			const size_t numOfDesc = parent->GetNumOfDescOfChild(idx);
+			for (size_t i = 0; i < parent->GetNumOfChildren(); ++i)
+			{
+				if (parent->GetNumOfDescOfChild(i) + 1 == numOfDesc)
+				{
+					ScheduleEviction(parent->GetChild(i));
+				}
+			}
+		}
+
+		CompactEvictionQueue();
+	}
+
+	/**
+	 * @brief Rebuild the eviction queue once the stale entries outnumber
+	 *        the queued nodes, so the queue stays bounded by the fork tree
+	 *        limits
+	 *
+	 */
+	void CompactEvictionQueue()
+	{
+		static constexpr size_t sk_minQueueSize = 64;
+
+		const size_t maxQueueSize =
+			std::max(m_evictionNodes.Size() * 2, sk_minQueueSize);
+		if (m_evictionQueue.size() > maxQueueSize)
+		{
+			m_evictionQueue = EvictionQueue();
+			m_evictionNodes.ForEach(
+				[this](const NodeLookUpKey& hash, HeaderNode* node)
+				{
+					if (IsForkBranch(node))
+					{
+						QueueEviction(hash, node);
+					}
+				}
+			);
+		}
+	}
+
+	template<typename... _Args>
+	static std::unique_ptr<HeaderMgr> ParseHeader(_Args&&... args)
+	{
+		auto start = Metrics::Now();
+		auto header = Internal::Obj::Internal::make_unique<HeaderMgr>(
+			std::forward<_Args>(args)...
+		);
+		Metrics::AddLatency(MetricLatency::HeaderParse, start);
+		return header;
+	}
+
+	bool ValidateHeader(
+		const HeaderMgr& parentHdr,
+		bool isParentLive,
+		const HeaderMgr& currentHdr,
+		bool isCurrentLive
+	) const
+	{
+		auto start = Metrics::Now();
+		bool res = Internal::GetPolicy(m_validator).CommonValidate(
+			parentHdr,
+			isParentLive,
+			currentHdr,
+			isCurrentLive
+		);
+		Metrics::AddLatency(MetricLatency::Validate, start);
+		return res;
+	}
+
+	bool CheckHeaderDifficulty(
+		const HeaderMgr& parentHdr,
+		const HeaderMgr& currentHdr
+	) const
+	{
+		auto start = Metrics::Now();
+		bool res = Internal::GetPolicy(m_diffChecker).CheckDifficulty(
+			parentHdr,
+			currentHdr
+		);
+		Metrics::AddLatency(MetricLatency::DiffCheck, start);
+		return res;
+	}
 
+	void NotifyHeaderValidated(const HeaderMgr& header) const
+	{
+		auto start = Metrics::Now();
+		m_onHeaderValidated(header);
+		Metrics::AddLatency(MetricLatency::HeaderCallback, start);
+	}
 
-}; // class EclipseMonitor
+	void NotifyHeaderConfirmed(const HeaderMgr& header) const
+	{
+		auto start = Metrics::Now();
+		m_onHeaderConfirmed(header);
+		Metrics::AddLatency(MetricLatency::HeaderCallback, start);
+	}
+
+	void RecordUpdateMetrics(
+		Phases phase,
+		const typename Metrics::TimePoint& start
+	) const
+	{
+		switch (phase)
+		{
+		case Phases::BootstrapI:
+			Metrics::AddCount(MetricCounter::UpdateBootstrapI);
+			Metrics::AddLatency(MetricLatency::UpdateBootstrapI, start);
+			break;
+		case Phases::BootstrapII:
+			Metrics::AddCount(MetricCounter::UpdateBootstrapII);
+			Metrics::AddLatency(MetricLatency::UpdateBootstrapII, start);
+			break;
+		case Phases::Sync:
+			Metrics::AddCount(MetricCounter::UpdateSync);
+			Metrics::AddLatency(MetricLatency::UpdateSync, start);
+			break;
+		case Phases::Runtime:
+		default:
+			Metrics::AddCount(MetricCounter::UpdateRuntime);
+			Metrics::AddLatency(MetricLatency::UpdateRuntime, start);
+			break;
+		}
+
+		if (Metrics::sk_isEnabled && (phase != Phases::BootstrapI))
+		{
+			Metrics::SetGauge(
+				MetricGauge::NumOfActiveNodes,
+				m_activeNodes.Size()
+			);
+			Metrics::SetGauge(
+				MetricGauge::NumOfOfflineNodes,
+				m_offlineNodes.Size()
+			);
+			Metrics::SetGauge(
+				MetricGauge::NumOfForkTreeNodes,
+				m_checkpoint.GetLastNode().GetNumOfDesc() + 1
+			);
+		}
+	}
+
+	/**
+	 * @brief Build a new status from the current state, and publish it to
+	 *        the readers of `GetStatus`, if it differs from the published one
+	 *
+	 */
+	void PublishStatus()
+	{
+		const auto& secState = Base::GetMonitorSecState();
+
+		const uint64_t chkptIter = secState.get_checkpointIter().GetVal();
+		BlockNumber chkptNum = 0;
+		MonitorStatus::HashType chkptHash = {{ 0 }};
+		if (chkptIter > 0)
+		{
+			chkptNum = BlkNumTypeTrait::FromBytes(secState.get_checkpointNum());
+			const auto& hashBytes = secState.get_checkpointHash();
+			if (hashBytes.size() == chkptHash.size())
+			{
+				std::copy(hashBytes.begin(), hashBytes.end(), chkptHash.begin());
+			}
+		}
+
+		// the best tip
+		const HeaderMgr* tipHeader = nullptr;
+		if (Base::GetPhase() != Phases::BootstrapI)
+		{
+			tipHeader = &(m_bestTip->GetHeader());
+		}
+		else if (!m_checkpoint.IsEmpty())
+		{
+			tipHeader = &(m_checkpoint.GetLastHeader());
+		}
+		MonitorStatus::HashType tipHash = {{ 0 }};
+		if (tipHeader != nullptr)
+		{
+			tipHash = tipHeader->GetHash();
+		}
+
+		const MonitorStatus status(
+			Base::GetPhase(),
+			chkptIter,
+			chkptNum,
+			chkptHash,
+			tipHeader != nullptr,
+			(tipHeader != nullptr) ? tipHeader->GetNumber() : 0,
+			tipHash,
+			m_syncMsgMgr.GetLastSyncState()->IsSynced(),
+			m_activeNodes.Size(),
+			m_offlineNodes.Size()
+		);
+		if ((m_publishedStatus != nullptr) && (*m_publishedStatus == status))
+		{
+			return;
+		}
+
+		std::shared_ptr<const MonitorStatus> published =
+			std::make_shared<MonitorStatus>(status);
+		m_publishedStatus = published.get();
+
+#if defined(__cpp_lib_atomic_shared_ptr) && __cpp_lib_atomic_shared_ptr != 0
+		m_status.store(std::move(published));
+#else // defined(__cpp_lib_atomic_shared_ptr) && __cpp_lib_atomic_shared_ptr != 0
+		std::atomic_store(&m_status, std::move(published));
+#endif // defined(__cpp_lib_atomic_shared_ptr) && __cpp_lib_atomic_shared_ptr != 0
+	}
+
+	void RestoreSnapshot(
+		const std::vector<uint8_t>& snapshot,
+		const SnapshotHashType& trustedSnapshotHash
+	)
+	{
+		// 1. verify the integrity of the snapshot
+		SnapshotHashType hash;
+		const std::vector<uint8_t> payloadBin = VerifySnapshot(snapshot, hash);
+		if (trustedSnapshotHash != hash)
+		{
+			throw Exception("The snapshot does not match the trusted hash");
+		}
+
+		const Internal::Obj::Object payloadObj =
+			Internal::Rlp::GeneralParser().Parse(payloadBin);
+		const auto& payload = payloadObj.AsList();
+		if (payload.size() != 8)
+		{
+			throw Exception("Invalid snapshot");
+		}
+		if (
+			PrimitiveTypeTrait<uint8_t>::FromBytes(payload[0].AsBytes()) !=
+				sk_snapshotVersion
+		)
+		{
+			throw Exception("Unsupported snapshot version");
+		}
+
+		// 2. the snapshot must be taken with the same configuration
+		const auto& confBin = payload[1].AsBytes();
+		if (
+			std::vector<uint8_t>(confBin.data(), confBin.data() + confBin.size()) !=
+				Internal::AdvRlp::GenericWriter::Write(Base::GetMonitorConfig())
+		)
+		{
+			throw Exception(
+				"The snapshot was taken with a different configuration");
+		}
+
+		// 3. restore the monitor state
+		const auto& secStateBin = payload[2].AsBytes();
+		Base::GetMonitorSecState() = MonitorSecStateParser().Parse(
+			std::vector<uint8_t>(
+				secStateBin.data(),
+				secStateBin.data() + secStateBin.size()
+			)
+		);
+
+		const uint8_t phase =
+			PrimitiveTypeTrait<uint8_t>::FromBytes(payload[3].AsBytes());
+		if (phase > static_cast<uint8_t>(Phases::Runtime))
+		{
+			throw Exception("Invalid snapshot");
+		}
+
+		m_startBlockNum = BlkNumTypeTrait::FromBytes(payload[4].AsBytes());
+		m_bootstrapIEndBlkNum = BlkNumTypeTrait::FromBytes(payload[5].AsBytes());
+		m_planedSyncBlkNum = BlkNumTypeTrait::FromBytes(payload[6].AsBytes());
+
+		m_checkpoint.RestoreFromSnapshot(
+			payload[7].AsList(),
+			m_syncMsgMgr.GetLastSyncState()
+		);
+
+		// 4. nodes in the fork tree can't be trusted as active nodes until
+		//    this monitor instance is synced
+		if (phase != static_cast<uint8_t>(Phases::BootstrapI))
+		{
+			m_checkpoint.GetLastNodePtr()->ForEachInSubtree(
+				[this](HeaderNode* node)
+				{
+					m_offlineNodes.InsertOrAssign(
+						node->GetHeader().GetHash(),
+						node
+					);
+					ScheduleEviction(node);
+				}
+			);
+			m_bestTip = FindHeaviestLeaf(m_checkpoint.GetLastNodePtr());
+			Base::EndBootstrapI();
+			m_isSyncPlanRestored = true;
+		}
+
+		// 5. update the difficulty checker, if there is a checkpoint
+		if (Base::GetMonitorSecState().get_checkpointIter().GetVal() > 0)
+		{
+			Internal::GetPolicy(m_diffChecker).OnChkptUpd(m_checkpoint);
+		}
+
+		using namespace Internal::Obj::Codec;
+		Base::GetLogger().Info([&]()
+		{
+			return "Restored from snapshot " + Hex::Encode<std::string>(hash);
+		});
+	}
+
+	/**
+	 * @brief Verify the snapshot against its embedded hash
+	 *
+	 * @return the encoded state in the snapshot
+	 */
+	static std::vector<uint8_t> VerifySnapshot(
+		const std::vector<uint8_t>& snapshot,
+		SnapshotHashType& outHash
+	)
+	{
+		const Internal::Obj::Object snapshotObj =
+			Internal::Rlp::GeneralParser().Parse(snapshot);
+		const auto& snapshotList = snapshotObj.AsList();
+		if (snapshotList.size() != 2)
+		{
+			throw Exception("Invalid snapshot");
+		}
+
+		const auto& payloadBytes = snapshotList[0].AsBytes();
+		const auto& hashBytes = snapshotList[1].AsBytes();
+		std::vector<uint8_t> payloadBin(
+			payloadBytes.data(),
+			payloadBytes.data() + payloadBytes.size()
+		);
+
+		SnapshotHashType embeddedHash;
+		if (hashBytes.size() != embeddedHash.size())
+		{
+			throw Exception("Invalid snapshot");
+		}
+		std::copy(
+			hashBytes.data(),
+			hashBytes.data() + embeddedHash.size(),
+			embeddedHash.begin()
+		);
+
+		outHash = Keccak256(payloadBin);
+		if (outHash != embeddedHash)
+		{
+			throw Exception("The snapshot is corrupted");
+		}
+
+		return payloadBin;
+	}
+
+	static bool ToNodeLookUpKey(
+		const Internal::Obj::BytesBaseObj& hashBytes,
+		NodeLookUpKey& key
+	)
+	{
+		if (hashBytes.size() != key.size())
+		{
+			return false;
+		}
+		std::copy(hashBytes.data(), hashBytes.data() + key.size(), key.begin());
+		return true;
+	}
+
+	/**
+	 * @brief `startBlk` and `chkptSize` should be constant, so the plan for
+	 *        when to end bootstrap I phase should solely depend on `latestBlk`
+	 */
+	static uint64_t CalcBootstrapIEndBlkNum(
+		uint64_t latestBlk,
+		uint64_t startBlk,
+		uint64_t chkptSize
+	)
+	{
+		uint64_t numOfBlocks = latestBlk - startBlk + 1;
+		uint64_t numOfInterval = numOfBlocks / chkptSize;
+		numOfInterval = (numOfInterval > 2) ? numOfInterval - 2 : 0;
+		uint64_t endBlkNum = startBlk + (numOfInterval * chkptSize);
+
+		return endBlkNum - 1;
+	}
+
+private: // static members:
+
+	struct ExpiryEntry
+	{
+		ExpiryEntry(
+			uint64_t expiryTime,
+			uint64_t gen,
+			const NodeLookUpKey& hash,
+			HeaderNode* node
+		) :
+			m_expiryTime(expiryTime),
+			m_gen(gen),
+			m_hash(hash),
+			m_node(node)
+		{}
+
+		bool operator>(const ExpiryEntry& other) const
+		{
+			return m_expiryTime > other.m_expiryTime;
+		}
+
+		uint64_t m_expiryTime;
+		uint64_t m_gen;
+		NodeLookUpKey m_hash;
+		HeaderNode* m_node;
+	}; // struct ExpiryEntry
+
+	/**
+	 * @brief Min-heap of active nodes ordered by their expiry time,
+	 *        so only the nodes that are actually expired are visited during
+	 *        the maintenance.
+	 *        Entries are not removed when their nodes leave the active
+	 *        nodes for other reasons; they are discarded when they are
+	 *        popped, or when the queue is rebuilt
+	 *
+	 */
+	using ExpiryQueue = std::priority_queue<
+		ExpiryEntry,
+		std::vector<ExpiryEntry>,
+		std::greater<ExpiryEntry>
+	>;
+
+	struct EvictionEntry
+	{
+		EvictionEntry(
+			size_t numOfDesc,
+			uint64_t gen,
+			const NodeLookUpKey& hash,
+			HeaderNode* node
+		) :
+			m_numOfDesc(numOfDesc),
+			m_gen(gen),
+			m_hash(hash),
+			m_node(node)
+		{}
+
+		bool operator>(const EvictionEntry& other) const
+		{
+			// ties go to the branch queued earlier
+			return (m_numOfDesc > other.m_numOfDesc) ||
+				(
+					(m_numOfDesc == other.m_numOfDesc) &&
+					(m_gen > other.m_gen)
+				);
+		}
+
+		size_t m_numOfDesc;
+		uint64_t m_gen;
+		NodeLookUpKey m_hash;
+		HeaderNode* m_node;
+	}; // struct EvictionEntry
+
+	/**
+	 * @brief Min-heap of fork branches ordered by their number of
+	 *        descendants, so the lightest branch can be evicted without
+	 *        searching the fork tree.
+	 *        A branch is queued again whenever its number of descendants
+	 *        changes, and the earlier entries become stale; they are
+	 *        discarded when they are popped, or when the queue is rebuilt
+	 *
+	 */
+	using EvictionQueue = std::priority_queue<
+		EvictionEntry,
+		std::vector<EvictionEntry>,
+		std::greater<EvictionEntry>
+	>;
+
+private:
+
+	OnHeaderConfCallback m_onHeaderValidated;
+	OnHeaderConfCallback m_onHeaderConfirmed;
+	OnHeadersConfCallback m_onHeadersConfirmed;
+	// reused for every checkpoint, so the batch doesn't allocate
+	std::vector<HeaderSummary> m_confirmedBatch;
+
+	CheckpointMgr m_checkpoint;
+	ValidatorType m_validator;
+	DiffCheckerType m_diffChecker;
+
+	std::shared_ptr<EventManager> m_eventManager;
+	SyncMsgMgr m_syncMsgMgr;
+
+	// runtime & forks
+	// TODO sync manager
+	NodeLookUpMap m_offlineNodes;
+	NodeLookUpMap m_activeNodes;
+	ExpiryQueue m_expiryQueue;
+	// generation of the latest scheduled expiry
+	uint64_t m_expiryGen;
+	// nodes in the fork tree that have been queued for eviction
+	NodeLookUpMap m_evictionNodes;
+	EvictionQueue m_evictionQueue;
+	// generation of the latest queued eviction
+	uint64_t m_evictionGen;
+	// reused for every eviction, so making room doesn't allocate
+	std::vector<EvictionEntry> m_skippedEvictions;
+
+	BlockNumber m_startBlockNum;
+	BlockNumber m_bootstrapIEndBlkNum;
+	BlockNumber m_planedSyncBlkNum;
+	// the planed sync block was restored from a snapshot, and it may have
+	// been passed while the monitor was offline
+	bool m_isSyncPlanRestored;
+
+	// end of the heaviest branch in the fork tree, which is kept up to date
+	// as nodes are added and removed; only valid after the bootstrap I phase
+	HeaderNode* m_bestTip;
+	AtomicStatusType m_status;
+	// the status in `m_status`; it's only replaced by this monitor, so it
+	// can be read here without an atomic load
+	const MonitorStatus* m_publishedStatus;
+
+}; // class BasicEclipseMonitor
+
+
+template<typename _ValidatorType, typename _DiffCheckerType>
+constexpr size_t
+BasicEclipseMonitor<_ValidatorType, _DiffCheckerType>::sk_batchChunkSize;
+
+template<typename _ValidatorType, typename _DiffCheckerType>
+constexpr uint8_t
+BasicEclipseMonitor<_ValidatorType, _DiffCheckerType>::sk_snapshotVersion;
+
+
+/**
+ * @brief The eclipse monitor whose validator and difficulty checker are
+ *        chosen at runtime
+ *
+ */
+using EclipseMonitor = BasicEclipseMonitor<
+	std::unique_ptr<ValidatorBase>,
+	std::unique_ptr<DiffCheckerBase>
+>;
 
 
 } // namespace Eth
@@ -6,18 +6,24 @@
 #pragma once
 
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "../Internal/FixedKeyFlatMap.hpp"
 #include "../Internal/SimpleObj.hpp"
 #include "../Logging.hpp"
+#include "../Metrics.hpp"
 
 #include "DataTypes.hpp"
 #include "EventDescription.hpp"
 #include "Receipt.hpp"
 #include "ReceiptsMgr.hpp"
+#include "TransactionsMgr.hpp"
+#include "TxnCallDescription.hpp"
 
 
 namespace EclipseMonitor
@@ -49,11 +55,52 @@ public: // static members:
 			std::vector<LogEntriesKRefType>
 		>;
 
+	using TxnCallDescMap =
+		std::unordered_map<
+			EventCallbackId,
+			std::unique_ptr<TxnCallDescription>
+		>;
+	using TxnCallIdList = std::vector<EventCallbackId>;
+	/**
+	 * @brief Index from (selector, contract address) to the subscriptions;
+	 *        the selector comes first, so the leading bytes used as the
+	 *        hash value differ between functions of the same contract
+	 *
+	 */
+	using TxnCallIndex =
+		Internal::FixedKeyFlatMap<
+			std::tuple_size<FuncSelector>::value +
+				std::tuple_size<ContractAddr>::value,
+			TxnCallIdList
+		>;
+	using TxnCallKey = typename TxnCallIndex::KeyType;
+	/**
+	 * @brief Index from contract address to the subscriptions to any
+	 *        function of the contract
+	 *
+	 */
+	using TxnAddrIndex =
+		Internal::FixedKeyFlatMap<
+			std::tuple_size<ContractAddr>::value,
+			TxnCallIdList
+		>;
+	using TxnCallPlan =
+		std::pair<
+			std::pair<
+				EventCallbackId,
+				typename TxnCallDescription::NotifyCallbackType
+			>,
+			TransactionView
+		>;
+
 public:
 
 	EventManager() :
 		m_eventDescMapMutex(),
 		m_eventDescMap(),
+		m_txnCallDescMap(),
+		m_txnCallIndex(),
+		m_txnAddrIndex(),
 		m_logger(LoggerFactory::GetLogger("EventManager"))
 	{}
 
@@ -83,6 +130,13 @@ public:
 		{
 			m_eventDescMap.erase(it);
 		}
+
+		auto txnIt = m_txnCallDescMap.find(id);
+		if (txnIt != m_txnCallDescMap.end())
+		{
+			UnindexTxnCall_Locked(*(txnIt->second), id);
+			m_txnCallDescMap.erase(txnIt);
+		}
 	}
 
 	size_t GetNumOfListeners() const
@@ -92,6 +146,36 @@ public:
 		return m_eventDescMap.size();
 	}
 
+	/**
+	 * @brief Subscribe to the transactions calling a contract; the
+	 *        subscription can be cancelled by `Cancel`
+	 *
+	 */
+	EventCallbackId ListenTxnCalls(TxnCallDescription&& callDesc)
+	{
+		std::lock_guard<std::mutex> lock(m_eventDescMapMutex);
+
+		std::unique_ptr<TxnCallDescription> callDescPtr =
+			Internal::Obj::Internal::make_unique<TxnCallDescription>(
+				std::move(callDesc)
+			);
+		EventCallbackId id =
+			reinterpret_cast<EventCallbackId>(callDescPtr.get());
+
+		TxnCallIdList* ids = FindTxnCallIds_Locked(*callDescPtr, true);
+		ids->push_back(id);
+		m_txnCallDescMap.emplace(id, std::move(callDescPtr));
+
+		return id;
+	}
+
+	size_t GetNumOfTxnListeners() const
+	{
+		std::lock_guard<std::mutex> lock(m_eventDescMapMutex);
+
+		return m_txnCallDescMap.size();
+	}
+
 	template<typename _ReceiptsMgrGetter>
 	void CheckEvents(
 		const HeaderMgr& headerMgr,
@@ -119,22 +203,32 @@ public:
 			{
 				return;
 			}
+			Metrics::AddCount(
+				MetricCounter::BloomPositive,
+				bloomedEvents.size()
+			);
 
 
-			m_logger.Debug(
-				"Found " + std::to_string(bloomedEvents.size()) +
-				" positives in bloom filter at block #" +
-				std::to_string(headerMgr.GetNumber())
-			);
+			m_logger.Debug([&]()
+			{
+				return "Found " + std::to_string(bloomedEvents.size()) +
+					" positives in bloom filter at block #" +
+					std::to_string(headerMgr.GetNumber());
+			});
 
 
 			// otherwise, check the receipt root, and check the receipt logs
 			// we must verify the receipt root first, because we also want to
 			// ensure if the event is not found in the receipt, it is really
 			// not there.
+			auto fetchStart = Metrics::Now();
+			auto&& receipts = receiptsMgrGetter(headerMgr.GetNumber());
+			Metrics::AddLatency(MetricLatency::ReceiptsFetch, fetchStart);
+
+			auto verifyStart = Metrics::Now();
 			receiptsMgr =
 				Internal::Obj::Internal::make_unique<ReceiptsMgr>(
-					receiptsMgrGetter(headerMgr.GetNumber())
+					std::forward<decltype(receipts)>(receipts)
 				);
 			if (
 				receiptsMgr->GetRootHashBytes() !=
@@ -143,6 +237,7 @@ public:
 			{
 				throw Exception("Receipts root mismatch");
 			}
+			Metrics::AddLatency(MetricLatency::ReceiptsVerify, verifyStart);
 
 
 			// search through the receipt managers
@@ -151,6 +246,10 @@ public:
 				bloomedEvents,
 				m_logger
 			);
+			Metrics::AddCount(
+				MetricCounter::ReceiptMatch,
+				callbackPlans.size()
+			);
 		}
 
 		// Now we've finished searching through the receipt managers
@@ -159,8 +258,244 @@ public:
 		ConductCallbackPlan(headerMgr, callbackPlans);
 	}
 
+	/**
+	 * @brief Check the transactions of the given block against the
+	 *        transaction call subscriptions.
+	 *        The transactions are only fetched if there is any subscription,
+	 *        and they are verified against the transactions root before any
+	 *        of them is matched. Transactions are decoded lazily, and each
+	 *        of them is matched by a single lookup of its (selector, `to`)
+	 *        pair in the subscription index, plus one lookup of its `to`
+	 *        address if there is any subscription to all functions.
+	 *
+	 * @param txnsGetter The function that takes the block number, and returns
+	 *                   the list of transaction binaries of the block (e.g.,
+	 *                   an `Internal::Obj::List`, or a reference to an
+	 *                   `Internal::Obj::ListBaseObj`)
+	 */
+	template<typename _TxnsGetter>
+	void CheckTxnCalls(
+		const HeaderMgr& headerMgr,
+		_TxnsGetter txnsGetter
+	) const
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_eventDescMapMutex);
+			if (m_txnCallDescMap.empty())
+			{
+				return;
+			}
+		}
+
+		// The transaction views in the callback plans refer to the binaries
+		// in `txns`, so it must be alive until all callbacks are done
+		auto fetchStart = Metrics::Now();
+		auto&& txns = txnsGetter(headerMgr.GetNumber());
+		Metrics::AddLatency(MetricLatency::TxnsFetch, fetchStart);
+
+		auto verifyStart = Metrics::Now();
+		TransactionsMgr txnsMgr(txns, true);
+		if (
+			txnsMgr.GetRootHashBytes() !=
+			headerMgr.GetRawHeader().get_TransactionsRoot()
+		)
+		{
+			throw Exception("Transactions root mismatch");
+		}
+		Metrics::AddLatency(MetricLatency::TxnsVerify, verifyStart);
+
+		std::vector<TxnCallPlan> callbackPlans;
+		{
+			std::lock_guard<std::mutex> lock(m_eventDescMapMutex);
+
+			callbackPlans = GenTxnCallPlan_Locked(txnsMgr);
+			Metrics::AddCount(
+				MetricCounter::TxnCallMatch,
+				callbackPlans.size()
+			);
+		}
+
+		m_logger.Debug([&]()
+		{
+			return "Found " + std::to_string(callbackPlans.size()) +
+				" matched transaction calls at block #" +
+				std::to_string(headerMgr.GetNumber());
+		});
+
+		ConductTxnCallPlan(headerMgr, callbackPlans);
+	}
+
 private: // helper functions
 
+	static TxnCallKey MakeTxnCallKey(
+		const FuncSelector& selector,
+		const uint8_t* contractAddr
+	)
+	{
+		TxnCallKey key;
+		auto it = std::copy(selector.begin(), selector.end(), key.begin());
+		std::copy(
+			contractAddr,
+			contractAddr + std::tuple_size<ContractAddr>::value,
+			it
+		);
+		return key;
+	}
+
+	TxnCallIdList* FindTxnCallIds_Locked(
+		const TxnCallDescription& callDesc,
+		bool isCreating
+	)
+	{
+		if (callDesc.m_hasSelector)
+		{
+			TxnCallKey key = MakeTxnCallKey(
+				callDesc.m_selector,
+				callDesc.m_contractAddr.data()
+			);
+			if (isCreating)
+			{
+				m_txnCallIndex.Insert(key, TxnCallIdList());
+			}
+			return m_txnCallIndex.Find(key);
+		}
+		else
+		{
+			if (isCreating)
+			{
+				m_txnAddrIndex.Insert(callDesc.m_contractAddr, TxnCallIdList());
+			}
+			return m_txnAddrIndex.Find(callDesc.m_contractAddr);
+		}
+	}
+
+	void UnindexTxnCall_Locked(
+		const TxnCallDescription& callDesc,
+		EventCallbackId id
+	)
+	{
+		TxnCallIdList* ids = FindTxnCallIds_Locked(callDesc, false);
+		if (ids == nullptr)
+		{
+			return;
+		}
+
+		ids->erase(std::remove(ids->begin(), ids->end(), id), ids->end());
+		if (ids->empty())
+		{
+			if (callDesc.m_hasSelector)
+			{
+				m_txnCallIndex.Erase(
+					MakeTxnCallKey(
+						callDesc.m_selector,
+						callDesc.m_contractAddr.data()
+					)
+				);
+			}
+			else
+			{
+				m_txnAddrIndex.Erase(callDesc.m_contractAddr);
+			}
+		}
+	}
+
+	void AddTxnCallPlans_Locked(
+		std::vector<TxnCallPlan>& plans,
+		const TxnCallIdList* ids,
+		const TransactionView& txn
+	) const
+	{
+		if (ids == nullptr)
+		{
+			return;
+		}
+		for (const auto& id : *ids)
+		{
+			plans.emplace_back(
+				std::make_pair(
+					id,
+					m_txnCallDescMap.at(id)->m_notifyCallback
+				),
+				txn
+			);
+		}
+	}
+
+	std::vector<TxnCallPlan> GenTxnCallPlan_Locked(
+		const TransactionsMgr& txnsMgr
+	) const
+	{
+		static constexpr size_t sk_addrSize =
+			std::tuple_size<ContractAddr>::value;
+		static constexpr size_t sk_selectorSize =
+			std::tuple_size<FuncSelector>::value;
+
+		std::vector<TxnCallPlan> plans;
+
+		for (size_t i = 0; i < txnsMgr.GetNumOfTransactions(); ++i)
+		{
+			// transaction types introduced after this implementation can't
+			// be decoded, but they shouldn't stop other transactions in
+			// the block from being checked
+			if (!txnsMgr.IsTransactionSupported(i))
+			{
+				continue;
+			}
+			TransactionView txn = txnsMgr.GetTransactionView(i);
+
+			// contract creations have no `to` address
+			auto to = txn.GetContractAddr();
+			if (to.GetPayloadSize() != sk_addrSize)
+			{
+				continue;
+			}
+
+			auto data = txn.GetContactParams();
+			if (data.GetPayloadSize() >= sk_selectorSize)
+			{
+				FuncSelector selector;
+				std::copy(
+					data.GetPayload(),
+					data.GetPayload() + sk_selectorSize,
+					selector.begin()
+				);
+				AddTxnCallPlans_Locked(
+					plans,
+					m_txnCallIndex.Find(
+						MakeTxnCallKey(selector, to.GetPayload())
+					),
+					txn
+				);
+			}
+
+			if (!m_txnAddrIndex.IsEmpty())
+			{
+				ContractAddr addr;
+				std::copy(
+					to.GetPayload(),
+					to.GetPayload() + sk_addrSize,
+					addr.begin()
+				);
+				AddTxnCallPlans_Locked(plans, m_txnAddrIndex.Find(addr), txn);
+			}
+		}
+
+		return plans;
+	}
+
+	static void ConductTxnCallPlan(
+		const HeaderMgr& hdrMgr,
+		const std::vector<TxnCallPlan>& plans
+	)
+	{
+		for (const auto& plan : plans)
+		{
+			auto start = Metrics::Now();
+			plan.first.second(hdrMgr, plan.second, plan.first.first);
+			Metrics::AddLatency(MetricLatency::EventCallback, start);
+		}
+	}
+
 	std::vector<EventDescKIt> BloomEventDesc_Locked(
 		const BloomFilter& bloom
 	) const
@@ -204,10 +539,11 @@ private: // helper functions
 			);
 			if (!logKRefs.empty())
 			{
-				logger.Debug(
-					"Found " + std::to_string(logKRefs.size()) +
-					" events in current receipt"
-				);
+				logger.Debug([&]()
+				{
+					return "Found " + std::to_string(logKRefs.size()) +
+						" events in current receipt";
+				});
 				plans.emplace_back(
 					std::make_pair(
 						bloomedEvent->first,
@@ -232,7 +568,9 @@ private: // helper functions
 			const auto& callback = plan.first.second;
 			for (const auto& logKRef : plan.second)
 			{
+				auto start = Metrics::Now();
 				callback(hdrMgr, logKRef, id);
+				Metrics::AddLatency(MetricLatency::EventCallback, start);
 			}
 		}
 	}
@@ -241,6 +579,9 @@ private:
 
 	mutable std::mutex  m_eventDescMapMutex;
 	EventDescrpMap      m_eventDescMap;
+	TxnCallDescMap      m_txnCallDescMap;
+	TxnCallIndex        m_txnCallIndex;
+	TxnAddrIndex        m_txnAddrIndex;
 	Logger              m_logger;
 }; // class EventManager
 
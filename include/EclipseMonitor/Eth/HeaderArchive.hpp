@@ -0,0 +1,611 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <utility>
+
+#include "../Exceptions.hpp"
+#include "../Internal/MappedFile.hpp"
+
+#include "DataTypes.hpp"
+#include "HeaderMgr.hpp"
+#include "HeaderSummary.hpp"
+
+
+namespace EclipseMonitor
+{
+namespace Eth
+{
+
+
+/**
+ * @brief An append-only archive of confirmed headers, kept in two
+ *        memory-mapped files, so looking up a confirmed header is a local
+ *        read that doesn't keep the archive in the resident memory:
+ *        - `<path>.rec` stores fixed-size header summaries in block number
+ *          order, so the record of a block number is found by its offset
+ *          from the first block number;
+ *        - `<path>.idx` is an open-addressing hash table from block hashes
+ *          to record indices.
+ *        The headers must be appended in the order of block numbers without
+ *        gaps; feeding it from the header confirmed callback of the monitor
+ *        gives exactly that order.
+ *        Numbers in both files are stored in little-endian.
+ *        The counts of records and indexed records are published with
+ *        release stores after the data they cover is written, and an index
+ *        that needs to grow is built in a new file, which then replaces the
+ *        old one with `rename`; so a reader in another process never sees
+ *        a half-built index, and neither does a writer that restarts after
+ *        being interrupted.
+ *        This header is only meant for the host side, since it requires
+ *        POSIX file and memory-mapping APIs (see `Internal::MappedFile`).
+ *
+ */
+class HeaderArchive
+{
+public: // static members:
+
+	using HashType = HeaderSummary::HashType;
+
+	static constexpr size_t sk_recordSize = 96;
+	static constexpr size_t sk_recFileHeaderSize = 32;
+	static constexpr size_t sk_idxFileHeaderSize = 16;
+	static constexpr size_t sk_minNumOfRecords = 1024;
+	static constexpr size_t sk_minIdxCapacity = 1024;
+
+public:
+
+	/**
+	 * @brief Open an archive, or create an empty one if it doesn't exist
+	 *        and it's not read-only
+	 *
+	 * @param path       The path prefix of the archive files
+	 * @param isReadOnly Whether the archive is opened read-only; a read-only
+	 *                   archive can be opened while another process is
+	 *                   appending to it, and `Refresh` picks up the new
+	 *                   headers; until then, the new headers may not be
+	 *                   found by their hashes
+	 */
+	explicit HeaderArchive(const std::string& path, bool isReadOnly = false) :
+		m_records(path + ".rec", isReadOnly),
+		m_index(path + ".idx", isReadOnly)
+	{
+		InitRecordFile();
+		InitIndexFile();
+		if (!isReadOnly)
+		{
+			// the index may fall behind the records if the process was
+			// interrupted in the middle of an append
+			IndexRecords(GetNumOfIndexed(), GetNumOfRecords());
+		}
+	}
+
+	HeaderArchive(const HeaderArchive&) = delete;
+
+	HeaderArchive& operator=(const HeaderArchive&) = delete;
+
+	// LCOV_EXCL_START
+	~HeaderArchive() = default;
+	// LCOV_EXCL_STOP
+
+	size_t GetNumOfRecords() const
+	{
+		// a reader may see a count larger than its mapping, if the file
+		// has grown since it was mapped
+		size_t numOfMapped =
+			(m_records.GetSize() - sk_recFileHeaderSize) / sk_recordSize;
+		return std::min(
+			static_cast<size_t>(
+				LoadCount(m_records.GetData() + sk_recCountOffset)
+			),
+			numOfMapped
+		);
+	}
+
+	bool IsEmpty() const
+	{
+		return GetNumOfRecords() == 0;
+	}
+
+	BlockNumber GetFirstNumber() const
+	{
+		if (IsEmpty())
+		{
+			throw Exception("The header archive is empty");
+		}
+		return ReadU64(GetRecord(0) + sk_numberOffset);
+	}
+
+	BlockNumber GetLastNumber() const
+	{
+		return GetFirstNumber() + GetNumOfRecords() - 1;
+	}
+
+	/**
+	 * @brief Append a confirmed header to the archive; it can be used as
+	 *        the header confirmed callback of the monitor directly
+	 *
+	 */
+	void Append(const HeaderMgr& header)
+	{
+		Append(HeaderSummary::FromHeader(header));
+	}
+
+	/**
+	 * @brief Append the summary of a confirmed header to the archive.
+	 *        A header that is already in the archive is ignored, so
+	 *        confirmed headers replayed after a restart can be appended
+	 *        again.
+	 *
+	 */
+	void Append(const HeaderSummary& summary)
+	{
+		if (m_records.IsReadOnly())
+		{
+			throw Exception("The header archive is read-only");
+		}
+
+		const size_t numOfRecords = GetNumOfRecords();
+		if (numOfRecords != 0)
+		{
+			const BlockNumber firstNum = GetFirstNumber();
+			const BlockNumber lastNum = GetLastNumber();
+			if ((summary.GetNumber() >= firstNum) &&
+				(summary.GetNumber() <= lastNum))
+			{
+				const uint8_t* rec = GetRecord(
+					static_cast<size_t>(summary.GetNumber() - firstNum)
+				);
+				if (!IsHashEqual(rec + sk_hashOffset, summary.GetHash()))
+				{
+					throw Exception("The header conflicts with the one in "
+						"the archive");
+				}
+				return;
+			}
+			if (summary.GetNumber() != lastNum + 1)
+			{
+				throw Exception("The headers in the archive must be "
+					"continuous");
+			}
+		}
+
+		// 1. write the record
+		const size_t recEnd =
+			sk_recFileHeaderSize + ((numOfRecords + 1) * sk_recordSize);
+		if (recEnd > m_records.GetSize())
+		{
+			m_records.Resize(
+				sk_recFileHeaderSize + (numOfRecords * 2 * sk_recordSize)
+			);
+		}
+		WriteRecord(GetRecord(numOfRecords), summary);
+
+		// 2. publish the record
+		StoreCount(m_records.GetData() + sk_recCountOffset, numOfRecords + 1);
+
+		// 3. index the record
+		IndexRecords(numOfRecords, numOfRecords + 1);
+	}
+
+	/**
+	 * @brief Append a batch of confirmed header summaries, in the order of
+	 *        block numbers; it matches the batch confirmed callback of the
+	 *        monitor (see `EclipseMonitor::SetOnHeadersConfirmed`)
+	 *
+	 */
+	void Append(
+		const std::pair<BlockNumber, BlockNumber>&,
+		const HeaderSummary* summaries,
+		size_t numOfSummaries
+	)
+	{
+		for (size_t i = 0; i < numOfSummaries; ++i)
+		{
+			Append(summaries[i]);
+		}
+	}
+
+	/**
+	 * @brief Find the confirmed header with the given block number
+	 *
+	 * @return true if the header is found, and `summary` is set to it
+	 */
+	bool FindByNumber(BlockNumber number, HeaderSummary& summary) const
+	{
+		if (IsEmpty() ||
+			(number < GetFirstNumber()) ||
+			(number > GetLastNumber()))
+		{
+			return false;
+		}
+		summary = ReadRecord(
+			GetRecord(static_cast<size_t>(number - GetFirstNumber()))
+		);
+		return true;
+	}
+
+	/**
+	 * @brief Find the confirmed header with the given block hash
+	 *
+	 * @return true if the header is found, and `summary` is set to it
+	 */
+	bool FindByHash(const HashType& hash, HeaderSummary& summary) const
+	{
+		const size_t numOfRecords = GetNumOfRecords();
+		const size_t mask = GetIdxCapacity() - 1;
+		for (
+			size_t pos = HomeIndex(hash.data(), mask);
+			GetSlot(pos) != 0;
+			pos = (pos + 1) & mask
+		)
+		{
+			size_t recIdx = static_cast<size_t>(GetSlot(pos) - 1);
+			if ((recIdx < numOfRecords) &&
+				IsHashEqual(GetRecord(recIdx) + sk_hashOffset, hash))
+			{
+				summary = ReadRecord(GetRecord(recIdx));
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Check if the block with the given number and hash has been
+	 *        confirmed
+	 *
+	 */
+	bool IsConfirmed(BlockNumber number, const HashType& hash) const
+	{
+		HeaderSummary summary;
+		return FindByNumber(number, summary) && (summary.GetHash() == hash);
+	}
+
+	/**
+	 * @brief Map the files again if they have grown or been replaced since
+	 *        they were mapped; this is only needed by a reader while
+	 *        another process is appending to the archive
+	 *
+	 */
+	void Refresh()
+	{
+		m_records.Refresh();
+		m_index.Refresh();
+	}
+
+	/**
+	 * @brief Write the appended headers back to the files
+	 *
+	 */
+	void Flush()
+	{
+		m_records.Sync();
+		m_index.Sync();
+	}
+
+private: // static members:
+
+	// offsets in the record file header
+	static constexpr size_t sk_recMagicOffset = 0;
+	static constexpr size_t sk_recSizeOffset = 8;
+	static constexpr size_t sk_recCountOffset = 16;
+
+	// offsets in the index file header
+	static constexpr size_t sk_idxMagicOffset = 0;
+	static constexpr size_t sk_idxCountOffset = 8;
+
+	// offsets in a record
+	static constexpr size_t sk_numberOffset = 0;
+	static constexpr size_t sk_timeOffset = 8;
+	static constexpr size_t sk_diffOffset = 16;
+	static constexpr size_t sk_trustedTimeOffset = 24;
+	static constexpr size_t sk_hashOffset = 32;
+	static constexpr size_t sk_parentHashOffset = 64;
+
+	static const char* GetRecMagic()
+	{
+		return "EMHDRREC";
+	}
+
+	static const char* GetIdxMagic()
+	{
+		return "EMHDRIDX";
+	}
+
+	static uint64_t ReadU64(const uint8_t* src)
+	{
+		uint64_t val = 0;
+		for (size_t i = sizeof(val); i > 0; --i)
+		{
+			val = (val << 8) | src[i - 1];
+		}
+		return val;
+	}
+
+	static void WriteU64(uint8_t* dest, uint64_t val)
+	{
+		for (size_t i = 0; i < sizeof(val); ++i)
+		{
+			dest[i] = static_cast<uint8_t>(val >> (i * 8));
+		}
+	}
+
+	/**
+	 * @brief Load a count in the file header, which is published by
+	 *        `StoreCount` after the data it covers is written
+	 *
+	 */
+	static uint64_t LoadCount(const uint8_t* src)
+	{
+		static_assert(
+			sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+			"The count must be stored as a plain 64-bit integer"
+		);
+		const uint64_t raw =
+			reinterpret_cast<const std::atomic<uint64_t>*>(src)->load(
+				std::memory_order_acquire
+			);
+		uint8_t bytes[sizeof(raw)];
+		std::memcpy(bytes, &raw, sizeof(raw));
+		return ReadU64(bytes);
+	}
+
+	static void StoreCount(uint8_t* dest, uint64_t val)
+	{
+		uint8_t bytes[sizeof(val)];
+		WriteU64(bytes, val);
+		uint64_t raw = 0;
+		std::memcpy(&raw, bytes, sizeof(raw));
+		reinterpret_cast<std::atomic<uint64_t>*>(dest)->store(
+			raw,
+			std::memory_order_release
+		);
+	}
+
+	static bool IsHashEqual(const uint8_t* src, const HashType& hash)
+	{
+		return std::equal(hash.begin(), hash.end(), src);
+	}
+
+	static size_t HomeIndex(const uint8_t* hash, size_t mask)
+	{
+		return static_cast<size_t>(ReadU64(hash)) & mask;
+	}
+
+	static void WriteRecord(uint8_t* rec, const HeaderSummary& summary)
+	{
+		WriteU64(rec + sk_numberOffset, summary.GetNumber());
+		WriteU64(rec + sk_timeOffset, summary.GetTime());
+		WriteU64(rec + sk_diffOffset, summary.GetDiff());
+		WriteU64(rec + sk_trustedTimeOffset, summary.GetTrustedTime());
+		std::copy(
+			summary.GetHash().begin(),
+			summary.GetHash().end(),
+			rec + sk_hashOffset
+		);
+		std::copy(
+			summary.GetParentHash().begin(),
+			summary.GetParentHash().end(),
+			rec + sk_parentHashOffset
+		);
+	}
+
+	static HeaderSummary ReadRecord(const uint8_t* rec)
+	{
+		HashType hash = HashType();
+		HashType parentHash = HashType();
+		std::copy(
+			rec + sk_hashOffset,
+			rec + sk_hashOffset + hash.size(),
+			hash.begin()
+		);
+		std::copy(
+			rec + sk_parentHashOffset,
+			rec + sk_parentHashOffset + parentHash.size(),
+			parentHash.begin()
+		);
+		return HeaderSummary(
+			ReadU64(rec + sk_numberOffset),
+			ReadU64(rec + sk_timeOffset),
+			ReadU64(rec + sk_diffOffset),
+			ReadU64(rec + sk_trustedTimeOffset),
+			hash,
+			parentHash
+		);
+	}
+
+private:
+
+	void InitRecordFile()
+	{
+		if (m_records.GetSize() == 0)
+		{
+			// a new archive
+			m_records.Resize(
+				sk_recFileHeaderSize + (sk_minNumOfRecords * sk_recordSize)
+			);
+			std::memcpy(
+				m_records.GetData() + sk_recMagicOffset,
+				GetRecMagic(),
+				8
+			);
+			WriteU64(m_records.GetData() + sk_recSizeOffset, sk_recordSize);
+			WriteU64(m_records.GetData() + sk_recCountOffset, 0);
+		}
+
+		if ((m_records.GetSize() < sk_recFileHeaderSize) ||
+			(std::memcmp(
+				m_records.GetData() + sk_recMagicOffset,
+				GetRecMagic(),
+				8) != 0) ||
+			(ReadU64(m_records.GetData() + sk_recSizeOffset) !=
+				sk_recordSize) ||
+			(LoadCount(m_records.GetData() + sk_recCountOffset) >
+				(m_records.GetSize() - sk_recFileHeaderSize) / sk_recordSize))
+		{
+			throw Exception("Invalid header archive record file");
+		}
+	}
+
+	void InitIndexFile()
+	{
+		if (m_index.GetSize() == 0)
+		{
+			// a new index
+			m_index.Resize(
+				sk_idxFileHeaderSize + (sk_minIdxCapacity * sizeof(uint64_t))
+			);
+			std::memcpy(
+				m_index.GetData() + sk_idxMagicOffset,
+				GetIdxMagic(),
+				8
+			);
+			WriteU64(m_index.GetData() + sk_idxCountOffset, 0);
+		}
+
+		size_t capacity = GetIdxCapacity();
+		if ((m_index.GetSize() < sk_idxFileHeaderSize) ||
+			(std::memcmp(
+				m_index.GetData() + sk_idxMagicOffset,
+				GetIdxMagic(),
+				8) != 0) ||
+			(capacity == 0) ||
+			((capacity & (capacity - 1)) != 0))
+		{
+			throw Exception("Invalid header archive index file");
+		}
+	}
+
+	const uint8_t* GetRecord(size_t recIdx) const
+	{
+		return m_records.GetData() + sk_recFileHeaderSize +
+			(recIdx * sk_recordSize);
+	}
+
+	uint8_t* GetRecord(size_t recIdx)
+	{
+		return m_records.GetData() + sk_recFileHeaderSize +
+			(recIdx * sk_recordSize);
+	}
+
+	size_t GetNumOfIndexed() const
+	{
+		return static_cast<size_t>(
+			LoadCount(m_index.GetData() + sk_idxCountOffset)
+		);
+	}
+
+	size_t GetIdxCapacity() const
+	{
+		return (m_index.GetSize() - sk_idxFileHeaderSize) / sizeof(uint64_t);
+	}
+
+	/**
+	 * @brief Get the index slot at the given position, which is 0 if the
+	 *        slot is empty, or the record index plus 1 otherwise
+	 *
+	 */
+	uint64_t GetSlot(size_t pos) const
+	{
+		return ReadU64(
+			m_index.GetData() + sk_idxFileHeaderSize + (pos * sizeof(uint64_t))
+		);
+	}
+
+	/**
+	 * @brief Add the records in the range [begin, end) to the index, and
+	 *        grow the index (rebuilding it from all records) if its load
+	 *        factor would go beyond 3/4
+	 *
+	 */
+	void IndexRecords(size_t begin, size_t end)
+	{
+		size_t capacity = GetIdxCapacity();
+		if (end > (capacity / 4) * 3)
+		{
+			while (end > (capacity / 4) * 3)
+			{
+				capacity *= 2;
+			}
+			RebuildIndex(capacity, end);
+			return;
+		}
+
+		InsertSlots(m_index.GetData(), capacity - 1, begin, end);
+		StoreCount(m_index.GetData() + sk_idxCountOffset, end);
+	}
+
+	/**
+	 * @brief Build an index of the given capacity for the first `end`
+	 *        records in a new file, and replace the index file with it
+	 *
+	 */
+	void RebuildIndex(size_t capacity, size_t end)
+	{
+		const std::string tmpPath = m_index.GetPath() + ".tmp";
+		{
+			Internal::MappedFile newIndex(tmpPath, false);
+			// discard anything left by an interrupted rebuild
+			newIndex.Resize(0);
+			newIndex.Resize(
+				sk_idxFileHeaderSize + (capacity * sizeof(uint64_t))
+			);
+			std::memcpy(
+				newIndex.GetData() + sk_idxMagicOffset,
+				GetIdxMagic(),
+				8
+			);
+			InsertSlots(newIndex.GetData(), capacity - 1, 0, end);
+			StoreCount(newIndex.GetData() + sk_idxCountOffset, end);
+			// the new index must be on the disk before it replaces the old
+			// one, which is still valid until then
+			newIndex.Sync();
+		}
+
+		if (std::rename(tmpPath.c_str(), m_index.GetPath().c_str()) != 0)
+		{
+			throw Exception("Failed to replace the header archive index file");
+		}
+		m_index.Reopen();
+	}
+
+	/**
+	 * @brief Insert the records in the range [begin, end) into the slots of
+	 *        the given index file data
+	 *
+	 */
+	void InsertSlots(uint8_t* idxData, size_t mask, size_t begin, size_t end)
+	{
+		uint8_t* slots = idxData + sk_idxFileHeaderSize;
+		for (size_t recIdx = begin; recIdx < end; ++recIdx)
+		{
+			size_t pos = HomeIndex(GetRecord(recIdx) + sk_hashOffset, mask);
+			while (ReadU64(slots + (pos * sizeof(uint64_t))) != 0)
+			{
+				pos = (pos + 1) & mask;
+			}
+			WriteU64(slots + (pos * sizeof(uint64_t)), recIdx + 1);
+		}
+	}
+
+	Internal::MappedFile m_records;
+	Internal::MappedFile m_index;
+
+}; // class HeaderArchive
+
+
+} // namespace Eth
+} // namespace EclipseMonitor
@@ -7,9 +7,14 @@
 
 
 #include <algorithm>
+#include <array>
+#include <memory>
 
+#include "../Exceptions.hpp"
+#include "../Internal/PooledObject.hpp"
 #include "../Internal/SimpleObj.hpp"
 #include "../Internal/SimpleRlp.hpp"
+#include "../Metrics.hpp"
 
 #include "BloomFilter.hpp"
 #include "DataTypes.hpp"
@@ -22,7 +27,8 @@ namespace Eth
 {
 
 
-class HeaderMgr
+class HeaderMgr :
+	public Internal::PooledObject<HeaderMgr, 1024>
 {
 public: // static member
 
@@ -30,6 +36,7 @@ public: // static member
 	using RawHeaderParser = Internal::Rlp::EthHeaderParser;
 
 	using BytesObjType = Internal::Rlp::BytesObjType;
+	using HashType = std::array<uint8_t, 32>;
 
 	static const BytesObjType& GetEmptyUncleHash()
 	{
@@ -42,6 +49,27 @@ public: // static member
 		return inst;
 	}
 
+	static RawHeaderType ParseRawHeader(
+		const uint8_t* rawBinary,
+		size_t rawSize
+	)
+	{
+		using _FrItType = typename RawHeaderParser::IteratorType;
+		return RawHeaderParser().Parse(
+			_FrItType(Internal::Obj::ToFrIt<true>(rawBinary)),
+			_FrItType(Internal::Obj::ToFrIt<true>(rawBinary + rawSize)),
+			rawSize
+		);
+	}
+
+	static HashType HashRawHeader(const uint8_t* rawBinary, size_t rawSize)
+	{
+		auto start = Metrics::Now();
+		HashType hash = Keccak256(rawBinary, rawSize);
+		Metrics::AddLatency(MetricLatency::HeaderHash, start);
+		return hash;
+	}
+
 public:
 
 	HeaderMgr() :
@@ -63,7 +91,28 @@ public:
 		m_rawHeader(RawHeaderParser().Parse(rawBinary)),
 		m_trustedTime(trustedTime),
 		m_bloomFilter(m_rawHeader.get_LogsBloom()),
-		m_hash(Keccak256(rawBinary)),
+		m_hash(HashRawHeader(rawBinary.data(), rawBinary.size())),
+		m_hashObj(m_hash.begin(), m_hash.end()),
+		m_blkNum(BlkNumTypeTrait::FromBytes(m_rawHeader.get_Number())),
+		m_time(TimeTypeTrait::FromBytes(m_rawHeader.get_Timestamp())),
+		m_diff(DiffTypeTrait::FromBytes(m_rawHeader.get_Difficulty())),
+		m_hasUncle(m_rawHeader.get_Sha3Uncles() != GetEmptyUncleHash())
+	{}
+
+	/**
+	 * @brief Construct a new Header Manager from a header binary that is
+	 *        stored in a larger buffer (e.g., a receive buffer), so the
+	 *        caller doesn't need to copy it into a separate vector first
+	 *
+	 * @param rawBinary   Pointer to the beginning of the header binary
+	 * @param rawSize     Size of the header binary, in bytes
+	 * @param trustedTime The trusted timestamp of receiving this header
+	 */
+	HeaderMgr(const uint8_t* rawBinary, size_t rawSize, uint64_t trustedTime) :
+		m_rawHeader(ParseRawHeader(rawBinary, rawSize)),
+		m_trustedTime(trustedTime),
+		m_bloomFilter(m_rawHeader.get_LogsBloom()),
+		m_hash(HashRawHeader(rawBinary, rawSize)),
 		m_hashObj(m_hash.begin(), m_hash.end()),
 		m_blkNum(BlkNumTypeTrait::FromBytes(m_rawHeader.get_Number())),
 		m_time(TimeTypeTrait::FromBytes(m_rawHeader.get_Timestamp())),
@@ -93,6 +142,11 @@ public:
 		m_diff = diff;
 	}
 
+	void SetTrustedTime(uint64_t trustedTime)
+	{
+		m_trustedTime = trustedTime;
+	}
+
 	void SetUncleHash(const BytesObjType& uncleHash)
 	{
 		m_rawHeader.get_Sha3Uncles() = uncleHash;
@@ -109,7 +163,7 @@ public:
 		return m_trustedTime;
 	}
 
-	const std::array<uint8_t, 32>& GetHash() const
+	const HashType& GetHash() const
 	{
 		return m_hash;
 	}
@@ -144,12 +198,47 @@ public:
 		return m_bloomFilter;
 	}
 
+	/**
+	 * @brief Encode the header and its trusted time into a list, which is
+	 *        used in the snapshot of the monitor state
+	 *
+	 */
+	Internal::Obj::List ToSnapshot() const
+	{
+		Internal::Obj::List snapshot;
+		snapshot.push_back(
+			Internal::Obj::Bytes(Internal::Rlp::WriteRlp(m_rawHeader))
+		);
+		snapshot.push_back(TimeTypeTrait::ToBytes(m_trustedTime));
+		return snapshot;
+	}
+
+	/**
+	 * @brief Restore a header from the list generated by `ToSnapshot`
+	 *
+	 */
+	static std::unique_ptr<HeaderMgr> FromSnapshot(
+		const Internal::Obj::ListBaseObj& snapshot
+	)
+	{
+		if (snapshot.size() != 2)
+		{
+			throw Exception("Invalid header snapshot");
+		}
+		const auto& rawBinary = snapshot[0].AsBytes();
+		return Internal::Obj::Internal::make_unique<HeaderMgr>(
+			rawBinary.data(),
+			rawBinary.size(),
+			TimeTypeTrait::FromBytes(snapshot[1].AsBytes())
+		);
+	}
+
 private:
 
 	RawHeaderType m_rawHeader;
 	uint64_t m_trustedTime;
 	BloomFilter m_bloomFilter;
-	std::array<uint8_t, 32> m_hash;
+	HashType m_hash;
 	Internal::Obj::Bytes m_hashObj;
 	BlockNumber m_blkNum;
 	Timestamp m_time;
@@ -5,10 +5,14 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include <memory>
 #include <vector>
 
 #include "../Exceptions.hpp"
+#include "../Internal/InlineVector.hpp"
+#include "../Internal/PooledObject.hpp"
 #include "../Internal/SimpleObj.hpp"
 #include "../SyncMsgMgrBase.hpp"
 
@@ -22,7 +26,8 @@ namespace Eth
 
 class HeaderNode;
 
-class HeaderNode
+class HeaderNode :
+	public Internal::PooledObject<HeaderNode, 256>
 {
 public: // static members:
 	struct ChildInfo
@@ -34,13 +39,25 @@ public: // static members:
 		size_t m_numOfDesc;
 		std::unique_ptr<HeaderNode> m_child;
 
+		ChildInfo() :
+			m_numOfDesc(0),
+			m_child()
+		{}
+
 		ChildInfo(
 			size_t numOfDesc,
 			std::unique_ptr<HeaderNode> child) :
 			m_numOfDesc(numOfDesc),
 			m_child(std::move(child))
 		{}
-	};
+	}; // struct ChildInfo
+
+	/**
+	 * @brief Most of the nodes have only one child, and a fork usually has
+	 *        two, so the first two children are stored inline
+	 *
+	 */
+	using ChildListType = Internal::InlineVector<ChildInfo, 2>;
 
 public:
 	HeaderNode(
@@ -48,9 +65,13 @@ public:
 		std::shared_ptr<SyncState> syncState
 	) :
 		m_children(),
+		m_maxDescChildIdx(0),
 		m_parent(nullptr),
+		m_idxInParent(0),
 		m_header(std::move(header)),
-		m_syncState(syncState)
+		m_syncState(std::move(syncState)),
+		m_expiryGen(0),
+		m_evictionGen(0)
 	{}
 
 	// LCOV_EXCL_START
@@ -63,7 +84,7 @@ public:
 	)
 	{
 		auto child = Internal::Obj::Internal::make_unique<HeaderNode>(
-			std::move(childHeader), syncState
+			std::move(childHeader), std::move(syncState)
 		);
 		HeaderNode* childPtr = child.get();
 
@@ -73,14 +94,19 @@ public:
 
 		// link child's parent
 		child->m_parent = this;
+		child->m_idxInParent = m_children.size();
 		// append child to children list AND set number of descendants to 0
 		m_children.emplace_back(0, std::move(child));
 		// !!! NOTE: child is invalid after this point !!!
 
-		// Inform all ancestors that a new descendants has been added
-		if (m_parent != nullptr)
+		// Inform all ancestors that a new descendants has been added;
+		// each node knows its position in the parent's children list, so
+		// it costs O(depth) without any search
+		HeaderNode* node = this;
+		while (node->m_parent != nullptr)
 		{
-			m_parent->AddDescCount(this);
+			node->m_parent->IncDescCount(node->m_idxInParent);
+			node = node->m_parent;
 		}
 
 		return childPtr;
@@ -103,22 +129,53 @@ public:
 	std::unique_ptr<HeaderNode> ReleaseChildHasNDesc(
 		size_t numOfDesc)
 	{
-		// find the child in the children list
-		auto it = std::find_if(m_children.begin(), m_children.end(),
-			[&](const ChildInfo& childInfo) -> bool
-			{
-				return childInfo.m_numOfDesc >= numOfDesc;
-			});
-
-		if (it == m_children.end())
+		// descendants are added one at a time, so the child that reaches
+		// `numOfDesc` first is always the one with the most descendants
+		if (
+			m_children.empty() ||
+			(m_children[m_maxDescChildIdx].m_numOfDesc < numOfDesc)
+		)
 		{
 			return nullptr;
 		}
 
 		// remove the child from the children list
-		std::unique_ptr<HeaderNode> child = std::move(it->m_child);
-		m_children.erase(it);
+		std::unique_ptr<HeaderNode> child =
+			std::move(m_children[m_maxDescChildIdx].m_child);
+		EraseChild(m_maxDescChildIdx);
 		child->m_parent = nullptr;
+		child->m_idxInParent = 0;
+
+		return child;
+	}
+
+	/**
+	 * @brief Release the child at the given index, together with all its
+	 *        descendants, and update the number of descendants of all
+	 *        ancestors accordingly
+	 *
+	 */
+	std::unique_ptr<HeaderNode> ReleaseChild(size_t childIdx)
+	{
+		if (childIdx >= m_children.size())
+		{
+			throw Exception("The given child index is out of range");
+		}
+
+		size_t numOfRemoved = m_children[childIdx].m_numOfDesc + 1;
+
+		std::unique_ptr<HeaderNode> child =
+			std::move(m_children[childIdx].m_child);
+		EraseChild(childIdx);
+		child->m_parent = nullptr;
+		child->m_idxInParent = 0;
+
+		HeaderNode* node = this;
+		while (node->m_parent != nullptr)
+		{
+			node->m_parent->DecDescCount(node->m_idxInParent, numOfRemoved);
+			node = node->m_parent;
+		}
 
 		return child;
 	}
@@ -128,52 +185,204 @@ public:
 		return m_children.size();
 	}
 
+	HeaderNode* GetChild(size_t childIdx)
+	{
+		return m_children[childIdx].m_child.get();
+	}
+
+	const HeaderNode* GetChild(size_t childIdx) const
+	{
+		return m_children[childIdx].m_child.get();
+	}
+
+	/**
+	 * @brief Get the number of descendants that the child at the given index
+	 *        has
+	 *
+	 */
+	size_t GetNumOfDescOfChild(size_t childIdx) const
+	{
+		return m_children[childIdx].m_numOfDesc;
+	}
+
+	/**
+	 * @brief Get the index of the child that has the most descendants;
+	 *        if there are multiple, the earliest added one is returned
+	 *
+	 */
+	size_t GetMaxDescChildIdx() const
+	{
+		return m_maxDescChildIdx;
+	}
+
+	/**
+	 * @brief Get the total number of descendants of this node
+	 *
+	 */
+	size_t GetNumOfDesc() const
+	{
+		size_t numOfDesc = 0;
+		for (const auto& childInfo : m_children)
+		{
+			numOfDesc += childInfo.m_numOfDesc + 1;
+		}
+		return numOfDesc;
+	}
+
+	HeaderNode* GetParent()
+	{
+		return m_parent;
+	}
+
 	const HeaderNode* GetParent() const
 	{
 		return m_parent;
 	}
 
+	size_t GetIdxInParent() const
+	{
+		return m_idxInParent;
+	}
+
+	/**
+	 * @brief Get the generation of the latest expiry scheduled for this node
+	 *        by the monitor, which tells its current expiry entry apart from
+	 *        stale ones
+	 *
+	 */
+	uint64_t GetExpiryGen() const
+	{
+		return m_expiryGen;
+	}
+
+	void SetExpiryGen(uint64_t expiryGen)
+	{
+		m_expiryGen = expiryGen;
+	}
+
+	/**
+	 * @brief Get the generation of the latest eviction entry queued for this
+	 *        node by the monitor, which tells its current entry apart from
+	 *        stale ones
+	 *
+	 */
+	uint64_t GetEvictionGen() const
+	{
+		return m_evictionGen;
+	}
+
+	void SetEvictionGen(uint64_t evictionGen)
+	{
+		m_evictionGen = evictionGen;
+	}
+
+	/**
+	 * @brief Call `func(node)` for this node and all its descendants.
+	 *        The tree must not be modified inside the callback.
+	 *
+	 */
+	template<typename _FuncType>
+	void ForEachInSubtree(_FuncType func)
+	{
+		// iterate with an explicit stack, since the tree can be very deep
+		std::vector<HeaderNode*> stack;
+		stack.push_back(this);
+		while (!stack.empty())
+		{
+			HeaderNode* node = stack.back();
+			stack.pop_back();
+			func(node);
+			for (auto& childInfo : node->m_children)
+			{
+				stack.push_back(childInfo.m_child.get());
+			}
+		}
+	}
+
 protected:
 
-	void AddDescCount(HeaderNode* childPtr)
+	void IncDescCount(size_t childIdx)
 	{
-		// ensure that the child is a child of this node
-		if (childPtr->m_parent != this)
+		if (childIdx >= m_children.size())
 		{
+			// This should never happen, unless we have implementation error
 			throw Exception(
-				"The given node pointer is not a child of this node");
+				"The given child index is out of range");
 		}
 
-		// find the child in the children list
-		auto it = std::find_if(m_children.begin(), m_children.end(),
-			[&](const ChildInfo& childInfo) -> bool
-			{
-				return childInfo.m_child.get() == childPtr;
-			});
+		// increment the number of descendants
+		size_t numOfDesc = ++(m_children[childIdx].m_numOfDesc);
+
+		// keep track of the child with the most descendants
+		if (numOfDesc > m_children[m_maxDescChildIdx].m_numOfDesc)
+		{
+			m_maxDescChildIdx = childIdx;
+		}
+	}
 
-		if (it == m_children.end())
+	void DecDescCount(size_t childIdx, size_t numOfRemoved)
+	{
+		if (childIdx >= m_children.size())
 		{
 			// This should never happen, unless we have implementation error
 			throw Exception(
-				"The given node pointer is not a child of this node");
+				"The given child index is out of range");
 		}
 
-		// increment the number of descendants
-		++(it->m_numOfDesc);
+		m_children[childIdx].m_numOfDesc -= numOfRemoved;
+
+		if (childIdx == m_maxDescChildIdx)
+		{
+			UpdateMaxDescChildIdx();
+		}
+	}
+
+	void EraseChild(size_t childIdx)
+	{
+		m_children.erase(m_children.begin() + childIdx);
+
+		// children after the erased one are shifted forward
+		for (size_t i = childIdx; i < m_children.size(); ++i)
+		{
+			m_children[i].m_child->m_idxInParent = i;
+		}
+
+		UpdateMaxDescChildIdx();
+	}
 
-		// Inform all ancestors that a new descendants has been added
-		if (m_parent != nullptr)
+	void UpdateMaxDescChildIdx()
+	{
+		m_maxDescChildIdx = 0;
+		for (size_t i = 1; i < m_children.size(); ++i)
 		{
-			m_parent->AddDescCount(this);
+			if (
+				m_children[i].m_numOfDesc >
+				m_children[m_maxDescChildIdx].m_numOfDesc
+			)
+			{
+				m_maxDescChildIdx = i;
+			}
 		}
 	}
 
 
 private:
-	std::vector<ChildInfo> m_children;
+	ChildListType m_children;
+	/**
+	 * @brief Index of the child that has the most descendants
+	 *
+	 */
+	size_t m_maxDescChildIdx;
 	HeaderNode* m_parent;
+	/**
+	 * @brief Index of this node in the parent's children list
+	 *
+	 */
+	size_t m_idxInParent;
 	std::unique_ptr<HeaderMgr> m_header;
 	std::shared_ptr<SyncState> m_syncState;
+	uint64_t m_expiryGen;
+	uint64_t m_evictionGen;
 
 }; // class HeaderNode
 
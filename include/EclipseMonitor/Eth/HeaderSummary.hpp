@@ -0,0 +1,131 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+
+#include "DataTypes.hpp"
+#include "HeaderMgr.hpp"
+
+
+namespace EclipseMonitor
+{
+namespace Eth
+{
+
+
+/**
+ * @brief A compact summary of a header, which is used where the whole
+ *        header is not needed, such as the header archive and the batch
+ *        of confirmed headers
+ *
+ */
+class HeaderSummary
+{
+public: // static members:
+
+	using HashType = HeaderMgr::HashType;
+
+	static HeaderSummary FromHeader(const HeaderMgr& header)
+	{
+		HashType parentHash = HashType();
+		const auto& parentHashObj = header.GetRawHeader().get_ParentHash();
+		std::copy(
+			parentHashObj.data(),
+			parentHashObj.data() +
+				std::min(parentHashObj.size(), parentHash.size()),
+			parentHash.begin()
+		);
+
+		return HeaderSummary(
+			header.GetNumber(),
+			header.GetTime(),
+			header.GetDiff(),
+			header.GetTrustedTime(),
+			header.GetHash(),
+			parentHash
+		);
+	}
+
+public:
+
+	HeaderSummary() :
+		HeaderSummary(0, 0, 0, 0, HashType(), HashType())
+	{}
+
+	HeaderSummary(
+		BlockNumber number,
+		Timestamp time,
+		Difficulty diff,
+		uint64_t trustedTime,
+		const HashType& hash,
+		const HashType& parentHash
+	) :
+		m_number(number),
+		m_time(time),
+		m_diff(diff),
+		m_trustedTime(trustedTime),
+		m_hash(hash),
+		m_parentHash(parentHash)
+	{}
+
+	// LCOV_EXCL_START
+	~HeaderSummary() = default;
+	// LCOV_EXCL_STOP
+
+	BlockNumber GetNumber() const
+	{
+		return m_number;
+	}
+
+	Timestamp GetTime() const
+	{
+		return m_time;
+	}
+
+	Difficulty GetDiff() const
+	{
+		return m_diff;
+	}
+
+	/**
+	 * @brief Get the trusted time when the header was received by the
+	 *        monitor; 0 for history headers
+	 *
+	 */
+	uint64_t GetTrustedTime() const
+	{
+		return m_trustedTime;
+	}
+
+	const HashType& GetHash() const
+	{
+		return m_hash;
+	}
+
+	const HashType& GetParentHash() const
+	{
+		return m_parentHash;
+	}
+
+private:
+
+	BlockNumber m_number;
+	Timestamp m_time;
+	Difficulty m_diff;
+	uint64_t m_trustedTime;
+	HashType m_hash;
+	HashType m_parentHash;
+
+}; // class HeaderSummary
+
+
+} // namespace Eth
+} // namespace EclipseMonitor
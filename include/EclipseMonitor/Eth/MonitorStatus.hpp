@@ -0,0 +1,174 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../EclipseMonitorBase.hpp"
+
+#include "DataTypes.hpp"
+#include "HeaderMgr.hpp"
+
+namespace EclipseMonitor
+{
+namespace Eth
+{
+
+
+/**
+ * @brief An immutable copy of the monitor status, which is published by the
+ *        monitor after each update, so it can be read by other threads
+ *        without accessing the monitor itself.
+ *
+ */
+class MonitorStatus
+{
+public: // static members:
+
+	using HashType = HeaderMgr::HashType;
+
+public:
+
+	/**
+	 * @brief Construct a new Monitor Status object
+	 *
+	 * @param phase             The current phase of the monitor
+	 * @param checkpointIter    The number of checkpoints that have been made
+	 * @param checkpointNum     The block number of the latest checkpoint;
+	 *                          0 if there is no checkpoint yet
+	 * @param checkpointHash    The block hash of the latest checkpoint;
+	 *                          all zeros if there is no checkpoint yet
+	 * @param hasTip            Whether any header has been added
+	 * @param tipNum            The block number of the best tip
+	 * @param tipHash           The block hash of the best tip
+	 * @param isSynced          Whether the latest sync message has been
+	 *                          received in time
+	 * @param numOfActiveNodes  The number of active nodes in the fork tree
+	 * @param numOfOfflineNodes The number of offline nodes in the fork tree
+	 */
+	MonitorStatus(
+		Phases phase,
+		uint64_t checkpointIter,
+		BlockNumber checkpointNum,
+		const HashType& checkpointHash,
+		bool hasTip,
+		BlockNumber tipNum,
+		const HashType& tipHash,
+		bool isSynced,
+		size_t numOfActiveNodes,
+		size_t numOfOfflineNodes
+	) :
+		m_phase(phase),
+		m_checkpointIter(checkpointIter),
+		m_checkpointNum(checkpointNum),
+		m_checkpointHash(checkpointHash),
+		m_hasTip(hasTip),
+		m_tipNum(tipNum),
+		m_tipHash(tipHash),
+		m_isSynced(isSynced),
+		m_numOfActiveNodes(numOfActiveNodes),
+		m_numOfOfflineNodes(numOfOfflineNodes)
+	{}
+
+	// LCOV_EXCL_START
+	~MonitorStatus() = default;
+	// LCOV_EXCL_STOP
+
+	Phases GetPhase() const
+	{
+		return m_phase;
+	}
+
+	uint64_t GetCheckpointIter() const
+	{
+		return m_checkpointIter;
+	}
+
+	BlockNumber GetCheckpointNum() const
+	{
+		return m_checkpointNum;
+	}
+
+	const HashType& GetCheckpointHash() const
+	{
+		return m_checkpointHash;
+	}
+
+	bool HasTip() const
+	{
+		return m_hasTip;
+	}
+
+	/**
+	 * @brief Get the block number of the best tip, which is the last header
+	 *        added during the bootstrap I phase, or the end of the heaviest
+	 *        branch (i.e., following the child with the most descendants) in
+	 *        the fork tree afterwards
+	 *
+	 */
+	BlockNumber GetTipNum() const
+	{
+		return m_tipNum;
+	}
+
+	const HashType& GetTipHash() const
+	{
+		return m_tipHash;
+	}
+
+	bool IsSynced() const
+	{
+		return m_isSynced;
+	}
+
+	size_t GetNumOfActiveNodes() const
+	{
+		return m_numOfActiveNodes;
+	}
+
+	size_t GetNumOfOfflineNodes() const
+	{
+		return m_numOfOfflineNodes;
+	}
+
+	bool operator==(const MonitorStatus& other) const
+	{
+		return (m_phase == other.m_phase) &&
+			(m_checkpointIter == other.m_checkpointIter) &&
+			(m_checkpointNum == other.m_checkpointNum) &&
+			(m_checkpointHash == other.m_checkpointHash) &&
+			(m_hasTip == other.m_hasTip) &&
+			(m_tipNum == other.m_tipNum) &&
+			(m_tipHash == other.m_tipHash) &&
+			(m_isSynced == other.m_isSynced) &&
+			(m_numOfActiveNodes == other.m_numOfActiveNodes) &&
+			(m_numOfOfflineNodes == other.m_numOfOfflineNodes);
+	}
+
+	bool operator!=(const MonitorStatus& other) const
+	{
+		return !(*this == other);
+	}
+
+private:
+
+	const Phases m_phase;
+	const uint64_t m_checkpointIter;
+	const BlockNumber m_checkpointNum;
+	const HashType m_checkpointHash;
+	const bool m_hasTip;
+	const BlockNumber m_tipNum;
+	const HashType m_tipHash;
+	const bool m_isSynced;
+	const size_t m_numOfActiveNodes;
+	const size_t m_numOfOfflineNodes;
+
+}; // class MonitorStatus
+
+
+} // namespace Eth
+} // namespace EclipseMonitor
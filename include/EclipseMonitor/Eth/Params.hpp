@@ -5,6 +5,10 @@
 
 #pragma once
 
+#include <cstddef>
+
+#include <limits>
+
 #include "DataTypes.hpp"
 
 namespace EclipseMonitor
@@ -36,175 +40,260 @@ struct Params
 }; // struct Params
 
 
+/**
+ * @brief Forks that affect the monitor, in the order of activation
+ *
+ */
+enum class Forks
+{
+	Frontier,
+	Homestead,
+	Byzantium,
+	Constantinople,
+	MuirGlacier,
+	London,
+	ArrowGlacier,
+	GrayGlacier,
+	Paris,
+	NumOfForks,
+}; // enum class Forks
+
+
+/**
+ * @brief Compile-time helpers to build the fork schedule of a network
+ *
+ */
 template<typename _ConfigDetails>
-struct NetworkConfigImpl
+struct ForkScheduleBuilder
 {
 	using Details = _ConfigDetails;
 	using BlkNumType = typename Details::BlkNumType;
 
-	static bool IsBlockOf(
-		const BlkNumType* forkBlkNum,
-		const BlkNumType* blkNum
-	)
-	{
-		if (forkBlkNum == nullptr || blkNum == nullptr)
-		{
-			return false;
-		}
-		return (*blkNum) >= (*forkBlkNum);
-	}
+	static constexpr size_t sk_numOfForks =
+		static_cast<size_t>(Forks::NumOfForks);
 
-	static bool IsBlockOfParis(const BlkNumType& blkNum)
+	/**
+	 * @brief Get the block number since which the given fork or any later
+	 *        fork is active
+	 *
+	 */
+	static constexpr BlkNumType GetScheduleBlkNum(Forks fork)
 	{
-		return IsBlockOf(Details::ParisBlkNum(), &blkNum);
+		return
+			(static_cast<size_t>(fork) + 1 < sk_numOfForks) ?
+				MinBlkNum(
+					Details::GetForkBlkNum(fork),
+					GetScheduleBlkNum(
+						static_cast<Forks>(static_cast<size_t>(fork) + 1)
+					)
+				) :
+				Details::GetForkBlkNum(fork);
 	}
 
-	static bool IsBlockOfGrayGlacier(const BlkNumType& blkNum)
+	static constexpr BlkNumType MinBlkNum(BlkNumType a, BlkNumType b)
 	{
-		return IsBlockOf(Details::GrayGlacierBlkNum(), &blkNum);
+		return (a < b) ? a : b;
 	}
+}; // struct ForkScheduleBuilder
 
-	static bool IsBlockOfArrowGlacier(const BlkNumType& blkNum)
-	{
-		return IsBlockOf(Details::ArrowGlacierBlkNum(), &blkNum);
-	}
 
-	static bool IsBlockOfLondon(const BlkNumType& blkNum)
+template<typename _ConfigDetails>
+struct NetworkConfigImpl
+{
+	using Details = _ConfigDetails;
+	using BlkNumType = typename Details::BlkNumType;
+	using Builder = ForkScheduleBuilder<Details>;
+
+	static constexpr size_t sk_numOfForks = Builder::sk_numOfForks;
+
+	/**
+	 * @brief The fork schedule of the network, indexed by `Forks`; entry `i`
+	 *        is the block number since which fork `i` or any later fork is
+	 *        active, so it's sorted in ascending order even if some forks
+	 *        are never activated on this network
+	 *
+	 */
+	static constexpr BlkNumType sk_forkSchedule[sk_numOfForks] = {
+		Builder::GetScheduleBlkNum(Forks::Frontier),
+		Builder::GetScheduleBlkNum(Forks::Homestead),
+		Builder::GetScheduleBlkNum(Forks::Byzantium),
+		Builder::GetScheduleBlkNum(Forks::Constantinople),
+		Builder::GetScheduleBlkNum(Forks::MuirGlacier),
+		Builder::GetScheduleBlkNum(Forks::London),
+		Builder::GetScheduleBlkNum(Forks::ArrowGlacier),
+		Builder::GetScheduleBlkNum(Forks::GrayGlacier),
+		Builder::GetScheduleBlkNum(Forks::Paris),
+	};
+
+	static constexpr bool IsBlockOf(Forks fork, const BlkNumType& blkNum)
 	{
-		return IsBlockOf(Details::LondonBlkNum(), &blkNum);
+		return
+			(Details::GetForkBlkNum(fork) != Details::GetInactiveBlkNum()) &&
+			(blkNum >= Details::GetForkBlkNum(fork));
 	}
 
-	static bool IsBlockOfMuirGlacier(const BlkNumType& blkNum)
+	/**
+	 * @brief Get the latest fork that is active at the given block number,
+	 *        by a binary search on the fork schedule
+	 *
+	 */
+	static constexpr Forks GetFork(const BlkNumType& blkNum)
 	{
-		return IsBlockOf(Details::MuirGlacierBlkNum(), &blkNum);
+		// Frontier is always active
+		return static_cast<Forks>(FindForkIdx(blkNum, 0, sk_numOfForks));
 	}
 
-	static bool IsBlockOfConstantinople(const BlkNumType& blkNum)
+	/**
+	 * @brief Get the block number where the given fork is superseded by a
+	 *        later fork; i.e., `GetFork` returns `fork` for all block numbers
+	 *        in the range [`sk_forkSchedule[fork]`, `GetForkEndBlkNum(fork)`)
+	 *
+	 */
+	static constexpr BlkNumType GetForkEndBlkNum(Forks fork)
 	{
-		return IsBlockOf(Details::ConstantinopleBlkNum(), &blkNum);
+		return
+			(static_cast<size_t>(fork) + 1 < sk_numOfForks) ?
+				sk_forkSchedule[static_cast<size_t>(fork) + 1] :
+				Details::GetInactiveBlkNum();
 	}
 
-	static bool IsBlockOfByzantium(const BlkNumType& blkNum)
+	static constexpr bool IsBlockOfParis(const BlkNumType& blkNum)
 	{
-		return IsBlockOf(Details::ByzantiumBlkNum(), &blkNum);
+		return IsBlockOf(Forks::Paris, blkNum);
 	}
 
-	static bool IsBlockOfHomestead(const BlkNumType& blkNum)
+	static constexpr bool IsBlockOfGrayGlacier(const BlkNumType& blkNum)
 	{
-		return IsBlockOf(Details::HomesteadBlkNum(), &blkNum);
+		return IsBlockOf(Forks::GrayGlacier, blkNum);
 	}
-}; // struct NetworkConfigImpl
-
-
-struct MainnetConfigDetails
-{
-	// numbers are generally retrieved from:
-	// https://github.com/ethereum/go-ethereum/blob/5ccc99b258461457955fc523839fd373b33186af/params/config.go#L59
 
-	using BlkNumType = BlockNumber;
-
-	static const BlkNumType* ParisBlkNum()
+	static constexpr bool IsBlockOfArrowGlacier(const BlkNumType& blkNum)
 	{
-		// https://github.com/ethereum/execution-specs/blob/master/network-upgrades/mainnet-upgrades/paris.md
-		static const BlkNumType blkNum(15537394UL);
-		return &blkNum;
+		return IsBlockOf(Forks::ArrowGlacier, blkNum);
 	}
 
-	static const BlkNumType* GrayGlacierBlkNum()
+	static constexpr bool IsBlockOfLondon(const BlkNumType& blkNum)
 	{
-		static const BlkNumType blkNum(15050000UL);
-		return &blkNum;
+		return IsBlockOf(Forks::London, blkNum);
 	}
 
-	static const BlkNumType* ArrowGlacierBlkNum()
+	static constexpr bool IsBlockOfMuirGlacier(const BlkNumType& blkNum)
 	{
-		static const BlkNumType blkNum(13773000UL);
-		return &blkNum;
+		return IsBlockOf(Forks::MuirGlacier, blkNum);
 	}
 
-	static const BlkNumType* LondonBlkNum()
+	static constexpr bool IsBlockOfConstantinople(const BlkNumType& blkNum)
 	{
-		static const BlkNumType blkNum(12965000UL);
-		return &blkNum;
+		return IsBlockOf(Forks::Constantinople, blkNum);
 	}
 
-	static const BlkNumType* MuirGlacierBlkNum()
+	static constexpr bool IsBlockOfByzantium(const BlkNumType& blkNum)
 	{
-		static const BlkNumType blkNum(9200000UL);
-		return &blkNum;
+		return IsBlockOf(Forks::Byzantium, blkNum);
 	}
 
-	static const BlkNumType* ConstantinopleBlkNum()
+	static constexpr bool IsBlockOfHomestead(const BlkNumType& blkNum)
 	{
-		static const BlkNumType blkNum(7280000UL);
-		return &blkNum;
+		return IsBlockOf(Forks::Homestead, blkNum);
 	}
 
-	static const BlkNumType* ByzantiumBlkNum()
+private:
+
+	/**
+	 * @brief Find the largest index in [begin, end) whose schedule block
+	 *        number is not greater than the given one; the schedule block
+	 *        number at `begin` must not be greater than the given one
+	 *
+	 */
+	static constexpr size_t FindForkIdx(
+		const BlkNumType& blkNum,
+		size_t begin,
+		size_t end
+	)
 	{
-		static const BlkNumType blkNum(4370000UL);
-		return &blkNum;
+		return
+			(end - begin <= 1) ?
+				begin :
+				(sk_forkSchedule[begin + ((end - begin) / 2)] <= blkNum) ?
+					FindForkIdx(blkNum, begin + ((end - begin) / 2), end) :
+					FindForkIdx(blkNum, begin, begin + ((end - begin) / 2));
 	}
+}; // struct NetworkConfigImpl
 
-	static const BlkNumType* HomesteadBlkNum()
-	{
-		static const BlkNumType blkNum(1150000UL);
-		return &blkNum;
-	}
-}; // struct MainnetConfigDetails
 
+template<typename _ConfigDetails>
+constexpr size_t ForkScheduleBuilder<_ConfigDetails>::sk_numOfForks;
 
-struct GoerliConfigDetails
+template<typename _ConfigDetails>
+constexpr size_t NetworkConfigImpl<_ConfigDetails>::sk_numOfForks;
+
+template<typename _ConfigDetails>
+constexpr typename NetworkConfigImpl<_ConfigDetails>::BlkNumType
+	NetworkConfigImpl<_ConfigDetails>::sk_forkSchedule[
+		NetworkConfigImpl<_ConfigDetails>::sk_numOfForks
+	];
+
+
+struct MainnetConfigDetails
 {
 	// numbers are generally retrieved from:
-	// https://github.com/ethereum/go-ethereum/blob/5ccc99b258461457955fc523839fd373b33186af/params/config.go#L179
+	// https://github.com/ethereum/go-ethereum/blob/5ccc99b258461457955fc523839fd373b33186af/params/config.go#L59
 
 	using BlkNumType = BlockNumber;
 
-	static const BlkNumType* ParisBlkNum()
-	{
-		//
-		static const BlkNumType blkNum(7382819UL);
-		return &blkNum;
-	}
-
-	static const BlkNumType* GrayGlacierBlkNum()
+	/**
+	 * @brief The block number used for forks that are never activated
+	 *
+	 */
+	static constexpr BlkNumType GetInactiveBlkNum()
 	{
-		return nullptr;
+		return std::numeric_limits<BlkNumType>::max();
 	}
 
-	static const BlkNumType* ArrowGlacierBlkNum()
+	static constexpr BlkNumType GetForkBlkNum(Forks fork)
 	{
-		return nullptr;
+		return
+			// https://github.com/ethereum/execution-specs/blob/master/network-upgrades/mainnet-upgrades/paris.md
+			(fork == Forks::Paris)          ? BlkNumType(15537394UL) :
+			(fork == Forks::GrayGlacier)    ? BlkNumType(15050000UL) :
+			(fork == Forks::ArrowGlacier)   ? BlkNumType(13773000UL) :
+			(fork == Forks::London)         ? BlkNumType(12965000UL) :
+			(fork == Forks::MuirGlacier)    ? BlkNumType(9200000UL) :
+			(fork == Forks::Constantinople) ? BlkNumType(7280000UL) :
+			(fork == Forks::Byzantium)      ? BlkNumType(4370000UL) :
+			(fork == Forks::Homestead)      ? BlkNumType(1150000UL) :
+			// Frontier
+			BlkNumType(0UL);
 	}
+}; // struct MainnetConfigDetails
 
-	static const BlkNumType* LondonBlkNum()
-	{
-		static const BlkNumType blkNum(5062605UL);
-		return &blkNum;
-	}
 
-	static const BlkNumType* MuirGlacierBlkNum()
-	{
-		return nullptr;
-	}
+struct GoerliConfigDetails
+{
+	// numbers are generally retrieved from:
+	// https://github.com/ethereum/go-ethereum/blob/5ccc99b258461457955fc523839fd373b33186af/params/config.go#L179
 
-	static const BlkNumType* ConstantinopleBlkNum()
-	{
-		static const BlkNumType blkNum(0UL);
-		return &blkNum;
-	}
+	using BlkNumType = BlockNumber;
 
-	static const BlkNumType* ByzantiumBlkNum()
+	/**
+	 * @brief The block number used for forks that are never activated
+	 *
+	 */
+	static constexpr BlkNumType GetInactiveBlkNum()
 	{
-		static const BlkNumType blkNum(0UL);
-		return &blkNum;
+		return std::numeric_limits<BlkNumType>::max();
 	}
 
-	static const BlkNumType* HomesteadBlkNum()
+	static constexpr BlkNumType GetForkBlkNum(Forks fork)
 	{
-		static const BlkNumType blkNum(0UL);
-		return &blkNum;
+		return
+			(fork == Forks::Paris)          ? BlkNumType(7382819UL) :
+			(fork == Forks::GrayGlacier)    ? GetInactiveBlkNum() :
+			(fork == Forks::ArrowGlacier)   ? GetInactiveBlkNum() :
+			(fork == Forks::London)         ? BlkNumType(5062605UL) :
+			(fork == Forks::MuirGlacier)    ? GetInactiveBlkNum() :
+			// Constantinople, Byzantium, Homestead, and Frontier
+			BlkNumType(0UL);
 	}
 }; // struct GoerliConfigDetails
 
@@ -131,11 +131,13 @@ protected: // helper functions:
 				if (!syncState->IsSynced())
 				{
 					syncState->SetSynced(headerMgr.GetTrustedTime());
-					auto logger = LoggerFactory::GetLogger("SyncMsgMgr_EventHandler");
-					logger.Debug(
-						"Sync message found at block #" +
-							std::to_string(headerMgr.GetNumber())
-					);
+					Logger logger =
+						LoggerFactory::GetLogger("SyncMsgMgr_EventHandler");
+					logger.Debug([&]()
+					{
+						return "Sync message found at block #" +
+							std::to_string(headerMgr.GetNumber());
+					});
 				}
 
 				auto eventMgr = weakEventMgr.lock();
@@ -146,17 +148,13 @@ protected: // helper functions:
 			}
 		);
 
-		using namespace Internal::Obj::Codec;
-		std::string sessionStr =
-			Hex::Encode<std::string>(baseSessID);
-		std::string nonceStr =
-			Hex::Encode<std::string>(syncState->GetNonce());
-
-		m_logger.Info(
-			std::string("Sync message generated:\n") +
-			"\tSession ID: " + sessionStr + "\n" +
-			"\tNonce:      " + nonceStr
-		);
+		m_logger.Info([&]() -> std::string
+		{
+			using namespace Internal::Obj::Codec;
+			return std::string("Sync message generated:\n") +
+				"\tSession ID: " + Hex::Encode<std::string>(baseSessID) + "\n" +
+				"\tNonce:      " + Hex::Encode<std::string>(syncState->GetNonce());
+		});
 
 		auto eventMgr = m_eventMgr.lock();
 		if (eventMgr)
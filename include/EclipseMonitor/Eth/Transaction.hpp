@@ -5,11 +5,16 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
+#include <algorithm>
+
+#include "../Internal/RlpView.hpp"
 #include "../Internal/SimpleObj.hpp"
 #include "../Internal/SimpleRlp.hpp"
 #include "../Exceptions.hpp"
+#include "DataTypes.hpp"
 
 
 namespace EclipseMonitor
@@ -23,9 +28,86 @@ enum class TxnVersion : uint8_t
 	Legacy     = 0,
 	AccessList = 1,
 	DynamicFee = 2,
+	Blob       = 3,
+	SetCode    = 4,
 }; // enum class TxnVersion
 
 
+/**
+ * @brief Check if the type of a transaction, given by the first byte of its
+ *        binary, is supported.
+ *        A legacy transaction is a RLP list, whose first byte is at least
+ *        0xc0, while a typed transaction envelope starts with its type,
+ *        which is at most 0x7f
+ *
+ */
+inline bool IsTxnTypeSupported(uint8_t firstByte)
+{
+	return (firstByte > 0x7fU) ||
+		((firstByte >= 0x01U) && (firstByte <= 0x04U));
+}
+
+
+/**
+ * @brief Get the version of a transaction from the first byte of its binary
+ *
+ */
+inline TxnVersion GetTxnVersion(uint8_t firstByte)
+{
+	if (!IsTxnTypeSupported(firstByte))
+	{
+		throw Exception("Unsupported transaction type");
+	}
+	return (firstByte > 0x7fU) ?
+		TxnVersion::Legacy :
+		static_cast<TxnVersion>(firstByte);
+}
+
+
+/**
+ * @brief Get the index of the `to` field in the transaction body
+ *
+ */
+inline size_t GetTxnContractAddrIdx(TxnVersion version)
+{
+	switch (version)
+	{
+	case TxnVersion::Legacy:
+		return 3;
+	case TxnVersion::AccessList:
+		return 4;
+	case TxnVersion::DynamicFee:
+	case TxnVersion::Blob:
+	case TxnVersion::SetCode:
+		return 5;
+	default:
+		throw Exception("Invalid transaction version");
+	}
+}
+
+
+/**
+ * @brief Get the index of the `data` field in the transaction body
+ *
+ */
+inline size_t GetTxnContractParamIdx(TxnVersion version)
+{
+	switch (version)
+	{
+	case TxnVersion::Legacy:
+		return 5;
+	case TxnVersion::AccessList:
+		return 6;
+	case TxnVersion::DynamicFee:
+	case TxnVersion::Blob:
+	case TxnVersion::SetCode:
+		return 7;
+	default:
+		throw Exception("Invalid transaction version");
+	}
+}
+
+
 class Transaction
 {
 public: // static members:
@@ -35,27 +117,15 @@ public: // static members:
 		const Internal::Obj::BytesBaseObj& rlpBytes
 	)
 	{
-		TxnVersion version = TxnVersion::Legacy;
-
 		auto itBegin = rlpBytes.begin();
 		auto itEnd = rlpBytes.end();
 		size_t size = rlpBytes.size();
 
-		uint8_t firstByte = *itBegin;
-		switch (firstByte)
+		TxnVersion version = GetTxnVersion(*itBegin);
+		if (version != TxnVersion::Legacy)
 		{
-		case 0x01U:
-			version = TxnVersion::AccessList;
-			++itBegin;
-			--size;
-			break;
-		case 0x02U:
-			version = TxnVersion::DynamicFee;
 			++itBegin;
 			--size;
-			break;
-		default:
-			break;
 		}
 
 		using _FrItType = typename Internal::Rlp::GeneralParser::IteratorType;
@@ -118,11 +188,7 @@ private: // static members:
 		Internal::Obj::ListBaseObj& txnBody
 	)
 	{
-		return
-			(version == TxnVersion::Legacy     ? txnBody[3].AsBytes() :
-			(version == TxnVersion::AccessList ? txnBody[4].AsBytes() :
-			(version == TxnVersion::DynamicFee ? txnBody[5].AsBytes() :
-				throw Exception("Invalid transaction version"))));
+		return txnBody[GetTxnContractAddrIdx(version)].AsBytes();
 	}
 
 	static Internal::Obj::BytesBaseObj& GetContractParamRef(
@@ -130,11 +196,7 @@ private: // static members:
 		Internal::Obj::ListBaseObj& txnBody
 	)
 	{
-		return
-			(version == TxnVersion::Legacy     ? txnBody[5].AsBytes() :
-			(version == TxnVersion::AccessList ? txnBody[6].AsBytes() :
-			(version == TxnVersion::DynamicFee ? txnBody[7].AsBytes() :
-				throw Exception("Invalid transaction version"))));
+		return txnBody[GetTxnContractParamIdx(version)].AsBytes();
 	}
 
 private:
@@ -148,5 +210,115 @@ private:
 }; // class Transaction
 
 
+/**
+ * @brief A view of a transaction binary, which decodes its fields on demand
+ *        from the binary, instead of parsing the whole transaction into
+ *        objects like `Transaction` does.
+ *        The transaction binary must outlive the view.
+ *
+ */
+class TransactionView
+{
+public: // static members:
+
+	static TransactionView FromBytes(const uint8_t* data, size_t size)
+	{
+		if (size == 0)
+		{
+			throw Exception("The transaction binary is empty");
+		}
+
+		TxnVersion version = GetTxnVersion(data[0]);
+		if (version != TxnVersion::Legacy)
+		{
+			++data;
+			--size;
+		}
+
+		Internal::RlpView body = Internal::RlpView::Decode(data, size);
+		if (!body.IsList() || (body.GetSize() != size))
+		{
+			throw Exception("The transaction body is not a single RLP list");
+		}
+
+		return TransactionView(version, body);
+	}
+
+	static TransactionView FromBytes(
+		const Internal::Obj::BytesBaseObj& rlpBytes
+	)
+	{
+		return FromBytes(rlpBytes.data(), rlpBytes.size());
+	}
+
+public:
+
+	TransactionView(TxnVersion version, const Internal::RlpView& body) :
+		m_version(version),
+		m_body(body)
+	{}
+
+	// LCOV_EXCL_START
+	~TransactionView() = default;
+	// LCOV_EXCL_STOP
+
+	TxnVersion GetVersion() const
+	{
+		return m_version;
+	}
+
+	/**
+	 * @brief Get the RLP list of all fields of the transaction
+	 *
+	 */
+	const Internal::RlpView& GetBody() const
+	{
+		return m_body;
+	}
+
+	/**
+	 * @brief Get the `to` field of the transaction; it's empty if the
+	 *        transaction creates a contract
+	 *
+	 */
+	Internal::RlpView GetContractAddr() const
+	{
+		return GetBytesField(GetTxnContractAddrIdx(m_version));
+	}
+
+	/**
+	 * @brief Get the `data` field of the transaction
+	 *
+	 */
+	Internal::RlpView GetContactParams() const
+	{
+		return GetBytesField(GetTxnContractParamIdx(m_version));
+	}
+
+	bool IsContractAddr(const ContractAddr& addr) const
+	{
+		Internal::RlpView to = GetContractAddr();
+		return (to.GetPayloadSize() == addr.size()) &&
+			std::equal(addr.begin(), addr.end(), to.GetPayload());
+	}
+
+private:
+
+	Internal::RlpView GetBytesField(size_t idx) const
+	{
+		Internal::RlpView field = m_body.GetItem(idx);
+		if (field.IsList())
+		{
+			throw Exception("The transaction field is not a byte string");
+		}
+		return field;
+	}
+
+	TxnVersion m_version;
+	Internal::RlpView m_body;
+
+}; // class TransactionView
+
+
 } // namespace Eth
 } // namespace EclipseMonitor
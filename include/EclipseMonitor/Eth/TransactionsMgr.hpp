@@ -6,10 +6,14 @@
 #pragma once
 
 
+#include <cstddef>
+
 #include <vector>
 
+#include "../Exceptions.hpp"
 #include "../Internal/SimpleObj.hpp"
 #include "../Internal/SimpleRlp.hpp"
+#include "DataTypes.hpp"
 #include "Transaction.hpp"
 #include "Trie/Trie.hpp"
 
@@ -26,12 +30,29 @@ public: // static members
 
 
 	using TransactionListType = std::vector<Transaction>;
+	using RawTxnListType = std::vector<const Internal::Obj::BytesBaseObj*>;
 
 
 public:
 
-	TransactionsMgr(const Internal::Obj::ListBaseObj& transactions) :
+	/**
+	 * @brief Construct a new Transactions Manager, which builds the
+	 *        transaction trie to get the root hash
+	 *
+	 * @param transactions The list of transaction binaries; it must outlive
+	 *                     the manager if any `TransactionView` is needed
+	 * @param isLazy       If true, the transactions are not parsed here, and
+	 *                     they can only be decoded on demand as
+	 *                     `TransactionView`; otherwise, they are all parsed
+	 *                     into `Transaction` as well
+	 */
+	TransactionsMgr(
+		const Internal::Obj::ListBaseObj& transactions,
+		bool isLazy = false
+	) :
+		m_isLazy(isLazy),
 		m_transactions(),
+		m_rawTxns(),
 		m_rootHashBytes()
 	{
 		using _IntWriter = Internal::Rlp::EncodePrimitiveIntValue<
@@ -43,7 +64,11 @@ public:
 			Internal::Rlp::WriterBytesImpl<std::vector<uint8_t> >;
 
 
-		m_transactions.reserve(transactions.size());
+		if (!m_isLazy)
+		{
+			m_transactions.reserve(transactions.size());
+		}
+		m_rawTxns.reserve(transactions.size());
 
 		Trie::PatriciaTrie trie;
 		size_t i = 0;
@@ -61,9 +86,13 @@ public:
 			trie.Put(keyRlp, transactionBytes);
 
 			// 2. transactions
-			m_transactions.emplace_back(
-				Transaction::FromBytes(transactionBytes)
-			);
+			m_rawTxns.push_back(&transactionBytes);
+			if (!m_isLazy)
+			{
+				m_transactions.emplace_back(
+					Transaction::FromBytes(transactionBytes)
+				);
+			}
 
 			++i;
 		}
@@ -78,9 +107,101 @@ public:
 	}
 
 
+	bool IsLazy() const
+	{
+		return m_isLazy;
+	}
+
+
+	size_t GetNumOfTransactions() const
+	{
+		return m_rawTxns.size();
+	}
+
+
+	/**
+	 * @brief Get the parsed transaction at the given index; it's not
+	 *        available in the lazy mode
+	 *
+	 */
+	const Transaction& GetTransaction(size_t idx) const
+	{
+		if (m_isLazy)
+		{
+			throw Exception("Transactions are not parsed in the lazy mode");
+		}
+		if (idx >= m_transactions.size())
+		{
+			throw Exception("The transaction index is out of range");
+		}
+		return m_transactions[idx];
+	}
+
+
+	/**
+	 * @brief Check if the type of the transaction at the given index is
+	 *        supported, so it can be decoded
+	 *
+	 */
+	bool IsTransactionSupported(size_t idx) const
+	{
+		if (idx >= m_rawTxns.size())
+		{
+			throw Exception("The transaction index is out of range");
+		}
+		const Internal::Obj::BytesBaseObj& rawTxn = *(m_rawTxns[idx]);
+		return (rawTxn.size() > 0) && IsTxnTypeSupported(rawTxn.data()[0]);
+	}
+
+
+	/**
+	 * @brief Decode the transaction at the given index on demand
+	 *
+	 */
+	TransactionView GetTransactionView(size_t idx) const
+	{
+		if (idx >= m_rawTxns.size())
+		{
+			throw Exception("The transaction index is out of range");
+		}
+		return TransactionView::FromBytes(*(m_rawTxns[idx]));
+	}
+
+
+	/**
+	 * @brief Search for the transactions sent to the given address; only the
+	 *        envelope and the fields before `to` are decoded for each
+	 *        transaction, and transactions of unsupported types are skipped
+	 *
+	 */
+	std::vector<TransactionView> SearchTransactions(
+		const ContractAddr& addr
+	) const
+	{
+		std::vector<TransactionView> res;
+
+		for (const auto rawTxn : m_rawTxns)
+		{
+			if ((rawTxn->size() == 0) || !IsTxnTypeSupported(rawTxn->data()[0]))
+			{
+				continue;
+			}
+			TransactionView txn = TransactionView::FromBytes(*rawTxn);
+			if (txn.IsContractAddr(addr))
+			{
+				res.push_back(txn);
+			}
+		}
+
+		return res;
+	}
+
+
 private:
 
+	bool m_isLazy;
 	TransactionListType m_transactions;
+	RawTxnListType m_rawTxns;
 	Internal::Obj::Bytes m_rootHashBytes;
 
 }; // class TransactionsMgr
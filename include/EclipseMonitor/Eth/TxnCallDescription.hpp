@@ -0,0 +1,107 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <utility>
+
+#include "DataTypes.hpp"
+#include "HeaderMgr.hpp"
+#include "Keccak256.hpp"
+#include "Transaction.hpp"
+
+
+namespace EclipseMonitor
+{
+namespace Eth
+{
+
+
+/**
+ * @brief The description of a subscription to the transactions calling a
+ *        contract, either any of its functions, or only the function with
+ *        the given 4-byte selector
+ *
+ */
+struct TxnCallDescription
+{
+	/**
+	 * @brief The callback receiving the matched transaction; the view is
+	 *        only valid during the call
+	 *
+	 */
+	using NotifyCallbackType =
+		std::function<void(
+			const HeaderMgr&,
+			const TransactionView&,
+			EventCallbackId
+		)>;
+
+	/**
+	 * @brief Get the function selector (i.e., the first 4 bytes of the
+	 *        Keccak256 hash) of the given function signature, e.g.,
+	 *        "transfer(address,uint256)"
+	 *
+	 */
+	static FuncSelector GetSelector(const std::string& funcSignature)
+	{
+		auto hash = Keccak256(funcSignature);
+		FuncSelector selector;
+		std::copy(hash.begin(), hash.begin() + selector.size(), selector.begin());
+		return selector;
+	}
+
+	/**
+	 * @brief Subscribe to the calls to any function of the contract
+	 *
+	 */
+	TxnCallDescription(
+		ContractAddr       contractAddr,
+		NotifyCallbackType notifyCallback
+	) :
+		m_contractAddr(std::move(contractAddr)),
+		m_hasSelector(false),
+		m_selector(),
+		m_notifyCallback(std::move(notifyCallback))
+	{}
+
+	/**
+	 * @brief Subscribe to the calls to the function of the contract with
+	 *        the given selector
+	 *
+	 */
+	TxnCallDescription(
+		ContractAddr       contractAddr,
+		FuncSelector       selector,
+		NotifyCallbackType notifyCallback
+	) :
+		m_contractAddr(std::move(contractAddr)),
+		m_hasSelector(true),
+		m_selector(std::move(selector)),
+		m_notifyCallback(std::move(notifyCallback))
+	{}
+
+	TxnCallDescription(TxnCallDescription&& other) :
+		m_contractAddr(std::move(other.m_contractAddr)),
+		m_hasSelector(other.m_hasSelector),
+		m_selector(std::move(other.m_selector)),
+		m_notifyCallback(std::move(other.m_notifyCallback))
+	{}
+
+	~TxnCallDescription() = default;
+
+	ContractAddr       m_contractAddr;
+	bool               m_hasSelector;
+	FuncSelector       m_selector;
+	NotifyCallbackType m_notifyCallback;
+}; // struct TxnCallDescription
+
+
+} // namespace Eth
+} // namespace EclipseMonitor
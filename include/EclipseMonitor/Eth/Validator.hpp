@@ -8,6 +8,8 @@
 #include <algorithm>
 #include <memory>
 
+#include "../Internal/Policy.hpp"
+
 #include "DAA.hpp"
 #include "HeaderMgr.hpp"
 
@@ -33,7 +35,19 @@ public:
 	) const = 0;
 };
 
-template<typename _NetConfig>
+/**
+ * @brief The validator of the given network
+ *
+ * @tparam _NetConfig The network configuration
+ * @tparam _DAAType   The type of the difficulty calculator held by the
+ *                    validator; it's either a concrete DAA (e.g.,
+ *                    `MainnetDAA`), so the difficulty calculation can be
+ *                    inlined, or a `std::unique_ptr` to `DAABase`
+ */
+template<
+	typename _NetConfig,
+	typename _DAAType = std::unique_ptr<DAABase>
+>
 class Validator : public ValidatorBase
 {
 public: // Static member:
@@ -41,9 +55,10 @@ public: // Static member:
 	using Self = Validator;
 
 	using NetConfig = _NetConfig;
+	using DAAType = _DAAType;
 
 public:
-	Validator(std::unique_ptr<DAABase> diffCalculator) :
+	Validator(DAAType diffCalculator) :
 		m_diffCalculator(std::move(diffCalculator))
 	{}
 
@@ -90,7 +105,8 @@ public:
 		else
 		{
 			// blocks before Paris, need to check difficulty
-			auto expDiff = (*m_diffCalculator)(parent, current);
+			auto expDiff =
+				Internal::GetPolicy(m_diffCalculator)(parent, current);
 			if (current.GetDiff() != expDiff)
 			{
 				return false;
@@ -105,7 +121,7 @@ public:
 
 private:
 
-	std::unique_ptr<DAABase> m_diffCalculator;
+	DAAType m_diffCalculator;
 }; // class Validator
 
 
@@ -0,0 +1,312 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <array>
+#include <utility>
+#include <vector>
+
+
+namespace EclipseMonitor
+{
+namespace Internal
+{
+
+
+/**
+ * @brief An open-addressing (linear probing) hash map whose keys are
+ *        fixed-size byte arrays that are already uniformly distributed,
+ *        such as block hashes. The first 8 bytes of the key are used as the
+ *        hash value directly, so lookups don't allocate or hash anything.
+ *        All entries are stored in one contiguous array, and erasure uses
+ *        backward shifting, so there are no tombstones.
+ *
+ * @tparam _KeySize The size of the key, in bytes
+ * @tparam _ValType The type of the value; it must be default constructible
+ */
+template<size_t _KeySize, typename _ValType>
+class FixedKeyFlatMap
+{
+public: // static members:
+
+	static_assert(_KeySize >= sizeof(uint64_t),
+		"The key must be at least 8 bytes long");
+
+	using KeyType = std::array<uint8_t, _KeySize>;
+	using ValueType = _ValType;
+
+	static constexpr size_t sk_minCapacity = 16;
+
+public:
+
+	FixedKeyFlatMap() :
+		m_slots(),
+		m_size(0)
+	{}
+
+	// LCOV_EXCL_START
+	~FixedKeyFlatMap() = default;
+	// LCOV_EXCL_STOP
+
+	size_t Size() const
+	{
+		return m_size;
+	}
+
+	bool IsEmpty() const
+	{
+		return m_size == 0;
+	}
+
+	size_t GetCapacity() const
+	{
+		return m_slots.size();
+	}
+
+	/**
+	 * @brief Remove all entries, while keeping the allocated capacity
+	 *
+	 */
+	void Clear()
+	{
+		for (auto& slot : m_slots)
+		{
+			slot = Slot();
+		}
+		m_size = 0;
+	}
+
+	/**
+	 * @brief Make sure `numOfEntries` entries can be stored without
+	 *        rehashing
+	 *
+	 */
+	void Reserve(size_t numOfEntries)
+	{
+		size_t capacity = m_slots.size();
+		if (numOfEntries <= MaxNumOfEntries(capacity))
+		{
+			return;
+		}
+
+		capacity = (capacity == 0) ? sk_minCapacity : capacity;
+		while (numOfEntries > MaxNumOfEntries(capacity))
+		{
+			capacity *= 2;
+		}
+		Rehash(capacity);
+	}
+
+	/**
+	 * @brief Find the value with the given key
+	 *
+	 * @return a pointer to the value, or `nullptr` if the key is not found;
+	 *         the pointer is invalidated by any following insertion or erasure
+	 */
+	_ValType* Find(const KeyType& key)
+	{
+		size_t idx = 0;
+		return FindIndex(key, idx) ? &(m_slots[idx].m_val) : nullptr;
+	}
+
+	const _ValType* Find(const KeyType& key) const
+	{
+		size_t idx = 0;
+		return FindIndex(key, idx) ? &(m_slots[idx].m_val) : nullptr;
+	}
+
+	/**
+	 * @brief Insert a new entry, if the key doesn't exist yet
+	 *
+	 * @return true if the entry is inserted, false if the key already exists
+	 */
+	bool Insert(const KeyType& key, _ValType val)
+	{
+		if (Find(key) != nullptr)
+		{
+			return false;
+		}
+
+		Reserve(m_size + 1);
+		Place(key, std::move(val));
+		++m_size;
+		return true;
+	}
+
+	/**
+	 * @brief Insert a new entry, or replace the value if the key already
+	 *        exists
+	 *
+	 */
+	void InsertOrAssign(const KeyType& key, _ValType val)
+	{
+		_ValType* existing = Find(key);
+		if (existing != nullptr)
+		{
+			*existing = std::move(val);
+			return;
+		}
+
+		Reserve(m_size + 1);
+		Place(key, std::move(val));
+		++m_size;
+	}
+
+	/**
+	 * @brief Erase the entry with the given key
+	 *
+	 * @return the number of entries erased (i.e., 0 or 1)
+	 */
+	size_t Erase(const KeyType& key)
+	{
+		size_t idx = 0;
+		if (!FindIndex(key, idx))
+		{
+			return 0;
+		}
+
+		// backward shift the following entries in the same probe sequence,
+		// so lookups never need to skip deleted slots
+		const size_t mask = m_slots.size() - 1;
+		size_t hole = idx;
+		size_t next = idx;
+		while (true)
+		{
+			next = (next + 1) & mask;
+			if (!m_slots[next].m_isUsed)
+			{
+				break;
+			}
+
+			size_t home = HomeIndex(m_slots[next].m_key, mask);
+			// distance from the home index to the current position, and
+			// to the hole; the entry can be moved into the hole only if
+			// the hole is not before its home index
+			size_t distNext = (next - home) & mask;
+			size_t distHole = (hole - home) & mask;
+			if (distHole <= distNext)
+			{
+				m_slots[hole] = std::move(m_slots[next]);
+				hole = next;
+			}
+		}
+		m_slots[hole] = Slot();
+		--m_size;
+
+		return 1;
+	}
+
+	/**
+	 * @brief Call `func(key, value)` for every entry in the map.
+	 *        The map must not be modified inside the callback.
+	 *
+	 */
+	template<typename _FuncType>
+	void ForEach(_FuncType func) const
+	{
+		for (const auto& slot : m_slots)
+		{
+			if (slot.m_isUsed)
+			{
+				func(slot.m_key, slot.m_val);
+			}
+		}
+	}
+
+private: // static members:
+
+	struct Slot
+	{
+		Slot() :
+			m_key(),
+			m_val(),
+			m_isUsed(false)
+		{}
+
+		KeyType m_key;
+		_ValType m_val;
+		bool m_isUsed;
+	}; // struct Slot
+
+	static size_t MaxNumOfEntries(size_t capacity)
+	{
+		// keep the load factor at most 3/4
+		return (capacity / 4) * 3;
+	}
+
+	static size_t HomeIndex(const KeyType& key, size_t mask)
+	{
+		uint64_t hashVal = 0;
+		std::memcpy(&hashVal, key.data(), sizeof(hashVal));
+		return static_cast<size_t>(hashVal) & mask;
+	}
+
+private:
+
+	bool FindIndex(const KeyType& key, size_t& outIdx) const
+	{
+		if (m_size == 0)
+		{
+			return false;
+		}
+
+		const size_t mask = m_slots.size() - 1;
+		size_t idx = HomeIndex(key, mask);
+		while (m_slots[idx].m_isUsed)
+		{
+			if (m_slots[idx].m_key == key)
+			{
+				outIdx = idx;
+				return true;
+			}
+			idx = (idx + 1) & mask;
+		}
+		return false;
+	}
+
+	void Place(const KeyType& key, _ValType val)
+	{
+		const size_t mask = m_slots.size() - 1;
+		size_t idx = HomeIndex(key, mask);
+		while (m_slots[idx].m_isUsed)
+		{
+			idx = (idx + 1) & mask;
+		}
+		m_slots[idx].m_key = key;
+		m_slots[idx].m_val = std::move(val);
+		m_slots[idx].m_isUsed = true;
+	}
+
+	void Rehash(size_t capacity)
+	{
+		std::vector<Slot> oldSlots(capacity);
+		oldSlots.swap(m_slots);
+		for (auto& slot : oldSlots)
+		{
+			if (slot.m_isUsed)
+			{
+				Place(slot.m_key, std::move(slot.m_val));
+			}
+		}
+	}
+
+	std::vector<Slot> m_slots;
+	size_t m_size;
+
+}; // class FixedKeyFlatMap
+
+
+template<size_t _KeySize, typename _ValType>
+constexpr size_t FixedKeyFlatMap<_KeySize, _ValType>::sk_minCapacity;
+
+
+} // namespace Internal
+} // namespace EclipseMonitor
@@ -0,0 +1,178 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <cstddef>
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+
+namespace EclipseMonitor
+{
+namespace Internal
+{
+
+
+/**
+ * @brief A vector-like container that keeps up to `_N` elements inside the
+ *        object itself, and only moves them to the heap when more elements
+ *        are added. The elements are always stored contiguously.
+ *        `_T` must be default constructible and move assignable; slots that
+ *        are not in use hold default constructed values.
+ *
+ * @tparam _T The element type
+ * @tparam _N The number of elements stored inline
+ */
+template<typename _T, size_t _N>
+class InlineVector
+{
+public: // static members:
+
+	using value_type = _T;
+	using iterator = _T*;
+	using const_iterator = const _T*;
+
+	static constexpr size_t sk_inlineSize = _N;
+
+public:
+
+	InlineVector() :
+		m_inline(),
+		m_inlineSize(0),
+		m_heap()
+	{}
+
+	InlineVector(const InlineVector&) = delete;
+
+	InlineVector& operator=(const InlineVector&) = delete;
+
+	// LCOV_EXCL_START
+	~InlineVector() = default;
+	// LCOV_EXCL_STOP
+
+	size_t size() const
+	{
+		return IsOnHeap() ? m_heap.size() : m_inlineSize;
+	}
+
+	bool empty() const
+	{
+		return size() == 0;
+	}
+
+	/**
+	 * @brief Check if the elements have been moved to the heap
+	 *
+	 */
+	bool IsOnHeap() const
+	{
+		return !m_heap.empty();
+	}
+
+	_T* data()
+	{
+		return IsOnHeap() ? m_heap.data() : m_inline.data();
+	}
+
+	const _T* data() const
+	{
+		return IsOnHeap() ? m_heap.data() : m_inline.data();
+	}
+
+	iterator begin()
+	{
+		return data();
+	}
+
+	iterator end()
+	{
+		return data() + size();
+	}
+
+	const_iterator begin() const
+	{
+		return data();
+	}
+
+	const_iterator end() const
+	{
+		return data() + size();
+	}
+
+	_T& operator[](size_t i)
+	{
+		return data()[i];
+	}
+
+	const _T& operator[](size_t i) const
+	{
+		return data()[i];
+	}
+
+	template<typename... _Args>
+	_T& emplace_back(_Args&&... args)
+	{
+		if (!IsOnHeap())
+		{
+			if (m_inlineSize < _N)
+			{
+				_T& slot = m_inline[m_inlineSize];
+				slot = _T(std::forward<_Args>(args)...);
+				++m_inlineSize;
+				return slot;
+			}
+
+			// the inline storage is full, move everything to the heap
+			m_heap.reserve(_N * 2);
+			for (size_t i = 0; i < m_inlineSize; ++i)
+			{
+				m_heap.push_back(std::move(m_inline[i]));
+				m_inline[i] = _T();
+			}
+			m_inlineSize = 0;
+		}
+
+		m_heap.emplace_back(std::forward<_Args>(args)...);
+		return m_heap.back();
+	}
+
+	iterator erase(iterator pos)
+	{
+		if (IsOnHeap())
+		{
+			size_t idx = static_cast<size_t>(pos - m_heap.data());
+			m_heap.erase(m_heap.begin() + idx);
+			// if the heap storage becomes empty, we are back to the inline
+			// storage, which is also empty
+			return m_heap.empty() ? m_inline.data() : (m_heap.data() + idx);
+		}
+
+		std::move(pos + 1, m_inline.data() + m_inlineSize, pos);
+		--m_inlineSize;
+		// reset the slot that is no longer in use
+		m_inline[m_inlineSize] = _T();
+		return pos;
+	}
+
+private:
+
+	std::array<_T, _N> m_inline;
+	size_t m_inlineSize;
+	std::vector<_T> m_heap;
+
+}; // class InlineVector
+
+
+template<typename _T, size_t _N>
+constexpr size_t InlineVector<_T, _N>::sk_inlineSize;
+
+
+} // namespace Internal
+} // namespace EclipseMonitor
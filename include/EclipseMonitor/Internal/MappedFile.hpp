@@ -0,0 +1,237 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../Exceptions.hpp"
+
+
+namespace EclipseMonitor
+{
+namespace Internal
+{
+
+
+/**
+ * @brief A file that is mapped into memory as a whole, with `MAP_SHARED`,
+ *        so writes to the mapping go to the file, and other processes
+ *        mapping the same file see them.
+ *        This header requires POSIX file and memory-mapping APIs, so it's
+ *        only meant for the host side.
+ *
+ */
+class MappedFile
+{
+public:
+
+	/**
+	 * @brief Open (or create, if it's writable) the file and map it
+	 *
+	 * @param path       The path to the file
+	 * @param isReadOnly Whether the file is opened read-only; a read-only
+	 *                   file must exist and can't be resized
+	 */
+	MappedFile(const std::string& path, bool isReadOnly) :
+		m_path(path),
+		m_isReadOnly(isReadOnly),
+		m_fd(-1),
+		m_data(nullptr),
+		m_size(0)
+	{
+		m_fd = Open();
+
+		try
+		{
+			Map(GetFileSize());
+		}
+		catch (...)
+		{
+			::close(m_fd);
+			throw;
+		}
+	}
+
+	MappedFile(const MappedFile&) = delete;
+
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	~MappedFile()
+	{
+		Unmap();
+		::close(m_fd);
+	}
+
+	const std::string& GetPath() const
+	{
+		return m_path;
+	}
+
+	bool IsReadOnly() const
+	{
+		return m_isReadOnly;
+	}
+
+	size_t GetSize() const
+	{
+		return m_size;
+	}
+
+	uint8_t* GetData()
+	{
+		return m_data;
+	}
+
+	const uint8_t* GetData() const
+	{
+		return m_data;
+	}
+
+	/**
+	 * @brief Change the size of the file, and map it again; all pointers
+	 *        into the old mapping are invalidated. New bytes are zeros.
+	 *
+	 */
+	void Resize(size_t size)
+	{
+		if (m_isReadOnly)
+		{
+			throw Exception("The mapped file is read-only");
+		}
+		Unmap();
+		if (::ftruncate(m_fd, static_cast<off_t>(size)) != 0)
+		{
+			throw Exception("Failed to resize the mapped file");
+		}
+		Map(size);
+	}
+
+	/**
+	 * @brief Map the file again if its size has been changed by others, or
+	 *        open the file at the path again if it has been replaced (e.g.,
+	 *        by `rename`); all pointers into the old mapping are
+	 *        invalidated if so
+	 *
+	 */
+	void Refresh()
+	{
+		struct stat pathStat;
+		struct stat fileStat;
+		if ((::stat(m_path.c_str(), &pathStat) == 0) &&
+			(::fstat(m_fd, &fileStat) == 0) &&
+			((pathStat.st_dev != fileStat.st_dev) ||
+				(pathStat.st_ino != fileStat.st_ino)))
+		{
+			Reopen();
+			return;
+		}
+
+		size_t size = GetFileSize();
+		if (size != m_size)
+		{
+			Unmap();
+			Map(size);
+		}
+	}
+
+	/**
+	 * @brief Open the file at the path again, and map it; all pointers
+	 *        into the old mapping are invalidated
+	 *
+	 */
+	void Reopen()
+	{
+		int fd = Open();
+		Unmap();
+		::close(m_fd);
+		m_fd = fd;
+		Map(GetFileSize());
+	}
+
+	/**
+	 * @brief Write the changes made to the mapping back to the file
+	 *
+	 */
+	void Sync()
+	{
+		if ((m_data != nullptr) && (::msync(m_data, m_size, MS_SYNC) != 0))
+		{
+			throw Exception("Failed to sync the mapped file");
+		}
+	}
+
+private:
+
+	int Open() const
+	{
+		int fd = m_isReadOnly ?
+			::open(m_path.c_str(), O_RDONLY | O_CLOEXEC) :
+			::open(m_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+		if (fd < 0)
+		{
+			throw Exception("Failed to open file " + m_path);
+		}
+		return fd;
+	}
+
+	size_t GetFileSize() const
+	{
+		struct stat fileStat;
+		if (::fstat(m_fd, &fileStat) != 0)
+		{
+			throw Exception("Failed to get the size of the mapped file");
+		}
+		return static_cast<size_t>(fileStat.st_size);
+	}
+
+	void Map(size_t size)
+	{
+		if (size == 0)
+		{
+			// empty files can't be mapped
+			return;
+		}
+
+		int prot = m_isReadOnly ? PROT_READ : (PROT_READ | PROT_WRITE);
+		void* addr = ::mmap(nullptr, size, prot, MAP_SHARED, m_fd, 0);
+		if (addr == MAP_FAILED)
+		{
+			throw Exception("Failed to map the file");
+		}
+		m_data = static_cast<uint8_t*>(addr);
+		m_size = size;
+	}
+
+	void Unmap()
+	{
+		if (m_data != nullptr)
+		{
+			::munmap(m_data, m_size);
+		}
+		m_data = nullptr;
+		m_size = 0;
+	}
+
+	std::string m_path;
+	bool m_isReadOnly;
+	int m_fd;
+	uint8_t* m_data;
+	size_t m_size;
+
+}; // class MappedFile
+
+
+} // namespace Internal
+} // namespace EclipseMonitor
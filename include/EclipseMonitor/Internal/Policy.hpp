@@ -0,0 +1,48 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <memory>
+
+
+namespace EclipseMonitor
+{
+namespace Internal
+{
+
+
+/**
+ * @brief Access a policy object (e.g., a validator, a difficulty checker, or
+ *        a DAA) held by a class template, which can either be the policy
+ *        object itself, held by value so the calls are statically dispatched,
+ *        or a `std::unique_ptr` to a polymorphic base class, so the policy
+ *        can be chosen at runtime.
+ *
+ */
+template<typename _PolicyType>
+inline _PolicyType& GetPolicy(_PolicyType& policy)
+{
+	return policy;
+}
+
+template<typename _PolicyType>
+inline _PolicyType& GetPolicy(std::unique_ptr<_PolicyType>& policy)
+{
+	return *policy;
+}
+
+template<typename _PolicyType>
+inline const _PolicyType& GetPolicy(
+	const std::unique_ptr<_PolicyType>& policy
+)
+{
+	return *policy;
+}
+
+
+} // namespace Internal
+} // namespace EclipseMonitor
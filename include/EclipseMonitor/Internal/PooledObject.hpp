@@ -0,0 +1,153 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <cstddef>
+
+#include <mutex>
+#include <new>
+
+
+namespace EclipseMonitor
+{
+namespace Internal
+{
+
+
+/**
+ * @brief A base class that gives the derived class `_T` a class-specific
+ *        `operator new` and `operator delete`, which recycle the memory
+ *        blocks freed by previous objects, instead of returning them to the
+ *        global heap right away.
+ *        Objects are still owned by `std::unique_ptr` as usual.
+ *        Allocations with a size other than `sizeof(_T)` (e.g., classes
+ *        further derived from `_T`) simply go to the global heap.
+ *
+ * @tparam _T           The derived class
+ * @tparam _MaxNumOfFree The maximum number of free memory blocks kept in the
+ *                       pool; blocks freed beyond this number are returned
+ *                       to the global heap
+ */
+template<typename _T, size_t _MaxNumOfFree>
+class PooledObject
+{
+public: // static members:
+
+	static constexpr size_t sk_maxNumOfFree = _MaxNumOfFree;
+
+	static void* operator new(size_t size)
+	{
+		if (size == sizeof(_T))
+		{
+			PoolState& state = GetState();
+			std::lock_guard<std::mutex> lock(state.m_mutex);
+			if (state.m_head != nullptr)
+			{
+				FreeBlock* block = state.m_head;
+				state.m_head = block->m_next;
+				--state.m_numOfFree;
+				return block;
+			}
+		}
+		return ::operator new(size);
+	}
+
+	static void operator delete(void* ptr, size_t size)
+	{
+		if (ptr == nullptr)
+		{
+			return;
+		}
+		if (size == sizeof(_T))
+		{
+			PoolState& state = GetState();
+			std::lock_guard<std::mutex> lock(state.m_mutex);
+			if (state.m_numOfFree < sk_maxNumOfFree)
+			{
+				FreeBlock* block = static_cast<FreeBlock*>(ptr);
+				block->m_next = state.m_head;
+				state.m_head = block;
+				++state.m_numOfFree;
+				return;
+			}
+		}
+		::operator delete(ptr);
+	}
+
+	/**
+	 * @brief Get the number of free memory blocks currently kept in the pool
+	 *
+	 */
+	static size_t GetNumOfFree()
+	{
+		PoolState& state = GetState();
+		std::lock_guard<std::mutex> lock(state.m_mutex);
+		return state.m_numOfFree;
+	}
+
+	/**
+	 * @brief Return all free memory blocks kept in the pool to the global heap
+	 *
+	 */
+	static void ReleaseFree()
+	{
+		PoolState& state = GetState();
+		std::lock_guard<std::mutex> lock(state.m_mutex);
+		while (state.m_head != nullptr)
+		{
+			FreeBlock* block = state.m_head;
+			state.m_head = block->m_next;
+			::operator delete(block);
+		}
+		state.m_numOfFree = 0;
+	}
+
+private: // static members:
+
+	struct FreeBlock
+	{
+		FreeBlock* m_next;
+	}; // struct FreeBlock
+
+	struct PoolState
+	{
+		PoolState() :
+			m_mutex(),
+			m_head(nullptr),
+			m_numOfFree(0)
+		{}
+
+		std::mutex m_mutex;
+		FreeBlock* m_head;
+		size_t m_numOfFree;
+	}; // struct PoolState
+
+	static PoolState& GetState()
+	{
+		// The state is never destroyed, so objects freed during the static
+		// destruction stage can still be handled safely
+		static PoolState* inst = new PoolState();
+		return *inst;
+	}
+
+protected:
+
+	PooledObject() = default;
+
+	// LCOV_EXCL_START
+	~PooledObject() = default;
+	// LCOV_EXCL_STOP
+
+}; // class PooledObject
+
+
+template<typename _T, size_t _MaxNumOfFree>
+constexpr size_t PooledObject<_T, _MaxNumOfFree>::sk_maxNumOfFree;
+
+
+} // namespace Internal
+} // namespace EclipseMonitor
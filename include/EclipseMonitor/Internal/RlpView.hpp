@@ -0,0 +1,271 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../Exceptions.hpp"
+
+
+namespace EclipseMonitor
+{
+namespace Internal
+{
+
+
+/**
+ * @brief A view of one RLP-encoded item inside a byte buffer, which only
+ *        records where the item and its payload are, so nothing is copied
+ *        or allocated when decoding it.
+ *        The buffer must outlive the view.
+ *
+ */
+class RlpView
+{
+public: // static members:
+
+	/**
+	 * @brief Decode the RLP item at the beginning of the given buffer; the
+	 *        buffer may contain more bytes after the item
+	 *
+	 */
+	static RlpView Decode(const uint8_t* data, size_t size)
+	{
+		if (size == 0)
+		{
+			throw Exception("RLP - Unexpected end of input");
+		}
+
+		const uint8_t firstByte = data[0];
+		if (firstByte < 0x80U)
+		{
+			// single byte
+			return RlpView(data, 1, data, 1, false);
+		}
+		else if (firstByte <= 0xB7U)
+		{
+			// short bytes
+			return FromPayloadSize(data, size, 1, firstByte - 0x80U, false);
+		}
+		else if (firstByte <= 0xBFU)
+		{
+			// long bytes
+			size_t lenSize = firstByte - 0xB7U;
+			return FromPayloadSize(
+				data,
+				size,
+				1 + lenSize,
+				DecodeLength(data, size, lenSize),
+				false
+			);
+		}
+		else if (firstByte <= 0xF7U)
+		{
+			// short list
+			return FromPayloadSize(data, size, 1, firstByte - 0xC0U, true);
+		}
+		else
+		{
+			// long list
+			size_t lenSize = firstByte - 0xF7U;
+			return FromPayloadSize(
+				data,
+				size,
+				1 + lenSize,
+				DecodeLength(data, size, lenSize),
+				true
+			);
+		}
+	}
+
+public:
+
+	RlpView() :
+		m_data(nullptr),
+		m_size(0),
+		m_payload(nullptr),
+		m_payloadSize(0),
+		m_isList(false)
+	{}
+
+	// LCOV_EXCL_START
+	~RlpView() = default;
+	// LCOV_EXCL_STOP
+
+	bool IsList() const
+	{
+		return m_isList;
+	}
+
+	/**
+	 * @brief Get the pointer to the whole encoded item
+	 *
+	 */
+	const uint8_t* GetData() const
+	{
+		return m_data;
+	}
+
+	/**
+	 * @brief Get the size of the whole encoded item
+	 *
+	 */
+	size_t GetSize() const
+	{
+		return m_size;
+	}
+
+	const uint8_t* GetPayload() const
+	{
+		return m_payload;
+	}
+
+	size_t GetPayloadSize() const
+	{
+		return m_payloadSize;
+	}
+
+	/**
+	 * @brief Get the item at the given index of this list, by skipping the
+	 *        items before it
+	 *
+	 */
+	RlpView GetItem(size_t idx) const
+	{
+		if (!m_isList)
+		{
+			throw Exception("RLP - The item is not a list");
+		}
+
+		const uint8_t* ptr = m_payload;
+		size_t remaining = m_payloadSize;
+		while (true)
+		{
+			RlpView item = Decode(ptr, remaining);
+			if (idx == 0)
+			{
+				return item;
+			}
+			--idx;
+			ptr += item.m_size;
+			remaining -= item.m_size;
+		}
+	}
+
+	/**
+	 * @brief Get the number of items in this list
+	 *
+	 */
+	size_t GetNumOfItems() const
+	{
+		if (!m_isList)
+		{
+			throw Exception("RLP - The item is not a list");
+		}
+
+		size_t num = 0;
+		const uint8_t* ptr = m_payload;
+		size_t remaining = m_payloadSize;
+		while (remaining > 0)
+		{
+			RlpView item = Decode(ptr, remaining);
+			ptr += item.m_size;
+			remaining -= item.m_size;
+			++num;
+		}
+		return num;
+	}
+
+private: // static members:
+
+	static size_t DecodeLength(
+		const uint8_t* data,
+		size_t size,
+		size_t lenSize
+	)
+	{
+		if (lenSize > sizeof(size_t))
+		{
+			throw Exception("RLP - The length is too large");
+		}
+		if ((1 + lenSize) > size)
+		{
+			throw Exception("RLP - Unexpected end of input");
+		}
+		if (data[1] == 0)
+		{
+			throw Exception("RLP - The length has leading zeros");
+		}
+
+		size_t len = 0;
+		for (size_t i = 1; i <= lenSize; ++i)
+		{
+			len = (len << 8) | data[i];
+		}
+		if (len <= 55)
+		{
+			throw Exception("RLP - The length should be in short form");
+		}
+		return len;
+	}
+
+	static RlpView FromPayloadSize(
+		const uint8_t* data,
+		size_t size,
+		size_t prefixSize,
+		size_t payloadSize,
+		bool isList
+	)
+	{
+		if ((prefixSize > size) || (payloadSize > (size - prefixSize)))
+		{
+			throw Exception("RLP - Unexpected end of input");
+		}
+		if (!isList &&
+			(prefixSize == 1) &&
+			(payloadSize == 1) &&
+			(data[1] < 0x80U))
+		{
+			throw Exception("RLP - The byte should be encoded by itself");
+		}
+		return RlpView(
+			data,
+			prefixSize + payloadSize,
+			data + prefixSize,
+			payloadSize,
+			isList
+		);
+	}
+
+private:
+
+	RlpView(
+		const uint8_t* data,
+		size_t size,
+		const uint8_t* payload,
+		size_t payloadSize,
+		bool isList
+	) :
+		m_data(data),
+		m_size(size),
+		m_payload(payload),
+		m_payloadSize(payloadSize),
+		m_isList(isList)
+	{}
+
+	const uint8_t* m_data;
+	size_t m_size;
+	const uint8_t* m_payload;
+	size_t m_payloadSize;
+	bool m_isList;
+
+}; // class RlpView
+
+
+} // namespace Internal
+} // namespace EclipseMonitor
@@ -0,0 +1,175 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <cstddef>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "../Exceptions.hpp"
+
+
+namespace EclipseMonitor
+{
+namespace Internal
+{
+
+
+/**
+ * @brief A window of the last `capacity` values pushed into it, which keeps
+ *        the values sorted, so any order statistic (e.g., the median) can be
+ *        read in O(1). Pushing a value into a full window evicts the oldest
+ *        one, so it can be used as a sliding window as well as a tumbling
+ *        one (by clearing it).
+ *        All memory is allocated at construction; pushing is a binary search
+ *        plus a shift inside one contiguous array, which is faster than a
+ *        node-based tree for the window sizes used by the monitor.
+ *
+ * @tparam _ValType The type of the value; it must be copyable and less-than
+ *                  comparable
+ */
+template<typename _ValType>
+class SortedWindow
+{
+public: // static members:
+
+	using ValueType = _ValType;
+
+public:
+
+	explicit SortedWindow(size_t capacity) :
+		m_capacity(capacity > 0 ? capacity : 1),
+		m_sorted(),
+		m_arrival(),
+		m_oldestIdx(0)
+	{
+		m_sorted.reserve(m_capacity);
+		m_arrival.reserve(m_capacity);
+	}
+
+	// LCOV_EXCL_START
+	~SortedWindow() = default;
+	// LCOV_EXCL_STOP
+
+	size_t Size() const
+	{
+		return m_sorted.size();
+	}
+
+	bool IsEmpty() const
+	{
+		return m_sorted.empty();
+	}
+
+	size_t GetCapacity() const
+	{
+		return m_capacity;
+	}
+
+	/**
+	 * @brief Remove all values, while keeping the allocated memory
+	 *
+	 */
+	void Clear()
+	{
+		m_sorted.clear();
+		m_arrival.clear();
+		m_oldestIdx = 0;
+	}
+
+	void Swap(SortedWindow& other)
+	{
+		std::swap(m_capacity, other.m_capacity);
+		m_sorted.swap(other.m_sorted);
+		m_arrival.swap(other.m_arrival);
+		std::swap(m_oldestIdx, other.m_oldestIdx);
+	}
+
+	/**
+	 * @brief Add a new value to the window; if the window is full, the
+	 *        oldest value is evicted first
+	 *
+	 */
+	void Push(const _ValType& val)
+	{
+		if (m_arrival.size() < m_capacity)
+		{
+			m_arrival.push_back(val);
+		}
+		else
+		{
+			_ValType& oldest = m_arrival[m_oldestIdx];
+			// any equal value can be removed, since they are not
+			// distinguishable in the sorted array
+			auto it = std::lower_bound(
+				m_sorted.begin(),
+				m_sorted.end(),
+				oldest
+			);
+			m_sorted.erase(it);
+
+			oldest = val;
+			m_oldestIdx = (m_oldestIdx + 1) % m_capacity;
+		}
+
+		m_sorted.insert(
+			std::upper_bound(m_sorted.begin(), m_sorted.end(), val),
+			val
+		);
+	}
+
+	/**
+	 * @brief Get the value at the given position, as if the values are
+	 *        sorted in ascending order
+	 *
+	 */
+	const _ValType& GetNth(size_t pos) const
+	{
+		if (pos >= m_sorted.size())
+		{
+			throw Exception("The position is out of the window");
+		}
+		return m_sorted[pos];
+	}
+
+	/**
+	 * @brief Get the value at the position of (size * percent / 100), as if
+	 *        the values are sorted in ascending order; e.g., 0 gives the
+	 *        minimum, 50 gives the value at (size // 2), and 100 gives the
+	 *        maximum
+	 *
+	 */
+	const _ValType& GetPercentile(size_t percent) const
+	{
+		if (percent > 100)
+		{
+			throw Exception("The percentile must be within [0, 100]");
+		}
+		if (m_sorted.empty())
+		{
+			throw Exception("The window is empty");
+		}
+		size_t pos = (m_sorted.size() * percent) / 100;
+		return m_sorted[std::min(pos, m_sorted.size() - 1)];
+	}
+
+private:
+
+	size_t m_capacity;
+	// values sorted in ascending order
+	std::vector<_ValType> m_sorted;
+	// values in the order they were pushed, as a ring once it's full
+	std::vector<_ValType> m_arrival;
+	size_t m_oldestIdx;
+
+}; // class SortedWindow
+
+
+} // namespace Internal
+} // namespace EclipseMonitor
@@ -0,0 +1,115 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <cstddef>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "Logging.hpp"
+
+
+namespace EclipseMonitor
+{
+
+
+/**
+ * @brief Drain a `LogRingBuffer` periodically on a background thread, and
+ *        pass the records to the writer in batches.
+ *        `Flush` can be called from any thread to drain the ring right away;
+ *        the remaining records are also drained when the drainer is
+ *        destroyed.
+ *        This header requires the C++ thread support library; where it's
+ *        not available (e.g., inside an enclave), call `LogRingBuffer::Drain`
+ *        directly instead.
+ *
+ * @tparam _RingType The type of the ring buffer
+ */
+template<typename _RingType>
+class LogRingDrainer
+{
+public: // static members:
+
+	using RecordType = typename _RingType::Record;
+	using WriterType = std::function<void(const RecordType*, size_t)>;
+
+public:
+
+	LogRingDrainer(
+		std::shared_ptr<_RingType> ring,
+		WriterType writer,
+		std::chrono::milliseconds interval = std::chrono::milliseconds(100)
+	) :
+		m_ring(std::move(ring)),
+		m_writer(std::move(writer)),
+		m_interval(interval),
+		m_drainMutex(),
+		m_stopMutex(),
+		m_stopCond(),
+		m_isStopped(false),
+		m_thread()
+	{
+		m_thread = std::thread([this](){ this->DrainLoop(); });
+	}
+
+	LogRingDrainer(const LogRingDrainer&) = delete;
+
+	LogRingDrainer& operator=(const LogRingDrainer&) = delete;
+
+	~LogRingDrainer()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_stopMutex);
+			m_isStopped = true;
+		}
+		m_stopCond.notify_all();
+		m_thread.join();
+
+		Flush();
+	}
+
+	/**
+	 * @brief Drain all pending records now
+	 *
+	 * @return the number of records drained
+	 */
+	size_t Flush()
+	{
+		std::lock_guard<std::mutex> lock(m_drainMutex);
+		return m_ring->Drain(m_writer);
+	}
+
+private:
+
+	void DrainLoop()
+	{
+		std::unique_lock<std::mutex> lock(m_stopMutex);
+		while (!m_isStopped)
+		{
+			m_stopCond.wait_for(lock, m_interval);
+			Flush();
+		}
+	}
+
+	std::shared_ptr<_RingType> m_ring;
+	WriterType m_writer;
+	std::chrono::milliseconds m_interval;
+	// there is only one consumer at a time
+	std::mutex m_drainMutex;
+	std::mutex m_stopMutex;
+	std::condition_variable m_stopCond;
+	bool m_isStopped;
+	std::thread m_thread;
+}; // class LogRingDrainer
+
+
+} // namespace EclipseMonitor
@@ -6,13 +6,280 @@
 #pragma once
 
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include "Config.hpp"
 
 
+#define ECLIPSEMONITOR_LOGGING_LEVEL_DEBUG 0
+#define ECLIPSEMONITOR_LOGGING_LEVEL_INFO  1
+#define ECLIPSEMONITOR_LOGGING_LEVEL_WARN  2
+#define ECLIPSEMONITOR_LOGGING_LEVEL_ERROR 3
+#define ECLIPSEMONITOR_LOGGING_LEVEL_OFF   4
+
+
+namespace EclipseMonitor
+{
+
+
+enum class LogLevel
+{
+	Debug = ECLIPSEMONITOR_LOGGING_LEVEL_DEBUG,
+	Info  = ECLIPSEMONITOR_LOGGING_LEVEL_INFO,
+	Warn  = ECLIPSEMONITOR_LOGGING_LEVEL_WARN,
+	Error = ECLIPSEMONITOR_LOGGING_LEVEL_ERROR,
+}; // enum class LogLevel
+
+
+inline const char* GetLogLevelName(LogLevel level)
+{
+	switch (level)
+	{
+	case LogLevel::Debug:
+		return "DEBUG";
+	case LogLevel::Info:
+		return "INFO";
+	case LogLevel::Warn:
+		return "WARN";
+	case LogLevel::Error:
+	default:
+		return "ERROR";
+	}
+}
+
+
+/**
+ * @brief A lock-free single-producer single-consumer ring buffer of
+ *        fixed-size log records.
+ *        The producer (i.e., the thread that logs) only copies the message
+ *        into a pre-allocated record, and never blocks or allocates; if the
+ *        ring is full, the message is dropped and counted.
+ *        The consumer takes all pending records in batches, so they can be
+ *        written out with a single I/O (or a single enclave boundary
+ *        crossing) per batch; see `LogRingDrainer` in LogRingDrainer.hpp
+ *        for a consumer running on a background thread.
+ *        NOTE: only one thread may log into a ring at a time; use separate
+ *        rings for loggers used by different threads.
+ *
+ * @tparam _NumOfRecords The number of records in the ring; must be a power
+ *                       of 2
+ * @tparam _MsgSize      The maximum size of a message, in bytes; longer
+ *                       messages are truncated
+ */
+template<size_t _NumOfRecords, size_t _MsgSize>
+class LogRingBuffer
+{
+public: // static members:
+
+	static_assert(
+		(_NumOfRecords > 0) && ((_NumOfRecords & (_NumOfRecords - 1)) == 0),
+		"The number of records must be a power of 2"
+	);
+	static_assert(_MsgSize <= UINT16_MAX, "The message size is too large");
+
+	static constexpr size_t sk_numOfRecords = _NumOfRecords;
+	static constexpr size_t sk_msgSize = _MsgSize;
+	static constexpr size_t sk_nameSize = 32;
+
+	struct Record
+	{
+		std::string GetName() const
+		{
+			return std::string(m_name, m_nameLen);
+		}
+
+		std::string GetMsg() const
+		{
+			return std::string(m_msg, m_msgLen);
+		}
+
+		LogLevel m_level;
+		uint8_t  m_nameLen;
+		uint16_t m_msgLen;
+		char     m_name[sk_nameSize];
+		char     m_msg[_MsgSize];
+	}; // struct Record
+
+public:
+
+	LogRingBuffer() :
+		m_head(0),
+		m_headPad(),
+		m_tail(0),
+		m_tailPad(),
+		m_numOfDropped(0),
+		m_records()
+	{}
+
+	LogRingBuffer(const LogRingBuffer&) = delete;
+
+	LogRingBuffer& operator=(const LogRingBuffer&) = delete;
+
+	// LCOV_EXCL_START
+	~LogRingBuffer() = default;
+	// LCOV_EXCL_STOP
+
+	/**
+	 * @brief Copy a message into the ring; called by the producer only
+	 *
+	 * @return true if the message is added, false if the ring is full and
+	 *         the message is dropped
+	 */
+	bool TryPush(LogLevel level, const std::string& name, const std::string& msg)
+	{
+		const size_t tail = m_tail.load(std::memory_order_relaxed);
+		const size_t head = m_head.load(std::memory_order_acquire);
+		if (tail - head >= _NumOfRecords)
+		{
+			m_numOfDropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		Record& record = m_records[tail & (_NumOfRecords - 1)];
+		const size_t nameLen = std::min(name.size(), sk_nameSize);
+		const size_t msgLen = std::min(msg.size(), _MsgSize);
+		record.m_level = level;
+		record.m_nameLen = static_cast<uint8_t>(nameLen);
+		record.m_msgLen = static_cast<uint16_t>(msgLen);
+		std::memcpy(record.m_name, name.data(), nameLen);
+		std::memcpy(record.m_msg, msg.data(), msgLen);
+
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Take all pending records out of the ring; called by the
+	 *        consumer only.
+	 *        `func(const Record* records, size_t numOfRecords)` is called
+	 *        with the pending records that are stored contiguously, so it's
+	 *        called at most twice (i.e., when the pending records wrap around
+	 *        the end of the ring).
+	 *        The records are only valid inside the callback.
+	 *
+	 * @return the number of records taken
+	 */
+	template<typename _FuncType>
+	size_t Drain(_FuncType func)
+	{
+		const size_t head = m_head.load(std::memory_order_relaxed);
+		const size_t tail = m_tail.load(std::memory_order_acquire);
+		const size_t numOfRecords = tail - head;
+		if (numOfRecords == 0)
+		{
+			return 0;
+		}
+
+		const size_t idx = head & (_NumOfRecords - 1);
+		const size_t firstPart = std::min(numOfRecords, _NumOfRecords - idx);
+		func(&m_records[idx], firstPart);
+		if (firstPart < numOfRecords)
+		{
+			func(&m_records[0], numOfRecords - firstPart);
+		}
+
+		m_head.store(tail, std::memory_order_release);
+		return numOfRecords;
+	}
+
+	/**
+	 * @brief Get the number of messages dropped because the ring was full
+	 *
+	 */
+	uint64_t GetNumOfDropped() const
+	{
+		return m_numOfDropped.load(std::memory_order_relaxed);
+	}
+
+private:
+
+	// the head is written by the consumer and the tail by the producer, so
+	// they are kept in different cache lines
+	std::atomic<size_t> m_head;
+	char m_headPad[64 - sizeof(std::atomic<size_t>)];
+	std::atomic<size_t> m_tail;
+	char m_tailPad[64 - sizeof(std::atomic<size_t>)];
+	std::atomic<uint64_t> m_numOfDropped;
+	std::array<Record, _NumOfRecords> m_records;
+
+}; // class LogRingBuffer
+
+
+template<size_t _NumOfRecords, size_t _MsgSize>
+constexpr size_t LogRingBuffer<_NumOfRecords, _MsgSize>::sk_numOfRecords;
+
+template<size_t _NumOfRecords, size_t _MsgSize>
+constexpr size_t LogRingBuffer<_NumOfRecords, _MsgSize>::sk_msgSize;
+
+template<size_t _NumOfRecords, size_t _MsgSize>
+constexpr size_t LogRingBuffer<_NumOfRecords, _MsgSize>::sk_nameSize;
+
+
+/**
+ * @brief A logger that writes messages into a `LogRingBuffer`, which can be
+ *        returned by a logger factory given by the logging header.
+ *
+ * @tparam _RingType The type of the ring buffer
+ */
+template<typename _RingType>
+class RingBufferLogger
+{
+public:
+
+	RingBufferLogger(const std::string& name, std::shared_ptr<_RingType> ring) :
+		m_name(name),
+		m_ring(std::move(ring))
+	{}
+
+	// LCOV_EXCL_START
+	~RingBufferLogger() = default;
+	// LCOV_EXCL_STOP
+
+	void Debug(const std::string& msg) const
+	{
+		m_ring->TryPush(LogLevel::Debug, m_name, msg);
+	}
+
+	void Info(const std::string& msg) const
+	{
+		m_ring->TryPush(LogLevel::Info, m_name, msg);
+	}
+
+	void Warn(const std::string& msg) const
+	{
+		m_ring->TryPush(LogLevel::Warn, m_name, msg);
+	}
+
+	void Error(const std::string& msg) const
+	{
+		m_ring->TryPush(LogLevel::Error, m_name, msg);
+	}
+
+private:
+
+	std::string m_name;
+	std::shared_ptr<_RingType> m_ring;
+}; // class RingBufferLogger
+
+
+} // namespace EclipseMonitor
+
+
 #ifndef ECLIPSEMONITOR_LOGGING_HEADER
 	// Logging is disabled
+#	ifndef ECLIPSEMONITOR_LOGGING_MIN_LEVEL
+#		define ECLIPSEMONITOR_LOGGING_MIN_LEVEL ECLIPSEMONITOR_LOGGING_LEVEL_OFF
+#	endif // !ECLIPSEMONITOR_LOGGING_MIN_LEVEL
 namespace EclipseMonitor
 {
 namespace Internal
@@ -67,9 +334,151 @@ using LoggerFactory = Internal::DummyLoggerFactory;
 #endif // !ECLIPSEMONITOR_LOGGING_HEADER
 
 
+#ifndef ECLIPSEMONITOR_LOGGING_MIN_LEVEL
+#	define ECLIPSEMONITOR_LOGGING_MIN_LEVEL ECLIPSEMONITOR_LOGGING_LEVEL_DEBUG
+#endif // !ECLIPSEMONITOR_LOGGING_MIN_LEVEL
+
+
 namespace EclipseMonitor
 {
 
-using Logger = typename LoggerFactory::LoggerType;
+
+/**
+ * @brief Wrap the logger given by the logger factory, so that messages below
+ *        the minimum level `ECLIPSEMONITOR_LOGGING_MIN_LEVEL` are dropped at
+ *        compile time.
+ *        Besides the message string, each logging function also accepts a
+ *        callable that returns the message, which is only called if the
+ *        level is enabled; so a message that is expensive to build should be
+ *        given as a lambda, and it costs nothing when it's disabled.
+ *        If no logging header is given, the minimum level is
+ *        `ECLIPSEMONITOR_LOGGING_LEVEL_OFF` by default.
+ *
+ * @tparam _BackendType The type of logger given by the logger factory
+ */
+template<typename _BackendType>
+class LoggerAdaptor
+{
+public: // static members:
+
+	using BackendType = _BackendType;
+
+	static constexpr bool IsEnabled(LogLevel level)
+	{
+		return static_cast<int>(level) >= ECLIPSEMONITOR_LOGGING_MIN_LEVEL;
+	}
+
+public:
+
+	LoggerAdaptor(BackendType backend) :
+		m_backend(std::move(backend))
+	{}
+
+	// LCOV_EXCL_START
+	~LoggerAdaptor() = default;
+	// LCOV_EXCL_STOP
+
+	void Debug(const std::string& msg) const
+	{
+		if (IsEnabled(LogLevel::Debug))
+		{
+			m_backend.Debug(msg);
+		}
+	}
+
+	template<
+		typename _MsgFuncType,
+		typename = typename std::enable_if<
+			!std::is_convertible<_MsgFuncType, std::string>::value
+		>::type
+	>
+	void Debug(_MsgFuncType msgFunc) const
+	{
+		if (IsEnabled(LogLevel::Debug))
+		{
+			m_backend.Debug(msgFunc());
+		}
+	}
+
+	void Info(const std::string& msg) const
+	{
+		if (IsEnabled(LogLevel::Info))
+		{
+			m_backend.Info(msg);
+		}
+	}
+
+	template<
+		typename _MsgFuncType,
+		typename = typename std::enable_if<
+			!std::is_convertible<_MsgFuncType, std::string>::value
+		>::type
+	>
+	void Info(_MsgFuncType msgFunc) const
+	{
+		if (IsEnabled(LogLevel::Info))
+		{
+			m_backend.Info(msgFunc());
+		}
+	}
+
+	void Warn(const std::string& msg) const
+	{
+		if (IsEnabled(LogLevel::Warn))
+		{
+			m_backend.Warn(msg);
+		}
+	}
+
+	template<
+		typename _MsgFuncType,
+		typename = typename std::enable_if<
+			!std::is_convertible<_MsgFuncType, std::string>::value
+		>::type
+	>
+	void Warn(_MsgFuncType msgFunc) const
+	{
+		if (IsEnabled(LogLevel::Warn))
+		{
+			m_backend.Warn(msgFunc());
+		}
+	}
+
+	void Error(const std::string& msg) const
+	{
+		if (IsEnabled(LogLevel::Error))
+		{
+			m_backend.Error(msg);
+		}
+	}
+
+	template<
+		typename _MsgFuncType,
+		typename = typename std::enable_if<
+			!std::is_convertible<_MsgFuncType, std::string>::value
+		>::type
+	>
+	void Error(_MsgFuncType msgFunc) const
+	{
+		if (IsEnabled(LogLevel::Error))
+		{
+			m_backend.Error(msgFunc());
+		}
+	}
+
+	const BackendType& GetBackend() const
+	{
+		return m_backend;
+	}
+
+private:
+
+	BackendType m_backend;
+
+}; // class LoggerAdaptor
+
+
+using Logger = LoggerAdaptor<typename LoggerFactory::LoggerType>;
+
 
 } // namespace EclipseMonitor
@@ -0,0 +1,362 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+
+namespace EclipseMonitor
+{
+
+
+enum class MetricCounter
+{
+	// number of headers received in each phase
+	UpdateBootstrapI,
+	UpdateBootstrapII,
+	UpdateSync,
+	UpdateRuntime,
+	// number of checkpoint windows completed
+	CheckpointComplete,
+	// number of event subscriptions matched by the bloom filter
+	BloomPositive,
+	// number of event subscriptions actually found in the receipts;
+	// (BloomPositive - ReceiptMatch) is the number of false positives
+	ReceiptMatch,
+	// number of transactions matched by the transaction call subscriptions
+	TxnCallMatch,
+	NumOfCounters,
+}; // enum class MetricCounter
+
+
+enum class MetricLatency
+{
+	// time spent on `Update` in each phase
+	UpdateBootstrapI,
+	UpdateBootstrapII,
+	UpdateSync,
+	UpdateRuntime,
+	// time spent on parsing a header binary, including hashing it
+	HeaderParse,
+	// time spent on hashing a header binary
+	HeaderHash,
+	// time spent on the common validation of a header
+	Validate,
+	// time spent on checking the difficulty of a header
+	DiffCheck,
+	// time spent on the receipts getter given to the event manager
+	ReceiptsFetch,
+	// time spent on building the receipts trie (unless it's already done by
+	// the getter) and checking it against the receipts root
+	ReceiptsVerify,
+	// time spent on the transactions getter given to the event manager
+	TxnsFetch,
+	// time spent on building the transactions trie and checking it against
+	// the transactions root
+	TxnsVerify,
+	// time spent on the header validated & confirmed callbacks
+	HeaderCallback,
+	// time spent on the event callbacks
+	EventCallback,
+	NumOfLatencies,
+}; // enum class MetricLatency
+
+
+enum class MetricGauge
+{
+	NumOfActiveNodes,
+	NumOfOfflineNodes,
+	// number of nodes in the fork tree, including the last checkpoint node
+	NumOfForkTreeNodes,
+	NumOfGauges,
+}; // enum class MetricGauge
+
+
+/**
+ * @brief A ready-to-use metrics implementation that keeps all counters,
+ *        gauges, and latency histograms in process-wide atomic variables.
+ *        It can be selected by a metrics header (see
+ *        `ECLIPSEMONITOR_METRICS_HEADER` below), and the collected numbers
+ *        can be read at any time from any thread.
+ *        Any other implementation must provide the same static members,
+ *        except the getters; `sk_isEnabled` tells the monitor whether it's
+ *        worth collecting metrics that are not free to compute.
+ *        Latencies are recorded in nanoseconds, into histogram buckets whose
+ *        bounds are powers of 2; i.e., bucket `i` (`i > 0`) counts latencies
+ *        in the range `[2^(i-1), 2^i)`, and bucket 0 counts zero latencies.
+ *
+ */
+class BasicMetrics
+{
+public: // static members:
+
+	using Clock = std::chrono::steady_clock;
+	using TimePoint = typename Clock::time_point;
+
+	static constexpr bool sk_isEnabled = true;
+
+	static constexpr size_t sk_numOfBuckets = 65;
+
+	static TimePoint Now()
+	{
+		return Clock::now();
+	}
+
+	static void AddCount(MetricCounter id, uint64_t n = 1)
+	{
+		GetState().m_counters[static_cast<size_t>(id)].fetch_add(
+			n,
+			std::memory_order_relaxed
+		);
+	}
+
+	static void SetGauge(MetricGauge id, uint64_t val)
+	{
+		GetState().m_gauges[static_cast<size_t>(id)].store(
+			val,
+			std::memory_order_relaxed
+		);
+	}
+
+	/**
+	 * @brief Record the latency from the given start time to now
+	 *
+	 */
+	static void AddLatency(MetricLatency id, const TimePoint& start)
+	{
+		auto nanoSec = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			Now() - start
+		).count();
+		AddLatencyNanoSec(id, nanoSec > 0 ? static_cast<uint64_t>(nanoSec) : 0);
+	}
+
+	static void AddLatencyNanoSec(MetricLatency id, uint64_t nanoSec)
+	{
+		Histogram& hist = GetState().m_latencies[static_cast<size_t>(id)];
+		hist.m_count.fetch_add(1, std::memory_order_relaxed);
+		hist.m_sum.fetch_add(nanoSec, std::memory_order_relaxed);
+		hist.m_buckets[GetBucketIdx(nanoSec)].fetch_add(
+			1,
+			std::memory_order_relaxed
+		);
+	}
+
+	static uint64_t GetCount(MetricCounter id)
+	{
+		return GetState().m_counters[static_cast<size_t>(id)].load(
+			std::memory_order_relaxed
+		);
+	}
+
+	static uint64_t GetGauge(MetricGauge id)
+	{
+		return GetState().m_gauges[static_cast<size_t>(id)].load(
+			std::memory_order_relaxed
+		);
+	}
+
+	/**
+	 * @brief Get the number of latencies recorded
+	 *
+	 */
+	static uint64_t GetLatencyCount(MetricLatency id)
+	{
+		return GetState().m_latencies[static_cast<size_t>(id)].m_count.load(
+			std::memory_order_relaxed
+		);
+	}
+
+	/**
+	 * @brief Get the sum of latencies recorded, in nanoseconds
+	 *
+	 */
+	static uint64_t GetLatencySum(MetricLatency id)
+	{
+		return GetState().m_latencies[static_cast<size_t>(id)].m_sum.load(
+			std::memory_order_relaxed
+		);
+	}
+
+	static uint64_t GetLatencyBucket(MetricLatency id, size_t bucketIdx)
+	{
+		const Histogram& hist =
+			GetState().m_latencies[static_cast<size_t>(id)];
+		return hist.m_buckets[bucketIdx].load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Get the index of the histogram bucket for the given latency
+	 *
+	 */
+	static size_t GetBucketIdx(uint64_t nanoSec)
+	{
+		size_t idx = 0;
+		while (nanoSec != 0)
+		{
+			nanoSec >>= 1;
+			++idx;
+		}
+		return idx;
+	}
+
+	/**
+	 * @brief Reset all metrics to zero
+	 *
+	 */
+	static void Reset()
+	{
+		State& state = GetState();
+		for (auto& counter : state.m_counters)
+		{
+			counter.store(0, std::memory_order_relaxed);
+		}
+		for (auto& gauge : state.m_gauges)
+		{
+			gauge.store(0, std::memory_order_relaxed);
+		}
+		for (auto& hist : state.m_latencies)
+		{
+			hist.Reset();
+		}
+	}
+
+private: // static members:
+
+	struct Histogram
+	{
+		Histogram()
+		{
+			Reset();
+		}
+
+		void Reset()
+		{
+			m_count.store(0, std::memory_order_relaxed);
+			m_sum.store(0, std::memory_order_relaxed);
+			for (auto& bucket : m_buckets)
+			{
+				bucket.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		std::atomic<uint64_t> m_count;
+		std::atomic<uint64_t> m_sum;
+		std::array<std::atomic<uint64_t>, sk_numOfBuckets> m_buckets;
+	}; // struct Histogram
+
+	struct State
+	{
+		State()
+		{
+			for (auto& counter : m_counters)
+			{
+				counter.store(0, std::memory_order_relaxed);
+			}
+			for (auto& gauge : m_gauges)
+			{
+				gauge.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		std::array<
+			std::atomic<uint64_t>,
+			static_cast<size_t>(MetricCounter::NumOfCounters)
+		> m_counters;
+		std::array<
+			std::atomic<uint64_t>,
+			static_cast<size_t>(MetricGauge::NumOfGauges)
+		> m_gauges;
+		std::array<
+			Histogram,
+			static_cast<size_t>(MetricLatency::NumOfLatencies)
+		> m_latencies;
+	}; // struct State
+
+	static State& GetState()
+	{
+		// The state is never destroyed, so metrics recorded during the static
+		// destruction stage can still be handled safely
+		static State* inst = new State();
+		return *inst;
+	}
+
+}; // class BasicMetrics
+
+
+} // namespace EclipseMonitor
+
+
+#ifndef ECLIPSEMONITOR_METRICS_HEADER
+	// Metrics are disabled
+namespace EclipseMonitor
+{
+namespace Internal
+{
+
+
+/**
+ * @brief A metrics implementation that does nothing; every call is an empty
+ *        inline function, and the time points are empty objects, so the
+ *        clock is never read
+ *
+ */
+class DummyMetrics
+{
+public: // static members:
+
+	struct TimePoint
+	{}; // struct TimePoint
+
+	static constexpr bool sk_isEnabled = false;
+
+	static TimePoint Now()
+	{
+		return TimePoint();
+	}
+
+	static void AddCount(MetricCounter, uint64_t = 1)
+	{}
+
+	static void SetGauge(MetricGauge, uint64_t)
+	{}
+
+	static void AddLatency(MetricLatency, const TimePoint&)
+	{}
+}; // class DummyMetrics
+
+
+struct DummyMetricsFactory
+{
+	using MetricsType = DummyMetrics;
+}; // struct DummyMetricsFactory
+
+
+} // namespace Internal
+
+
+using MetricsFactory = Internal::DummyMetricsFactory;
+
+
+} // namespace EclipseMonitor
+
+#else // !ECLIPSEMONITOR_METRICS_HEADER
+	// Metrics are enabled
+#	include ECLIPSEMONITOR_METRICS_HEADER
+#endif // !ECLIPSEMONITOR_METRICS_HEADER
+
+
+namespace EclipseMonitor
+{
+
+using Metrics = typename MetricsFactory::MetricsType;
+
+} // namespace EclipseMonitor
@@ -15,9 +15,12 @@
 #define ECLIPSEMONITOR_SVN_UPPER 0x01U
 /**
  * @brief Eclipse Monitor Secure Version Number (SVN) - Lower 2 bytes
+ *        0x0001 - `MonitorConfig` gains the fork tree limits
+ *                 (`maxChildrenPerNode` and `maxLiveNodes`); configs encoded
+ *                 by earlier versions can't be parsed anymore
  *
  */
-#define ECLIPSEMONITOR_SVN_LOWER 0x0000U
+#define ECLIPSEMONITOR_SVN_LOWER 0x0001U
 
 namespace EclipseMonitor
 {
@@ -60,6 +63,14 @@ using MonitorConfigTupleCore = std::tuple<
 	std::pair<
 		Obj::StrKey<SIMOBJ_KSTR("syncMaxWaitTime")>,
 		Obj::UInt64
+	>,
+	std::pair<
+		Obj::StrKey<SIMOBJ_KSTR("maxChildrenPerNode")>,
+		Obj::UInt64
+	>,
+	std::pair<
+		Obj::StrKey<SIMOBJ_KSTR("maxLiveNodes")>,
+		Obj::UInt64
 	>
 >;
 
@@ -87,6 +98,14 @@ using MonitorConfigParserTupleCore = std::tuple<
 	std::pair<
 		Obj::StrKey<SIMOBJ_KSTR("syncMaxWaitTime")>,
 		AdvRlp::CatIntegerParserT<AdvRlp::SpecificIntConverter<uint64_t> >
+	>,
+	std::pair<
+		Obj::StrKey<SIMOBJ_KSTR("maxChildrenPerNode")>,
+		AdvRlp::CatIntegerParserT<AdvRlp::SpecificIntConverter<uint64_t> >
+	>,
+	std::pair<
+		Obj::StrKey<SIMOBJ_KSTR("maxLiveNodes")>,
+		AdvRlp::CatIntegerParserT<AdvRlp::SpecificIntConverter<uint64_t> >
 	>
 >;
 
@@ -301,6 +320,41 @@ public:
 		return Base::template get<_StrKey<SIMOBJ_KSTR("syncMaxWaitTime")> >();
 	}
 
+	/**
+	 * @brief The maximum number of children that a block in the fork tree
+	 *        can have. When a new child is added to a block that is already
+	 *        full, the child with the fewest descendants (except the one
+	 *        with the most descendants) is removed to make room for it.
+	 *        Zero means there is no limit.
+	 *
+	 */
+	_RetRefType<SIMOBJ_KSTR("maxChildrenPerNode")> get_maxChildrenPerNode()
+	{
+		return Base::template get<_StrKey<SIMOBJ_KSTR("maxChildrenPerNode")> >();
+	}
+
+	_RetKRefType<SIMOBJ_KSTR("maxChildrenPerNode")> get_maxChildrenPerNode() const
+	{
+		return Base::template get<_StrKey<SIMOBJ_KSTR("maxChildrenPerNode")> >();
+	}
+
+	/**
+	 * @brief The maximum number of blocks in the fork tree that are not
+	 *        confirmed yet. When the limit is reached, the fork branch with
+	 *        the fewest descendants is removed to make room for the new block.
+	 *        Zero means there is no limit.
+	 *
+	 */
+	_RetRefType<SIMOBJ_KSTR("maxLiveNodes")> get_maxLiveNodes()
+	{
+		return Base::template get<_StrKey<SIMOBJ_KSTR("maxLiveNodes")> >();
+	}
+
+	_RetKRefType<SIMOBJ_KSTR("maxLiveNodes")> get_maxLiveNodes() const
+	{
+		return Base::template get<_StrKey<SIMOBJ_KSTR("maxLiveNodes")> >();
+	}
+
 }; // class MonitorConfig
 
 
@@ -419,12 +473,14 @@ using MonitorSecStateParser =
 inline MonitorConfig BuildEthereumMonitorConfig()
 {
 	MonitorConfig conf;
-	conf.get_SVN()             = GetEclipseMonitorSVN();
-	conf.get_chainName()       = "Ethereum";
-	conf.get_checkpointSize()  = 430;
-	conf.get_minDiffPercent()  = 103; // which is around 80%
-	conf.get_maxWaitTime()     = 400;
-	conf.get_syncMaxWaitTime() = 13;
+	conf.get_SVN()                = GetEclipseMonitorSVN();
+	conf.get_chainName()          = "Ethereum";
+	conf.get_checkpointSize()     = 430;
+	conf.get_minDiffPercent()     = 103; // which is around 80%
+	conf.get_maxWaitTime()        = 400;
+	conf.get_syncMaxWaitTime()    = 13;
+	conf.get_maxChildrenPerNode() = 16;
+	conf.get_maxLiveNodes()       = 4096;
 
 	return conf;
 }
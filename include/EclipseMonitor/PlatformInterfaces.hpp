@@ -8,6 +8,8 @@
 #include <cstddef>
 #include <cstdint>
 
+#include <functional>
+
 #include "DataTypes.hpp"
 
 
@@ -46,4 +48,33 @@ public:
 }; // class RandomGeneratorBase
 
 
+
+class WorkerPoolBase
+{
+public: // static members:
+
+	using TaskType = std::function<void(size_t)>;
+
+public:
+
+	WorkerPoolBase() = default;
+
+	// LCOV_EXCL_START
+	virtual ~WorkerPoolBase() = default;
+	// LCOV_EXCL_STOP
+
+	/**
+	 * @brief Run `task(i)` for every `i` in range `[0, numOfTasks)`, possibly
+	 *        in parallel, and block until all of them are finished.
+	 *        If any of the tasks throws, the first exception captured will
+	 *        be re-thrown to the caller after all tasks are finished.
+	 *
+	 * @param numOfTasks The number of tasks to run
+	 * @param task       The task function, which receives the task index
+	 */
+	virtual void ParallelFor(size_t numOfTasks, const TaskType& task) = 0;
+
+}; // class WorkerPoolBase
+
+
 } // namespace EclipseMonitor
@@ -107,10 +107,11 @@ public:
 		if (deltaT <= m_maxWaitTime)
 		{
 			m_isSynced.store(true);
-			m_logger.Info(
-				"Synced after " + std::to_string(deltaT) +
-				" ; @ " + std::to_string(recvTime)
-			);
+			m_logger.Info([&]()
+			{
+				return "Synced after " + std::to_string(deltaT) +
+					" ; @ " + std::to_string(recvTime);
+			});
 		}
 	}
 
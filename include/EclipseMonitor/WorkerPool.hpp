@@ -0,0 +1,216 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "PlatformInterfaces.hpp"
+
+
+namespace EclipseMonitor
+{
+
+
+/**
+ * @brief A worker pool backed by `std::thread`, which can be used by
+ *        untrusted hosts, or any platform where the C++ thread support
+ *        library is available.
+ *        The calling thread of `ParallelFor` also participates in running
+ *        the tasks, so a pool with zero worker threads simply runs all tasks
+ *        on the calling thread.
+ *
+ */
+class ThreadWorkerPool : public WorkerPoolBase
+{
+public: // static members:
+
+	using Self = ThreadWorkerPool;
+	using Base = WorkerPoolBase;
+
+	static size_t GetDefaultNumOfThreads()
+	{
+		size_t hwNum = static_cast<size_t>(std::thread::hardware_concurrency());
+		// the calling thread also runs tasks
+		return hwNum > 1 ? hwNum - 1 : 0;
+	}
+
+public:
+
+	ThreadWorkerPool() :
+		ThreadWorkerPool(GetDefaultNumOfThreads())
+	{}
+
+	explicit ThreadWorkerPool(size_t numOfThreads) :
+		Base(),
+		m_callMutex(),
+		m_mutex(),
+		m_taskCv(),
+		m_doneCv(),
+		m_threads(),
+		m_isStopping(false),
+		m_generation(0),
+		m_numOfBusy(0),
+		m_task(nullptr),
+		m_numOfTasks(0),
+		m_nextTask(0),
+		m_exception()
+	{
+		m_threads.reserve(numOfThreads);
+		for (size_t i = 0; i < numOfThreads; ++i)
+		{
+			m_threads.emplace_back(&Self::WorkerLoop, this);
+		}
+	}
+
+	ThreadWorkerPool(const ThreadWorkerPool&) = delete;
+
+	ThreadWorkerPool& operator=(const ThreadWorkerPool&) = delete;
+
+	// LCOV_EXCL_START
+	virtual ~ThreadWorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_isStopping = true;
+		}
+		m_taskCv.notify_all();
+		for (auto& thr : m_threads)
+		{
+			thr.join();
+		}
+	}
+	// LCOV_EXCL_STOP
+
+	size_t GetNumOfThreads() const
+	{
+		return m_threads.size();
+	}
+
+	virtual void ParallelFor(size_t numOfTasks, const TaskType& task) override
+	{
+		if (numOfTasks == 0)
+		{
+			return;
+		}
+
+		// only one batch of tasks can be run at a time
+		std::lock_guard<std::mutex> callLock(m_callMutex);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_task = &task;
+			m_numOfTasks = numOfTasks;
+			m_nextTask.store(0);
+			m_exception = nullptr;
+			m_numOfBusy = m_threads.size();
+			++m_generation;
+		}
+		m_taskCv.notify_all();
+
+		// the calling thread works on the tasks as well
+		RunTasks();
+
+		std::exception_ptr exception;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_doneCv.wait(lock, [this](){
+				return m_numOfBusy == 0;
+			});
+			m_task = nullptr;
+			exception = m_exception;
+			m_exception = nullptr;
+		}
+
+		if (exception != nullptr)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+
+private:
+
+	void WorkerLoop()
+	{
+		uint64_t seenGeneration = 0;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_taskCv.wait(lock, [this, &seenGeneration](){
+					return m_isStopping || (m_generation != seenGeneration);
+				});
+				if (m_isStopping)
+				{
+					return;
+				}
+				seenGeneration = m_generation;
+			}
+
+			RunTasks();
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (--m_numOfBusy == 0)
+				{
+					m_doneCv.notify_all();
+				}
+			}
+		}
+	}
+
+	void RunTasks()
+	{
+		while (true)
+		{
+			size_t i = m_nextTask.fetch_add(1);
+			if (i >= m_numOfTasks)
+			{
+				return;
+			}
+
+			try
+			{
+				(*m_task)(i);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (m_exception == nullptr)
+				{
+					m_exception = std::current_exception();
+				}
+			}
+		}
+	}
+
+	std::mutex m_callMutex;
+	std::mutex m_mutex;
+	std::condition_variable m_taskCv;
+	std::condition_variable m_doneCv;
+	std::vector<std::thread> m_threads;
+
+	bool m_isStopping;
+	uint64_t m_generation;
+	size_t m_numOfBusy;
+
+	const TaskType* m_task;
+	size_t m_numOfTasks;
+	std::atomic<size_t> m_nextTask;
+	std::exception_ptr m_exception;
+
+}; // class ThreadWorkerPool
+
+
+} // namespace EclipseMonitor
@@ -0,0 +1,40 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+
+#include <initializer_list>
+#include <vector>
+
+
+namespace EclipseMonitor_Test
+{
+
+/**
+ * @brief Build ABI-encoded chunks, where each given value is stored as a
+ *        big-endian integer at the end of its own chunk
+ *
+ */
+inline std::vector<uint8_t> BuildUIntChunks(
+	std::initializer_list<uint64_t> vals
+)
+{
+	std::vector<uint8_t> res;
+	for (uint64_t val : vals)
+	{
+		res.insert(res.end(), 24, 0x00U);
+		for (size_t i = 0; i < 8; ++i)
+		{
+			res.push_back(static_cast<uint8_t>(val >> (8 * (7 - i))));
+		}
+	}
+	return res;
+}
+
+} // namespace EclipseMonitor_Test
@@ -47,7 +47,7 @@ private:
 
 	void Log(const std::string& level, const std::string& msg) const
 	{
-		std::cout << m_name << "(" << level << "): " << msg << std::endl;
+		std::cout << m_name << "(" << level << "): " << msg << '\n';
 	}
 
 	std::string m_name;
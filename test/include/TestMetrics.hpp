@@ -0,0 +1,25 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#pragma once
+
+
+namespace EclipseMonitor_Test
+{
+
+struct TestingMetricsFactory
+{
+	using MetricsType = ::EclipseMonitor::BasicMetrics;
+}; // struct TestingMetricsFactory
+
+} // namespace EclipseMonitor_Test
+
+
+namespace EclipseMonitor
+{
+
+using MetricsFactory = ::EclipseMonitor_Test::TestingMetricsFactory;
+
+} // namespace EclipseMonitor
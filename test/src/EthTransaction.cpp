@@ -368,3 +368,134 @@ const SimpleObjects::Bytes& EclipseMonitor_Test::TestTxn3()
 
 	return inst;
 }
+
+const SimpleObjects::Bytes& EclipseMonitor_Test::BlobTxn()
+{
+	static const SimpleObjects::Bytes inst({
+		// A blob transaction (EIP-4844) calling transfer(address,uint256)
+		// Transaction Type
+		0x03U,
+		// RLP List
+		0xf8U, 0xd4U,
+		// ChainId
+		0x01U,
+		// Nonce
+		0x07U,
+		// GasTipCap
+		0x84U, 0x3bU, 0x9aU, 0xcaU, 0x00U,
+		// GasFeeCap
+		0x85U, 0x04U, 0xa8U, 0x17U, 0xc8U, 0x00U,
+		// Gas
+		0x83U, 0x01U, 0x86U, 0xa0U,
+		// To
+		0x94U, 0x9fU, 0x8fU, 0x72U, 0xaaU, 0x93U, 0x04U, 0xc8U,
+		0xb5U, 0x93U, 0xd5U, 0x55U, 0xf1U, 0x2eU, 0xf6U, 0x58U,
+		0x9cU, 0xc3U, 0xa5U, 0x79U, 0xa2U,
+		// Value
+		0x80U,
+		// Data
+		0xb8U, 0x44U, 0xa9U, 0x05U, 0x9cU, 0xbbU, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU,
+		0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU,
+		0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x03U, 0xe8U,
+		// AccessList
+		0xc0U,
+		// BlobFeeCap
+		0x01U,
+		// BlobHashes
+		0xe1U, 0xa0U, 0x01U, 0x33U, 0x33U, 0x33U, 0x33U, 0x33U,
+		0x33U, 0x33U, 0x33U, 0x33U, 0x33U, 0x33U, 0x33U, 0x33U,
+		0x33U, 0x33U, 0x33U, 0x33U, 0x33U, 0x33U, 0x33U, 0x33U,
+		0x33U, 0x33U, 0x33U, 0x33U, 0x33U, 0x33U, 0x33U, 0x33U,
+		0x33U, 0x33U,
+		// V
+		0x01U,
+		// R
+		0xa0U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U,
+		0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U,
+		0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U,
+		0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U,
+		0x11U,
+		// S
+		0xa0U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U,
+		0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U,
+		0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U,
+		0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U,
+		0x22U,
+	});
+
+	return inst;
+}
+
+const SimpleObjects::Bytes& EclipseMonitor_Test::SetCodeTxn()
+{
+	static const SimpleObjects::Bytes inst({
+		// A set code transaction (EIP-7702) calling transfer(address,uint256)
+		// Transaction Type
+		0x04U,
+		// RLP List
+		0xf9U, 0x01U, 0x0fU,
+		// ChainId
+		0x01U,
+		// Nonce
+		0x07U,
+		// GasTipCap
+		0x84U, 0x3bU, 0x9aU, 0xcaU, 0x00U,
+		// GasFeeCap
+		0x85U, 0x04U, 0xa8U, 0x17U, 0xc8U, 0x00U,
+		// Gas
+		0x83U, 0x01U, 0x86U, 0xa0U,
+		// To
+		0x94U, 0x9fU, 0x8fU, 0x72U, 0xaaU, 0x93U, 0x04U, 0xc8U,
+		0xb5U, 0x93U, 0xd5U, 0x55U, 0xf1U, 0x2eU, 0xf6U, 0x58U,
+		0x9cU, 0xc3U, 0xa5U, 0x79U, 0xa2U,
+		// Value
+		0x80U,
+		// Data
+		0xb8U, 0x44U, 0xa9U, 0x05U, 0x9cU, 0xbbU, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU,
+		0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU,
+		0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x2aU, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x03U, 0xe8U,
+		// AccessList
+		0xc0U,
+		// AuthorizationList
+		0xf8U, 0x5cU, 0xf8U, 0x5aU, 0x01U, 0x94U, 0x5aU, 0x5aU,
+		0x5aU, 0x5aU, 0x5aU, 0x5aU, 0x5aU, 0x5aU, 0x5aU, 0x5aU,
+		0x5aU, 0x5aU, 0x5aU, 0x5aU, 0x5aU, 0x5aU, 0x5aU, 0x5aU,
+		0x5aU, 0x5aU, 0x03U, 0x80U, 0xa0U, 0x11U, 0x11U, 0x11U,
+		0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U,
+		0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U,
+		0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U,
+		0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0xa0U, 0x22U, 0x22U,
+		0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U,
+		0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U,
+		0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U,
+		0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U,
+		// V
+		0x80U,
+		// R
+		0xa0U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U,
+		0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U,
+		0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U,
+		0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U, 0x11U,
+		0x11U,
+		// S
+		0xa0U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U,
+		0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U,
+		0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U,
+		0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U, 0x22U,
+		0x22U,
+	});
+
+	return inst;
+}
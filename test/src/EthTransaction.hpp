@@ -22,4 +22,8 @@ const SimpleObjects::Bytes& TestTxn2();
 
 const SimpleObjects::Bytes& TestTxn3();
 
+const SimpleObjects::Bytes& BlobTxn();
+
+const SimpleObjects::Bytes& SetCodeTxn();
+
 }
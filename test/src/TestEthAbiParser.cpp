@@ -5,11 +5,13 @@
 
 #include <cstdint>
 
+#include <list>
 #include <vector>
 
 #include <gtest/gtest.h>
 
 #include <EclipseMonitor/Eth/AbiParser.hpp>
+#include <EclipseMonitor/Exceptions.hpp>
 
 namespace EclipseMonitor_Test
 {
@@ -1192,3 +1194,115 @@ GTEST_TEST(TestEthAbiParser, ParseMixParamsPrimitive)
 		);
 	}
 }
+
+GTEST_TEST(TestEthAbiParser, ParseContiguousAndIteratorInput)
+{
+	using AbiParserUInt32 = AbiParser<
+		SimpleObjects::ObjCategory::Integer,
+		std::integral_constant<
+			SimpleObjects::RealNumType,
+			SimpleObjects::RealNumType::UInt32
+		>
+	>;
+	using AbiParserBytes = AbiParser<
+		SimpleObjects::ObjCategory::Bytes,
+		std::true_type
+	>;
+
+	// (uint32, bytes)
+	std::vector<uint8_t> input = {
+		// 0000 - uint32
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+		// 0020 - offset - bytes
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x40U,
+		// tails
+			// 0040 - len - bytes
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x09U,
+			// 0060 - data - bytes
+			0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+			0xFFU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+	};
+	const std::vector<uint8_t> expBytes = {
+		0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU, 0xFFU,
+	};
+
+	// raw pointers
+	{
+		const uint8_t* begin = input.data();
+		const uint8_t* end = input.data() + input.size();
+
+		auto intRes = AbiParserUInt32().ToPrimitive(begin, end, begin);
+		EXPECT_EQ(std::get<0>(intRes), 0x89ABCDEFU);
+		EXPECT_EQ(std::get<1>(intRes), begin + 32);
+
+		auto bytesRes =
+			AbiParserBytes().ToPrimitive(std::get<1>(intRes), end, begin);
+		EXPECT_EQ(std::get<0>(bytesRes), expBytes);
+		EXPECT_EQ(std::get<1>(bytesRes), begin + 64);
+
+		// truncated in the middle of a chunk
+		EXPECT_THROW(
+			AbiParserUInt32().ToPrimitive(begin, begin + 31, begin),
+			EclipseMonitor::Exception
+		);
+		EXPECT_THROW(
+			AbiParserBytes().ToPrimitive(begin + 32, end - 1, begin),
+			EclipseMonitor::Exception
+		);
+	}
+
+	// non-contiguous iterators
+	{
+		std::list<uint8_t> listInput(input.begin(), input.end());
+
+		auto intRes = AbiParserUInt32().ToPrimitive(
+			listInput.begin(), listInput.end(), listInput.begin()
+		);
+		EXPECT_EQ(std::get<0>(intRes), 0x89ABCDEFU);
+
+		auto bytesRes = AbiParserBytes().ToPrimitive(
+			std::get<1>(intRes), listInput.end(), listInput.begin()
+		);
+		EXPECT_EQ(std::get<0>(bytesRes), expBytes);
+		EXPECT_EQ(std::get<1>(bytesRes), std::next(listInput.begin(), 64));
+	}
+
+	// non-zero bytes in the leading zeros of the integer, and in the
+	// padding of the bytes
+	for (size_t pos : { 0, 27, 64 + 32 + 31 })
+	{
+		std::vector<uint8_t> badInput = input;
+		badInput[pos] = 0x01U;
+		const uint8_t* begin = badInput.data();
+		const uint8_t* end = badInput.data() + badInput.size();
+		std::list<uint8_t> listInput(badInput.begin(), badInput.end());
+
+		auto parseAll = [](const uint8_t* b, const uint8_t* e)
+		{
+			auto intRes = AbiParserUInt32().ToPrimitive(b, e, b);
+			AbiParserBytes().ToPrimitive(std::get<1>(intRes), e, b);
+		};
+		auto parseAllList = [&listInput]()
+		{
+			auto intRes = AbiParserUInt32().ToPrimitive(
+				listInput.begin(), listInput.end(), listInput.begin()
+			);
+			AbiParserBytes().ToPrimitive(
+				std::get<1>(intRes), listInput.end(), listInput.begin()
+			);
+		};
+		EXPECT_THROW(parseAll(begin, end), EclipseMonitor::Exception);
+		EXPECT_THROW(parseAllList(), EclipseMonitor::Exception);
+	}
+}
@@ -0,0 +1,455 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <EclipseMonitor/Eth/AbiSignature.hpp>
+#include <EclipseMonitor/Exceptions.hpp>
+
+#include <TestAbiUtils.hpp>
+
+namespace EclipseMonitor_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+using namespace EclipseMonitor_Test;
+using namespace EclipseMonitor::Eth;
+
+GTEST_TEST(TestEthAbiSignature, CountTestFile)
+{
+	static auto tmp = ++EclipseMonitor_Test::g_numOfTestFile;
+	(void)tmp;
+}
+
+GTEST_TEST(TestEthAbiSignature, CompileSignature)
+{
+	{
+		AbiDecodePlan plan =
+			AbiDecodePlan::Compile("(address,uint256,bytes32[],string)");
+
+		const AbiTypeNode& root = plan.GetRoot();
+		EXPECT_EQ(root.m_kind, AbiTypeKind::Tuple);
+		EXPECT_TRUE(root.m_isDynamic);
+		EXPECT_EQ(root.m_headSize, 32);
+		EXPECT_EQ(root.m_blockSize, 128);
+		ASSERT_EQ(root.m_numFields, 4);
+
+		const AbiTypeKind expKinds[] = {
+			AbiTypeKind::Address,
+			AbiTypeKind::UInt,
+			AbiTypeKind::List,
+			AbiTypeKind::String,
+		};
+		for (size_t i = 0; i < root.m_numFields; ++i)
+		{
+			const AbiTupleField& field = plan.GetField(root.m_fieldsBegin + i);
+			EXPECT_EQ(field.m_headOffset, i * 32);
+			EXPECT_EQ(plan.GetNode(field.m_nodeIdx).m_kind, expKinds[i]);
+		}
+
+		const AbiTypeNode& list =
+			plan.GetNode(plan.GetField(root.m_fieldsBegin + 2).m_nodeIdx);
+		EXPECT_TRUE(list.m_isDynamic);
+		EXPECT_EQ(plan.GetNode(list.m_itemIdx).m_kind, AbiTypeKind::FixedBytes);
+		EXPECT_EQ(plan.GetNode(list.m_itemIdx).m_param, 32);
+	}
+
+	// static types are inlined into the heads
+	{
+		AbiDecodePlan plan =
+			AbiDecodePlan::Compile("(uint64,(bool,bytes16)[2],int)");
+
+		const AbiTypeNode& root = plan.GetRoot();
+		EXPECT_FALSE(root.m_isDynamic);
+		EXPECT_EQ(root.m_headSize, 32 * 6);
+		EXPECT_EQ(plan.GetField(root.m_fieldsBegin + 1).m_headOffset, 32);
+		EXPECT_EQ(plan.GetField(root.m_fieldsBegin + 2).m_headOffset, 32 * 5);
+
+		const AbiTypeNode& lastField =
+			plan.GetNode(plan.GetField(root.m_fieldsBegin + 2).m_nodeIdx);
+		EXPECT_EQ(lastField.m_kind, AbiTypeKind::Int);
+		EXPECT_EQ(lastField.m_param, 256);
+	}
+
+	// dynamic items make T[k] dynamic
+	{
+		AbiDecodePlan plan = AbiDecodePlan::Compile("string[2][]");
+
+		const AbiTypeNode& root = plan.GetRoot();
+		EXPECT_EQ(root.m_kind, AbiTypeKind::List);
+		const AbiTypeNode& item = plan.GetNode(root.m_itemIdx);
+		EXPECT_EQ(item.m_kind, AbiTypeKind::FixedList);
+		EXPECT_TRUE(item.m_isDynamic);
+		EXPECT_EQ(item.m_headSize, 32);
+		EXPECT_EQ(item.m_blockSize, 64);
+	}
+
+	// invalid signatures
+	{
+		const char* invalidSigs[] = {
+			"(uint7)",
+			"(uint264)",
+			"(uint08)",
+			"(bytes33)",
+			"(bytes0)",
+			"(foo)",
+			"(uint256",
+			"(uint256,)",
+			"(uint256)x",
+			"uint256[",
+			"uint256[0]",
+			"uint256[1a]",
+			"()[]",
+		};
+		for (const char* sig : invalidSigs)
+		{
+			EXPECT_THROW(
+				AbiDecodePlan::Compile(sig),
+				EclipseMonitor::Exception
+			) << sig;
+		}
+	}
+}
+
+GTEST_TEST(TestEthAbiSignature, DecodeMixParams)
+{
+	// function bar(
+	// 		bool isFoo,
+	// 		uint64 num,
+	// 		bytes16 fooBytes,
+	// 		bytes dynBytes,
+	// 		uint64[2] nums,
+	// 		bytes[] arrBytes,
+	// ) public
+	AbiDecodePlan plan =
+		AbiDecodePlan::Compile("(bool,uint64,bytes16,bytes,uint64[2],bytes[])");
+
+	std::vector<uint8_t> input = {
+		// 0000 - bool isFoo
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x01U,
+		// 0020 - uint64 num
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+		// 0040 - bytes16 fooBytes
+		0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+		0xEFU, 0xCDU, 0xABU, 0x89U, 0x67U, 0x45U, 0x23U, 0x01U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		// 0060 - offset - bytes dynBytes
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0xE0U,
+		// 0080 - uint64[2] nums - [0]
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+		// 00A0 - uint64[2] nums - [1]
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0x00U, 0x00U,
+		// 00C0 - offset - bytes[] arrBytes
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x01U, 0x20U,
+		// tails
+			// 00E0 - en - bytes dynBytes
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x10U,
+			// 0100 - data - bytes dynBytes
+			0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+			0xEFU, 0xCDU, 0xABU, 0x89U, 0x67U, 0x45U, 0x23U, 0x01U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			// 0120 - len - bytes[] arrBytes
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U,
+			// 0140 - 0000 - offset - bytes[] arrBytes
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x40U,
+			// 0160 - 0020 - offset - bytes[] arrBytes
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x80U,
+				// 0180 - 0040 - len - bytes[] arrBytes
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x10U,
+				// 01A0 - 0060 - data - bytes[] arrBytes
+				0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+				0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				// 01C0 - 0080 - len - bytes[] arrBytes
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x10U,
+				// 01E0 - 00A0 - data - bytes[] arrBytes
+				0xFEU, 0xDCU, 0xBAU, 0x98U, 0x76U, 0x54U, 0x32U, 0x10U,
+				0xFEU, 0xDCU, 0xBAU, 0x98U, 0x76U, 0x54U, 0x32U, 0x10U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+	};
+
+	const std::vector<uint8_t> expBytes = {
+		0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+		0xEFU, 0xCDU, 0xABU, 0x89U, 0x67U, 0x45U, 0x23U, 0x01U,
+	};
+	const std::vector<uint8_t> expArrBytes0 = {
+		0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+		0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+	};
+	const std::vector<uint8_t> expArrBytes1 = {
+		0xFEU, 0xDCU, 0xBAU, 0x98U, 0x76U, 0x54U, 0x32U, 0x10U,
+		0xFEU, 0xDCU, 0xBAU, 0x98U, 0x76U, 0x54U, 0x32U, 0x10U,
+	};
+
+	// the same plan decodes any number of payloads
+	for (size_t i = 0; i < 2; ++i)
+	{
+		AbiValueView params = plan.Decode(input.data(), input.size());
+		ASSERT_EQ(params.GetNumOfItems(), 6);
+
+		EXPECT_EQ(params[0].AsBool(), true);
+		EXPECT_EQ(params[1].AsUInt64(), 0x123456789ABCDEFULL);
+		EXPECT_EQ(params[2].AsBytes().ToBytes(), expBytes);
+		EXPECT_EQ(params[3].AsBytes().data(), input.data() + 0x100);
+		EXPECT_EQ(params[3].AsBytes().ToBytes(), expBytes);
+
+		ASSERT_EQ(params[4].GetNumOfItems(), 2);
+		EXPECT_EQ(params[4][0].AsUInt64(), 0x123456789ABCDEFULL);
+		EXPECT_EQ(params[4][1].AsUInt64(), 0x123456789AB0000ULL);
+
+		ASSERT_EQ(params[5].GetNumOfItems(), 2);
+		EXPECT_EQ(params[5][0].AsBytes().ToBytes(), expArrBytes0);
+		EXPECT_EQ(params[5][1].AsBytes().ToBytes(), expArrBytes1);
+
+		// type mismatch and out of range
+		EXPECT_THROW(params[0].AsUInt64(), EclipseMonitor::Exception);
+		EXPECT_THROW(params[1].AsString(), EclipseMonitor::Exception);
+		EXPECT_THROW(params[6], EclipseMonitor::Exception);
+		EXPECT_THROW(params[1].GetNumOfItems(), EclipseMonitor::Exception);
+	}
+}
+
+GTEST_TEST(TestEthAbiSignature, DecodeValues)
+{
+	AbiDecodePlan plan =
+		AbiDecodePlan::Compile("(address,int8,int64,bytes32[],string)");
+
+	// heads
+	std::vector<uint8_t> input(32, 0x00U);
+	for (size_t i = 0; i < 20; ++i)
+	{
+		input[12 + i] = static_cast<uint8_t>(i + 1);
+	}
+	// int8 -1, int64 -2
+	input.insert(input.end(), 32, 0xFFU);
+	input.insert(input.end(), 32, 0xFFU);
+	input.back() = 0xFEU;
+	// offsets, the length of bytes32[], and its item
+	std::vector<uint8_t> tails = BuildUIntChunks({
+		0xA0U, 0xE0U,
+		0x01U, 0x00U,
+		0x05U,
+	});
+	tails[32 * 3 + 31] = 0xAAU;
+	input.insert(input.end(), tails.begin(), tails.end());
+	// the data of the string
+	input.insert(input.end(), 32, 0x00U);
+	const std::string str = "hello";
+	std::copy(str.begin(), str.end(), input.end() - 32);
+
+	AbiValueView params = plan.Decode(input.data(), input.size());
+
+	ContractAddr expAddr;
+	for (size_t i = 0; i < expAddr.size(); ++i)
+	{
+		expAddr[i] = static_cast<uint8_t>(i + 1);
+	}
+	EXPECT_EQ(params[0].AsAddress(), expAddr);
+	EXPECT_EQ(params[1].AsInt64(), -1);
+	EXPECT_EQ(params[2].AsInt64(), -2);
+	ASSERT_EQ(params[3].GetNumOfItems(), 1);
+	EXPECT_EQ(params[3][0].AsBytes().size(), 32);
+	EXPECT_EQ(params[3][0].AsBytes().data()[31], 0xAAU);
+	EXPECT_EQ(params[4].AsString(), str);
+
+	// Error - dirty bits in the address
+	{
+		std::vector<uint8_t> badInput = input;
+		badInput[0] = 0x01U;
+		EXPECT_THROW(
+			plan.Decode(badInput.data(), badInput.size()),
+			EclipseMonitor::Exception
+		);
+	}
+
+	// Error - int8 is not sign extended
+	{
+		std::vector<uint8_t> badInput = input;
+		badInput[32] = 0x00U;
+		EXPECT_THROW(
+			plan.Decode(badInput.data(), badInput.size()),
+			EclipseMonitor::Exception
+		);
+	}
+
+	// Error - the offset points into the heads
+	{
+		std::vector<uint8_t> badInput = input;
+		badInput[32 * 3 + 31] = 0x80U;
+		EXPECT_THROW(
+			plan.Decode(badInput.data(), badInput.size()),
+			EclipseMonitor::Exception
+		);
+	}
+
+	// Error - non-zero padding of the string
+	{
+		std::vector<uint8_t> badInput = input;
+		badInput.back() = 0x01U;
+		EXPECT_THROW(
+			plan.Decode(badInput.data(), badInput.size()),
+			EclipseMonitor::Exception
+		);
+	}
+
+	// Error - truncated input
+	{
+		EXPECT_THROW(
+			plan.Decode(input.data(), input.size() - 32),
+			EclipseMonitor::Exception
+		);
+		EXPECT_THROW(
+			plan.Decode(input.data(), 32 * 4),
+			EclipseMonitor::Exception
+		);
+	}
+}
+
+GTEST_TEST(TestEthAbiSignature, DecodeBool)
+{
+	AbiDecodePlan plan = AbiDecodePlan::Compile("bool");
+
+	std::vector<uint8_t> input = BuildUIntChunks({ 0x00U });
+	EXPECT_EQ(plan.Decode(input.data(), input.size()).AsBool(), false);
+
+	input = BuildUIntChunks({ 0x02U });
+	EXPECT_THROW(
+		plan.Decode(input.data(), input.size()),
+		EclipseMonitor::Exception
+	);
+}
+
+GTEST_TEST(TestEthAbiSignature, DecodeAliasedTails)
+{
+	AbiDecodePlan plan = AbiDecodePlan::Compile("(uint256[][][])");
+
+	// all items of each list point to the same tail, so validating every
+	// item would take N^3 steps for a payload of about 3N chunks
+	auto buildAliased = [](uint64_t n) -> std::vector<uint8_t>
+	{
+		std::vector<uint8_t> res = BuildUIntChunks({ 0x20U });
+		for (size_t depth = 0; depth < 3; ++depth)
+		{
+			std::vector<uint8_t> list = BuildUIntChunks({ n });
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				// offsets of the outer lists; values of the inner list
+				std::vector<uint8_t> item =
+					BuildUIntChunks({ (depth < 2) ? (n * 32) : i });
+				list.insert(list.end(), item.begin(), item.end());
+			}
+			res.insert(res.end(), list.begin(), list.end());
+		}
+		return res;
+	};
+
+	// a little overlap is fine
+	std::vector<uint8_t> input = buildAliased(1);
+	AbiValueView params = plan.Decode(input.data(), input.size());
+	ASSERT_EQ(params[0].GetNumOfItems(), 1U);
+	ASSERT_EQ(params[0][0][0].GetNumOfItems(), 1U);
+	EXPECT_EQ(params[0][0][0][0].AsUInt64(), 0U);
+
+	input = buildAliased(64);
+	EXPECT_THROW(
+		plan.Decode(input.data(), input.size()),
+		EclipseMonitor::Exception
+	);
+}
+
+GTEST_TEST(TestEthAbiSignature, DecodeAliasedOffsets)
+{
+	AbiDecodePlan plan = AbiDecodePlan::Compile("(string[1][])");
+
+	// all items of the list point to the same `string[1]`, so each of them
+	// resolves two offsets, while the payload only has N + 4 chunks
+	auto buildAliased = [](uint64_t n) -> std::vector<uint8_t>
+	{
+		std::vector<uint8_t> res = BuildUIntChunks({ 0x20U, n });
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			std::vector<uint8_t> item = BuildUIntChunks({ n * 32 });
+			res.insert(res.end(), item.begin(), item.end());
+		}
+		std::vector<uint8_t> tail = BuildUIntChunks({ 0x20U, 0x00U });
+		res.insert(res.end(), tail.begin(), tail.end());
+		return res;
+	};
+
+	std::vector<uint8_t> input = buildAliased(1);
+	AbiValueView params = plan.Decode(input.data(), input.size());
+	ASSERT_EQ(params[0].GetNumOfItems(), 1U);
+	EXPECT_EQ(params[0][0][0].AsBytes().size(), 0U);
+
+	input = buildAliased(64);
+	EXPECT_THROW(
+		plan.Decode(input.data(), input.size()),
+		EclipseMonitor::Exception
+	);
+}
+
+GTEST_TEST(TestEthAbiSignature, PlanCache)
+{
+	AbiDecodePlanCache cache;
+
+	auto plan1 = cache.Get("(address,uint256)");
+	auto plan2 = cache.Get("(address,uint256)");
+	EXPECT_EQ(plan1, plan2);
+	EXPECT_EQ(cache.GetNumOfPlans(), 1);
+
+	auto plan3 = cache.Get("(address,uint256[])");
+	EXPECT_NE(plan1, plan3);
+	EXPECT_EQ(cache.GetNumOfPlans(), 2);
+
+	// invalid signatures are not cached
+	EXPECT_THROW(cache.Get("(address,uint7)"), EclipseMonitor::Exception);
+	EXPECT_EQ(cache.GetNumOfPlans(), 2);
+}
@@ -0,0 +1,509 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <EclipseMonitor/Eth/AbiViewParser.hpp>
+#include <EclipseMonitor/Exceptions.hpp>
+
+#include <TestAbiUtils.hpp>
+
+namespace EclipseMonitor_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+using namespace EclipseMonitor_Test;
+using namespace EclipseMonitor::Eth;
+
+GTEST_TEST(TestEthAbiViewParser, CountTestFile)
+{
+	static auto tmp = ++EclipseMonitor_Test::g_numOfTestFile;
+	(void)tmp;
+}
+
+GTEST_TEST(TestEthAbiViewParser, ParseDynamicBytesView)
+{
+	using AbiViewParserBytes =
+		AbiViewParser<
+			SimpleObjects::ObjCategory::Bytes,
+			std::true_type
+		>;
+	using AbiViewParserString =
+		AbiViewParser<
+			SimpleObjects::ObjCategory::String
+		>;
+
+	const std::vector<uint8_t> expData = {
+		0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+		0xEFU, 0xCDU, 0xABU, 0x89U, 0x67U, 0x45U, 0x23U, 0x01U,
+	};
+
+	// bytes dyn 16
+	{
+		std::vector<uint8_t> input = {
+			// offset
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x20U,
+			// tails:
+				// len
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x10U,
+				// data
+				0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+				0xEFU, 0xCDU, 0xABU, 0x89U, 0x67U, 0x45U, 0x23U, 0x01U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		};
+		const uint8_t* begin = input.data();
+		const uint8_t* end = input.data() + input.size();
+
+		// test Head + Tail ToPrimitive
+		{
+			auto actHeadRes = AbiViewParserBytes().HeadToPrimitive(begin, end);
+			EXPECT_EQ(std::get<0>(actHeadRes), 32ULL);
+			EXPECT_EQ(std::get<1>(actHeadRes), begin + 32);
+			EXPECT_EQ(std::get<2>(actHeadRes), 1);
+
+			auto actTailRes =
+				AbiViewParserBytes().TailToPrimitive(begin + 32, end);
+			// the view points into the input, rather than a copy
+			EXPECT_EQ(std::get<0>(actTailRes).data(), begin + 64);
+			EXPECT_EQ(std::get<0>(actTailRes).size(), 16);
+			EXPECT_EQ(std::get<0>(actTailRes).ToBytes(), expData);
+			EXPECT_EQ(std::get<1>(actTailRes), end);
+			EXPECT_EQ(std::get<2>(actTailRes), 2);
+		}
+		// test ToPrimitive
+		{
+			auto actRes = AbiViewParserBytes().ToPrimitive(begin, end, begin);
+			EXPECT_EQ(std::get<0>(actRes).ToBytes(), expData);
+			EXPECT_EQ(std::get<1>(actRes), begin + 32);
+
+			auto actStrRes =
+				AbiViewParserString().ToPrimitive(begin, end, begin);
+			EXPECT_EQ(
+				std::get<0>(actStrRes).ToString(),
+				std::string(expData.begin(), expData.end())
+			);
+		}
+
+		// Error - non-zero padding
+		{
+			std::vector<uint8_t> badInput = input;
+			badInput.back() = 0x01U;
+			const uint8_t* badBegin = badInput.data();
+			const uint8_t* badEnd = badBegin + badInput.size();
+			EXPECT_THROW(
+				AbiViewParserBytes().ToPrimitive(
+					badBegin,
+					badEnd,
+					badBegin
+				),
+				EclipseMonitor::Exception
+			);
+		}
+
+		// Error - the length is beyond the input
+		{
+			std::vector<uint8_t> badInput = input;
+			badInput[63] = 0x41U;
+			const uint8_t* badBegin = badInput.data();
+			const uint8_t* badEnd = badBegin + badInput.size();
+			EXPECT_THROW(
+				AbiViewParserBytes().ToPrimitive(
+					badBegin,
+					badEnd,
+					badBegin
+				),
+				EclipseMonitor::Exception
+			);
+		}
+	}
+
+	// empty bytes
+	{
+		std::vector<uint8_t> input = BuildUIntChunks({ 0x20U, 0x00U });
+		const uint8_t* begin = input.data();
+		const uint8_t* end = input.data() + input.size();
+
+		auto actTailRes =
+			AbiViewParserBytes().TailToPrimitive(begin + 32, end);
+		EXPECT_TRUE(std::get<0>(actTailRes).empty());
+		EXPECT_EQ(std::get<1>(actTailRes), end);
+		EXPECT_EQ(std::get<2>(actTailRes), 1);
+	}
+}
+
+GTEST_TEST(TestEthAbiViewParser, ParseListDynLenStITypeView)
+{
+	using AbiParserUInt64 =
+		AbiParser<
+			SimpleObjects::ObjCategory::Integer,
+			AbiUInt64
+		>;
+	using AbiViewParserList =
+		AbiViewParser<
+			SimpleObjects::ObjCategory::List,
+			AbiParserUInt64,
+			std::true_type
+		>;
+
+	// uint64[] = [ 0x0123456789ABCDEF, 0x0123 ]
+	std::vector<uint8_t> input =
+		BuildUIntChunks({ 0x20U, 0x02U, 0x0123456789ABCDEFULL, 0x0123U });
+	const uint8_t* begin = input.data();
+	const uint8_t* end = input.data() + input.size();
+
+	AbiViewParserList listParser = AbiViewParserList(AbiParserUInt64());
+
+	auto actTailRes = listParser.TailToPrimitive(begin + 32, end);
+	const auto& list = std::get<0>(actTailRes);
+	ASSERT_EQ(list.size(), 2);
+	EXPECT_EQ(list[0], 0x0123456789ABCDEFULL);
+	EXPECT_EQ(list[1], 0x0123ULL);
+	EXPECT_THROW(list[2], EclipseMonitor::Exception);
+	EXPECT_EQ(
+		list.ToVector(),
+		std::vector<uint64_t>({ 0x0123456789ABCDEFULL, 0x0123ULL })
+	);
+	EXPECT_EQ(std::get<1>(actTailRes), end);
+	EXPECT_EQ(std::get<2>(actTailRes), 3);
+
+	// Error - the length is beyond the input
+	{
+		std::vector<uint8_t> badInput =
+			BuildUIntChunks({ 0x20U, 0x03U, 0x01U, 0x02U });
+		const uint8_t* badBegin = badInput.data();
+		const uint8_t* badEnd = badBegin + badInput.size();
+		EXPECT_THROW(
+			listParser.ToPrimitive(
+				badBegin,
+				badEnd,
+				badBegin
+			),
+			EclipseMonitor::Exception
+		);
+	}
+}
+
+GTEST_TEST(TestEthAbiViewParser, ParseListDynLenDynITypeView)
+{
+	using AbiParserBytes =
+		AbiParser<
+			SimpleObjects::ObjCategory::Bytes,
+			std::true_type
+		>;
+	using AbiViewParserBytes =
+		AbiViewParser<
+			SimpleObjects::ObjCategory::Bytes,
+			std::true_type
+		>;
+	using AbiViewParserList =
+		AbiViewParser<
+			SimpleObjects::ObjCategory::List,
+			AbiViewParserBytes,
+			std::true_type
+		>;
+	using AbiViewParserListCopy =
+		AbiViewParser<
+			SimpleObjects::ObjCategory::List,
+			AbiParserBytes,
+			std::true_type
+		>;
+
+	const std::vector<uint8_t> expItem0 = {
+		0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+		0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+	};
+	const std::vector<uint8_t> expItem1 = {
+		0xFEU, 0xDCU, 0xBAU, 0x98U, 0x76U, 0x54U, 0x32U, 0x10U,
+		0xFEU, 0xDCU, 0xBAU, 0x98U, 0x76U, 0x54U, 0x32U, 0x10U,
+	};
+
+	std::vector<uint8_t> input = {
+		// offset
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+		0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x20U,
+		// tails:
+			// length
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U,
+			// offset
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x40U,
+			// offset
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+			0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x80U,
+			// tails:
+				// len
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x10U,
+				// data
+				0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+				0x01U, 0x23U, 0x45U, 0x67U, 0x89U, 0xABU, 0xCDU, 0xEFU,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				// len
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x10U,
+				// data
+				0xFEU, 0xDCU, 0xBAU, 0x98U, 0x76U, 0x54U, 0x32U, 0x10U,
+				0xFEU, 0xDCU, 0xBAU, 0x98U, 0x76U, 0x54U, 0x32U, 0x10U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+				0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+	};
+	const uint8_t* begin = input.data();
+	const uint8_t* end = input.data() + input.size();
+
+	// test Head + Tail ToPrimitive
+	{
+		AbiViewParserList listParser = AbiViewParserList(AbiViewParserBytes());
+
+		auto actHeadRes = listParser.HeadToPrimitive(begin, end);
+		EXPECT_EQ(std::get<0>(actHeadRes), 32ULL);
+		EXPECT_EQ(std::get<1>(actHeadRes), begin + 32);
+		EXPECT_EQ(std::get<2>(actHeadRes), 1);
+
+		auto actTailRes = listParser.TailToPrimitive(begin + 32, end);
+		const auto& list = std::get<0>(actTailRes);
+		ASSERT_EQ(list.size(), 2);
+		EXPECT_EQ(list[0].data(), begin + 160);
+		EXPECT_EQ(list[0].ToBytes(), expItem0);
+		EXPECT_EQ(list[1].data(), begin + 224);
+		EXPECT_EQ(list[1].ToBytes(), expItem1);
+		EXPECT_EQ(std::get<1>(actTailRes), end);
+		EXPECT_EQ(std::get<2>(actTailRes), 7);
+	}
+
+	// test ToPrimitive, with items copied out by the regular parser
+	{
+		AbiViewParserListCopy listParser =
+			AbiViewParserListCopy(AbiParserBytes());
+
+		auto actRes = listParser.ToPrimitive(begin, end, begin);
+		const auto& list = std::get<0>(actRes);
+		ASSERT_EQ(list.size(), 2);
+		EXPECT_EQ(
+			list.ToVector(),
+			std::vector<std::vector<uint8_t> >({ expItem0, expItem1 })
+		);
+		EXPECT_EQ(std::get<1>(actRes), begin + 32);
+	}
+
+	// tails in a different order than the heads
+	{
+		std::vector<uint8_t> swappedInput = input;
+		swappedInput[95] = 0x80U;
+		swappedInput[127] = 0x40U;
+		const uint8_t* swappedBegin = swappedInput.data();
+		const uint8_t* swappedEnd = swappedBegin + swappedInput.size();
+		AbiViewParserList listParser = AbiViewParserList(AbiViewParserBytes());
+
+		auto actTailRes = listParser.TailToPrimitive(
+			swappedBegin + 32,
+			swappedEnd
+		);
+		const auto& list = std::get<0>(actTailRes);
+		ASSERT_EQ(list.size(), 2);
+		EXPECT_EQ(list[0].ToBytes(), expItem1);
+		EXPECT_EQ(list[1].ToBytes(), expItem0);
+		// the list ends with the furthest tail, not the tail of the last item
+		EXPECT_EQ(std::get<1>(actTailRes), swappedEnd);
+		EXPECT_EQ(std::get<2>(actTailRes), 7);
+	}
+
+	// Error - the offset of the first item points into the heads
+	{
+		std::vector<uint8_t> badInput = input;
+		badInput[95] = 0x20U;
+		const uint8_t* badBegin = badInput.data();
+		const uint8_t* badEnd = badBegin + badInput.size();
+		AbiViewParserList listParser = AbiViewParserList(AbiViewParserBytes());
+
+		// every item is checked when the view is created
+		EXPECT_THROW(
+			listParser.TailToPrimitive(
+				badBegin + 32,
+				badEnd
+			),
+			EclipseMonitor::Exception
+		);
+	}
+
+	// Error - the tail of the first item runs past the end of the input
+	{
+		std::vector<uint8_t> badInput = input;
+		badInput[159] = 0xFFU;
+		const uint8_t* badBegin = badInput.data();
+		const uint8_t* badEnd = badBegin + badInput.size();
+		AbiViewParserList listParser = AbiViewParserList(AbiViewParserBytes());
+
+		EXPECT_THROW(
+			listParser.TailToPrimitive(
+				badBegin + 32,
+				badEnd
+			),
+			EclipseMonitor::Exception
+		);
+	}
+
+	// Error - the offset is not aligned to chunks
+	{
+		std::vector<uint8_t> badInput = input;
+		badInput[127] = 0x81U;
+		const uint8_t* badBegin = badInput.data();
+		const uint8_t* badEnd = badBegin + badInput.size();
+		AbiViewParserList listParser = AbiViewParserList(AbiViewParserBytes());
+
+		EXPECT_THROW(
+			listParser.TailToPrimitive(
+				badBegin + 32,
+				badEnd
+			),
+			EclipseMonitor::Exception
+		);
+	}
+
+	// Error - truncated input
+	{
+		AbiViewParserList listParser = AbiViewParserList(AbiViewParserBytes());
+
+		EXPECT_THROW(
+			listParser.TailToPrimitive(begin + 32, end - 32),
+			EclipseMonitor::Exception
+		);
+	}
+}
+
+GTEST_TEST(TestEthAbiViewParser, ParseNestedListView)
+{
+	using AbiParserUInt64 =
+		AbiParser<
+			SimpleObjects::ObjCategory::Integer,
+			AbiUInt64
+		>;
+	using AbiViewParserList =
+		AbiViewParser<
+			SimpleObjects::ObjCategory::List,
+			AbiParserUInt64,
+			std::true_type
+		>;
+	using AbiViewParserNestedList =
+		AbiViewParser<
+			SimpleObjects::ObjCategory::List,
+			AbiViewParserList,
+			std::true_type
+		>;
+
+	// uint64[][] = [ [ 1 ], [ 2, 3 ] ]
+	std::vector<uint8_t> input = BuildUIntChunks({
+		0x20U,
+			0x02U, 0x40U, 0x80U,
+				0x01U, 0x01U,
+				0x02U, 0x02U, 0x03U,
+	});
+	const uint8_t* begin = input.data();
+	const uint8_t* end = input.data() + input.size();
+
+	AbiViewParserNestedList listParser =
+		AbiViewParserNestedList(AbiViewParserList(AbiParserUInt64()));
+
+	auto actRes = listParser.ToPrimitive(begin, end, begin);
+	const auto& list = std::get<0>(actRes);
+	ASSERT_EQ(list.size(), 2);
+	EXPECT_EQ(list[0].ToVector(), std::vector<uint64_t>({ 1 }));
+	EXPECT_EQ(list[1].ToVector(), std::vector<uint64_t>({ 2, 3 }));
+	EXPECT_EQ(std::get<1>(actRes), begin + 32);
+}
+
+GTEST_TEST(TestEthAbiViewParser, ParseAliasedTailsView)
+{
+	using AbiParserUInt64 =
+		AbiParser<
+			SimpleObjects::ObjCategory::Integer,
+			AbiUInt64
+		>;
+	using AbiViewParserList =
+		AbiViewParser<
+			SimpleObjects::ObjCategory::List,
+			AbiParserUInt64,
+			std::true_type
+		>;
+	using AbiViewParserList2 =
+		AbiViewParser<
+			SimpleObjects::ObjCategory::List,
+			AbiViewParserList,
+			std::true_type
+		>;
+	using AbiViewParserList3 =
+		AbiViewParser<
+			SimpleObjects::ObjCategory::List,
+			AbiViewParserList2,
+			std::true_type
+		>;
+
+	// all items of each list point to the same tail, so validating every
+	// item would take N^2 steps for an input of about 3N chunks
+	auto buildAliased = [](uint64_t n) -> std::vector<uint8_t>
+	{
+		std::vector<uint8_t> res = BuildUIntChunks({ 0x20U });
+		for (size_t depth = 0; depth < 3; ++depth)
+		{
+			std::vector<uint8_t> list = BuildUIntChunks({ n });
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				// offsets of the outer lists; values of the inner list
+				std::vector<uint8_t> item =
+					BuildUIntChunks({ (depth < 2) ? (n * 32) : i });
+				list.insert(list.end(), item.begin(), item.end());
+			}
+			res.insert(res.end(), list.begin(), list.end());
+		}
+		return res;
+	};
+
+	AbiViewParserList3 listParser = AbiViewParserList3(
+		AbiViewParserList2(AbiViewParserList(AbiParserUInt64()))
+	);
+
+	// a little overlap is fine
+	std::vector<uint8_t> input = buildAliased(1);
+	const uint8_t* begin = input.data();
+	const uint8_t* end = input.data() + input.size();
+	auto actRes = listParser.ToPrimitive(begin, end, begin);
+	const auto& list = std::get<0>(actRes);
+	ASSERT_EQ(list.size(), 1);
+	EXPECT_EQ(list[0][0].ToVector(), std::vector<uint64_t>({ 0 }));
+
+	input = buildAliased(64);
+	begin = input.data();
+	end = input.data() + input.size();
+	EXPECT_THROW(
+		listParser.ToPrimitive(begin, end, begin),
+		EclipseMonitor::Exception
+	);
+}
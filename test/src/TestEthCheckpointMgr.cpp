@@ -217,3 +217,193 @@ GTEST_TEST(TestEthCheckpointMgr, Normal_Runtime_Add)
 		);
 	);
 }
+
+GTEST_TEST(TestEthCheckpointMgr, WindowRingRollOver)
+{
+	// Testing configurations
+	static constexpr size_t testingChkptSize = 7;
+	static constexpr size_t testingNumBootstrap = 2 * testingChkptSize;
+	static constexpr size_t testingNumHeaders = 100;
+
+	// testing sync state
+	std::shared_ptr<SyncState> devSyncState =
+		std::make_shared<SyncState>(SyncState::GetDevSyncState());
+
+	EclipseMonitor::MonitorConfig mConf;
+	mConf.get_checkpointSize() = testingChkptSize;
+
+	// every completed window must contain consecutive headers, no matter
+	// where it starts in the ring
+	size_t numOfChkpt = 0;
+	auto checkWindow = [&numOfChkpt](const CheckpointMgr& mgr)
+	{
+		std::vector<BlockNumber> blkNums;
+		mgr.IterateCurrWindow(
+			[&blkNums](const HeaderMgr& header)
+			{
+				blkNums.push_back(header.GetNumber());
+			}
+		);
+		ASSERT_EQ(blkNums.size(), testingChkptSize);
+		for (size_t i = 0; i < blkNums.size(); ++i)
+		{
+			EXPECT_EQ(blkNums[i], (numOfChkpt * testingChkptSize) + i);
+		}
+		++numOfChkpt;
+	};
+
+	std::unique_ptr<CheckpointMgr> chkptMgr;
+	chkptMgr = SimpleObjects::Internal::make_unique<CheckpointMgr>(
+		mConf,
+		[&chkptMgr, &checkWindow](){
+			checkWindow(*chkptMgr);
+		});
+
+	for (size_t i = 0; i < testingNumBootstrap; ++i)
+	{
+		chkptMgr->AddHeader(SimpleObjects::Internal::make_unique<HeaderMgr>(
+			GetEthHistHdr_0_100()[i], 0));
+	}
+	chkptMgr->EndBootstrapPhase(devSyncState);
+
+	for (size_t i = testingNumBootstrap; i < testingNumHeaders; ++i)
+	{
+		auto header = SimpleObjects::Internal::make_unique<HeaderMgr>(
+			GetEthHistHdr_0_100()[i], 0);
+		chkptMgr->AddNode(SimpleObjects::Internal::make_unique<HeaderNode>(
+			std::move(header),
+			devSyncState
+		));
+
+		// restore a copy in the middle of a window, which must keep
+		// receiving headers the same way
+		if (i == (testingNumHeaders / 2))
+		{
+			auto snapshot = chkptMgr->ToSnapshot();
+			std::unique_ptr<CheckpointMgr> restored;
+			restored = SimpleObjects::Internal::make_unique<CheckpointMgr>(
+				mConf,
+				[&chkptMgr, &checkWindow](){
+					checkWindow(*chkptMgr);
+				});
+			restored->RestoreFromSnapshot(snapshot, devSyncState);
+			EXPECT_EQ(restored->ToSnapshot(), snapshot);
+			EXPECT_EQ(
+				restored->GetDiffMedian(),
+				chkptMgr->GetDiffMedian()
+			);
+			EXPECT_EQ(
+				restored->GetNumOfCandidates(),
+				chkptMgr->GetNumOfCandidates()
+			);
+			chkptMgr = std::move(restored);
+		}
+	}
+	EXPECT_EQ(numOfChkpt, testingNumHeaders / testingChkptSize);
+	EXPECT_EQ(
+		chkptMgr->GetLastHeader().GetNumber(),
+		testingNumHeaders - 1
+	);
+}
+
+GTEST_TEST(TestEthCheckpointMgr, DiffOrderStatistics)
+{
+	// Testing configurations
+	static constexpr size_t testingChkptSize = 9;
+	static constexpr size_t testingNumBootstrap = 2 * testingChkptSize;
+	static constexpr size_t testingNumHeaders = 100;
+
+	// testing sync state
+	std::shared_ptr<SyncState> devSyncState =
+		std::make_shared<SyncState>(SyncState::GetDevSyncState());
+
+	std::vector<Difficulty> allDiffs;
+	for (size_t i = 0; i < testingNumHeaders; ++i)
+	{
+		HeaderMgr header(GetEthHistHdr_0_100()[i], 0);
+		allDiffs.push_back(header.GetDiff());
+	}
+	auto sortedDiffs = [&allDiffs](size_t begin, size_t end)
+	{
+		std::vector<Difficulty> diffs(
+			allDiffs.begin() + begin,
+			allDiffs.begin() + end
+		);
+		std::sort(diffs.begin(), diffs.end());
+		return diffs;
+	};
+
+	EclipseMonitor::MonitorConfig mConf;
+	mConf.get_checkpointSize() = testingChkptSize;
+
+	size_t numOfChkpt = 0;
+	std::unique_ptr<CheckpointMgr> chkptMgr;
+	chkptMgr = SimpleObjects::Internal::make_unique<CheckpointMgr>(
+		mConf,
+		[&chkptMgr, &numOfChkpt, &sortedDiffs](){
+			auto expDiffs = sortedDiffs(
+				numOfChkpt * testingChkptSize,
+				(numOfChkpt + 1) * testingChkptSize
+			);
+			EXPECT_EQ(chkptMgr->GetDiffPercentile(0), expDiffs.front());
+			EXPECT_EQ(chkptMgr->GetDiffPercentile(100), expDiffs.back());
+			EXPECT_EQ(
+				chkptMgr->GetDiffMedian(),
+				expDiffs[expDiffs.size() / 2]
+			);
+			++numOfChkpt;
+		});
+	EXPECT_THROW(chkptMgr->GetDiffMedian(), EclipseMonitor::Exception);
+
+	// the recent window slides on every header
+	auto checkRecent = [&chkptMgr, &sortedDiffs](size_t numOfAdded)
+	{
+		size_t begin = numOfAdded > testingChkptSize ?
+			numOfAdded - testingChkptSize : 0;
+		auto expDiffs = sortedDiffs(begin, numOfAdded);
+		const auto& recent = chkptMgr->GetRecentDiffs();
+		ASSERT_EQ(recent.Size(), expDiffs.size());
+		for (size_t i = 0; i < expDiffs.size(); ++i)
+		{
+			EXPECT_EQ(recent.GetNth(i), expDiffs[i]);
+		}
+	};
+
+	for (size_t i = 0; i < testingNumBootstrap; ++i)
+	{
+		chkptMgr->AddHeader(SimpleObjects::Internal::make_unique<HeaderMgr>(
+			GetEthHistHdr_0_100()[i], 0));
+		checkRecent(i + 1);
+	}
+	chkptMgr->EndBootstrapPhase(devSyncState);
+	EXPECT_EQ(chkptMgr->GetCurrWindowDiffs().Size(), testingChkptSize);
+
+	std::unique_ptr<CheckpointMgr> restored;
+	for (size_t i = testingNumBootstrap; i < testingNumHeaders; ++i)
+	{
+		auto header = SimpleObjects::Internal::make_unique<HeaderMgr>(
+			GetEthHistHdr_0_100()[i], 0);
+		chkptMgr->AddNode(SimpleObjects::Internal::make_unique<HeaderNode>(
+			std::move(header),
+			devSyncState
+		));
+		checkRecent(i + 1);
+
+		// the restored manager must have the same statistics
+		restored = SimpleObjects::Internal::make_unique<CheckpointMgr>(
+			mConf,
+			[](){}
+		);
+		restored->RestoreFromSnapshot(chkptMgr->ToSnapshot(), devSyncState);
+		EXPECT_EQ(restored->GetDiffMedian(), chkptMgr->GetDiffMedian());
+		EXPECT_EQ(
+			restored->GetRecentDiffs().GetPercentile(50),
+			chkptMgr->GetRecentDiffs().GetPercentile(50)
+		);
+		EXPECT_EQ(
+			restored->GetRecentDiffs().Size(),
+			chkptMgr->GetRecentDiffs().Size()
+		);
+	}
+	EXPECT_EQ(numOfChkpt, testingNumHeaders / testingChkptSize);
+}
@@ -4,6 +4,8 @@
 // https://opensource.org/licenses/MIT.
 
 #include <array>
+#include <iterator>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -47,31 +49,28 @@ struct TestBlkHeader
 	{}
 }; // struct TestBlkHeader
 
+static HeaderMgr BuildHeaderMgr(const TestBlkHeader& header)
+{
+	HeaderMgr headerMgr;
+	headerMgr.SetNumber(header.m_blkNum);
+	headerMgr.SetTime(header.m_time);
+	headerMgr.SetDiff(header.m_diff);
+	headerMgr.SetUncleHash(
+		header.m_hasUncle ?
+			HeaderMgr::BytesObjType({ 0x00U }) :
+			HeaderMgr::GetEmptyUncleHash()
+	);
+	return headerMgr;
+}
+
 template<typename _DAA>
 static void TestDiffCalcResult(
 	const TestBlkHeader& parent,
 	const TestBlkHeader& curr
 )
 {
-	HeaderMgr parentHeaderMgr;
-	parentHeaderMgr.SetNumber(parent.m_blkNum);
-	parentHeaderMgr.SetTime(parent.m_time);
-	parentHeaderMgr.SetDiff(parent.m_diff);
-	parentHeaderMgr.SetUncleHash(
-		parent.m_hasUncle ?
-			HeaderMgr::BytesObjType({ 0x00U }) :
-			HeaderMgr::GetEmptyUncleHash()
-	);
-
-	HeaderMgr currHeaderMgr;
-	currHeaderMgr.SetNumber(curr.m_blkNum);
-	currHeaderMgr.SetTime(curr.m_time);
-	currHeaderMgr.SetDiff(curr.m_diff);
-	currHeaderMgr.SetUncleHash(
-		curr.m_hasUncle ?
-			HeaderMgr::BytesObjType({ 0x00U }) :
-			HeaderMgr::GetEmptyUncleHash()
-	);
+	HeaderMgr parentHeaderMgr = BuildHeaderMgr(parent);
+	HeaderMgr currHeaderMgr = BuildHeaderMgr(curr);
 
 	EXPECT_EQ(
 		_DAA()(parentHeaderMgr, currHeaderMgr),
@@ -343,3 +342,151 @@ GTEST_TEST(TestEthDAA, HardforkTest_Goerli_Paris)
 	};
 	EXPECT_THROW(test3(), EclipseMonitor::Exception);
 }
+
+
+GTEST_TEST(TestEthDAA, ForkSchedule)
+{
+	// the schedule is resolved at compile time
+	static_assert(
+		MainnetConfig::GetFork(0) == Forks::Frontier,
+		"Wrong fork for the genesis block"
+	);
+	static_assert(
+		MainnetConfig::GetFork(15537394UL) == Forks::Paris,
+		"Wrong fork for the Paris block"
+	);
+
+	EXPECT_TRUE(MainnetConfig::GetFork(1149999UL) == Forks::Frontier);
+	EXPECT_TRUE(MainnetConfig::GetFork(1150000UL) == Forks::Homestead);
+	EXPECT_TRUE(MainnetConfig::GetFork(4370000UL) == Forks::Byzantium);
+	EXPECT_TRUE(MainnetConfig::GetFork(9199999UL) == Forks::Constantinople);
+	EXPECT_TRUE(MainnetConfig::GetFork(9200000UL) == Forks::MuirGlacier);
+	EXPECT_TRUE(MainnetConfig::GetFork(12965000UL) == Forks::London);
+	EXPECT_TRUE(MainnetConfig::GetFork(13773000UL) == Forks::ArrowGlacier);
+	EXPECT_TRUE(MainnetConfig::GetFork(15537393UL) == Forks::GrayGlacier);
+	EXPECT_TRUE(MainnetConfig::GetFork(20000000UL) == Forks::Paris);
+	EXPECT_EQ(MainnetConfig::GetForkEndBlkNum(Forks::Homestead), 4370000UL);
+
+	// forks that are never activated on Goerli
+	EXPECT_TRUE(GoerliConfig::GetFork(0) == Forks::Constantinople);
+	EXPECT_TRUE(GoerliConfig::GetFork(5062604UL) == Forks::Constantinople);
+	EXPECT_TRUE(GoerliConfig::GetFork(5062605UL) == Forks::London);
+	EXPECT_TRUE(GoerliConfig::GetFork(7382819UL) == Forks::Paris);
+	EXPECT_FALSE(GoerliConfig::IsBlockOfMuirGlacier(6000000UL));
+	EXPECT_FALSE(GoerliConfig::IsBlockOfGrayGlacier(7382819UL));
+	EXPECT_TRUE(GoerliConfig::IsBlockOfLondon(5062605UL));
+	EXPECT_FALSE(GoerliConfig::IsBlockOfLondon(5062604UL));
+	EXPECT_TRUE(GoerliConfig::IsBlockOfHomestead(0));
+
+	// the schedule is sorted
+	for (size_t i = 1; i < MainnetConfig::sk_numOfForks; ++i)
+	{
+		EXPECT_LE(
+			MainnetConfig::sk_forkSchedule[i - 1],
+			MainnetConfig::sk_forkSchedule[i]
+		);
+		EXPECT_LE(
+			GoerliConfig::sk_forkSchedule[i - 1],
+			GoerliConfig::sk_forkSchedule[i]
+		);
+	}
+}
+
+
+namespace
+{
+
+class TestBombDAA : public DAABase
+{
+public:
+
+	static DiffType CalcBombByMul(const BlkNumType& periodCount)
+	{
+		DiffType y = 1;
+		for (BlkNumType i = 2; i < periodCount; ++i)
+		{
+			y *= 2;
+		}
+		return y;
+	}
+
+	using DAABase::CalcBomb;
+
+	virtual DiffType operator()(
+		const HeaderMgr&,
+		const HeaderMgr&
+	) const override
+	{
+		return 0;
+	}
+}; // class TestBombDAA
+
+} // namespace
+
+
+GTEST_TEST(TestEthDAA, CalcBomb)
+{
+	for (BlockNumber periodCount = 0; periodCount < 100; ++periodCount)
+	{
+		EXPECT_EQ(
+			TestBombDAA::CalcBomb(periodCount),
+			TestBombDAA::CalcBombByMul(periodCount)
+		);
+	}
+}
+
+
+GTEST_TEST(TestEthDAA, CalcBatch)
+{
+	// a chain crossing the Homestead fork, so the calculator is looked up
+	// again in the middle of the batch
+	std::vector<TestBlkHeader> testChain = {
+		TestBlkHeader(1149998UL, 1457981335UL, 20503153557831ULL, false),
+		TestBlkHeader(1149999UL, 1457981342UL, 20513164863791ULL, false),
+		TestBlkHeader(1150000UL, 1457981393UL, 20473100089179ULL, false),
+		TestBlkHeader(1150001UL, 1457981402UL, 20483096720593ULL, false),
+		TestBlkHeader(1150002UL, 1457981409UL, 20493098233175ULL, false),
+	};
+
+	std::vector<HeaderMgr> headers;
+	for (const auto& header : testChain)
+	{
+		headers.push_back(BuildHeaderMgr(header));
+	}
+
+	MainnetDAA daa;
+	std::vector<Difficulty> diffs;
+	daa.CalcBatch(headers.begin(), headers.end(), std::back_inserter(diffs));
+	ASSERT_EQ(diffs.size(), testChain.size() - 1);
+	for (size_t i = 1; i < testChain.size(); ++i)
+	{
+		EXPECT_EQ(diffs[i - 1], testChain[i].m_diff);
+		EXPECT_EQ(diffs[i - 1], daa(headers[i - 1], headers[i]));
+	}
+
+	// empty and single-header sequences give nothing
+	diffs.clear();
+	daa.CalcBatch(headers.begin(), headers.begin(), std::back_inserter(diffs));
+	daa.CalcBatch(
+		headers.begin(),
+		headers.begin() + 1,
+		std::back_inserter(diffs)
+	);
+	EXPECT_TRUE(diffs.empty());
+
+	// blocks since Paris don't use DAA
+	std::vector<HeaderMgr> parisHeaders = {
+		BuildHeaderMgr(
+			TestBlkHeader(15537393UL, 1663224162UL, 11055787484078698ULL, false)
+		),
+		BuildHeaderMgr(TestBlkHeader(15537394UL, 1663224179UL, 0ULL, false)),
+	};
+	EXPECT_THROW(
+		daa.CalcBatch(
+			parisHeaders.begin(),
+			parisHeaders.end(),
+			std::back_inserter(diffs)
+		),
+		EclipseMonitor::Exception
+	);
+}
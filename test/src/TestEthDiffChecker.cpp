@@ -5,6 +5,9 @@
 
 #include <gtest/gtest.h>
 
+#include <limits>
+#include <vector>
+
 #include <EclipseMonitor/Eth/BloomFilter.hpp>
 #include <EclipseMonitor/Eth/DAA.hpp>
 #include <EclipseMonitor/Eth/DiffChecker.hpp>
@@ -143,4 +146,97 @@ GTEST_TEST(TestEthDiffChecker, TestHistBlocks)
 	// Wrong - difficulty too low
 	EXPECT_FALSE(
 		diffCheckerFixedEst.CheckEstDifficulty(okHeaderParent, 15));
+
+	// ===== CalcExpiryTime
+	// expires once the estimated difficulty drops below the min difficulty
+	uint64_t expTime = diffChecker.CalcExpiryTime(okHeaderParent);
+	EXPECT_GT(expTime, okHeaderParent.GetTrustedTime());
+	EXPECT_LE(expTime, okHeaderParent.GetTrustedTime() + sk_maxWaitTime + 1);
+	EXPECT_TRUE(
+		diffChecker.CheckEstDifficulty(okHeaderParent, expTime - 1));
+	EXPECT_FALSE(
+		diffChecker.CheckEstDifficulty(okHeaderParent, expTime));
+	EXPECT_FALSE(
+		diffChecker.CheckEstDifficulty(okHeaderParent, expTime + 1));
+
+	// expires after the max wait time, if the difficulty is high enough
+	auto highDiffHeaderBin = BuildHeader(15050001UL, expDiffMin * 1000);
+	auto highDiffHeader = HeaderMgr(highDiffHeaderBin, 10);
+	EXPECT_EQ(
+		diffChecker.CalcExpiryTime(highDiffHeader),
+		highDiffHeader.GetTrustedTime() + sk_maxWaitTime + 1);
+
+	// already expired - difficulty too low
+	EXPECT_EQ(
+		diffCheckerFixedEst.CalcExpiryTime(okHeaderParent),
+		okHeaderParent.GetTrustedTime());
+
+	// never expires - Proof-of-Stake
+	auto posHeaderBin = BuildHeader(16000000UL, 0);
+	auto posHeader = HeaderMgr(posHeaderBin, 10);
+	EXPECT_EQ(
+		diffCheckerFixedEst.CalcExpiryTime(posHeader),
+		std::numeric_limits<uint64_t>::max());
+}
+
+
+GTEST_TEST(TestEthDiffChecker, DefaultCalcExpiryTime)
+{
+	// a checker that only accepts the time before a fixed deadline,
+	// so the default implementation has to search for it
+	class DeadlineDiffChecker : public DiffCheckerBase
+	{
+	public:
+
+		DeadlineDiffChecker(uint64_t deadline) :
+			m_deadline(deadline),
+			m_numOfChecks(0)
+		{}
+
+		virtual ~DeadlineDiffChecker() = default;
+
+		virtual void OnChkptUpd(const CheckpointMgr&) override
+		{}
+
+		virtual bool CheckDifficulty(
+			const HeaderMgr&,
+			const HeaderMgr&
+		) const override
+		{
+			return true;
+		}
+
+		virtual bool CheckEstDifficulty(
+			const HeaderMgr&,
+			uint64_t currentTime
+		) const override
+		{
+			++m_numOfChecks;
+			return currentTime < m_deadline;
+		}
+
+		uint64_t m_deadline;
+		mutable size_t m_numOfChecks;
+	}; // class DeadlineDiffChecker
+
+	auto headerBin = BuildHeader(15050001UL, 1);
+	auto header = HeaderMgr(headerBin, 10);
+
+	for (uint64_t deadline : std::vector<uint64_t>({
+		0, 10, 11, 12, 13, 100, 12345, 1ULL << 40,
+		std::numeric_limits<uint64_t>::max() - 1,
+	}))
+	{
+		DeadlineDiffChecker checker(deadline);
+		uint64_t expTime = deadline < 10 ? 10 : deadline;
+		EXPECT_EQ(checker.CalcExpiryTime(header), expTime);
+		// only a logarithmic number of checks are needed
+		EXPECT_LE(checker.m_numOfChecks, 130U);
+	}
+
+	// never expires
+	DeadlineDiffChecker checker(std::numeric_limits<uint64_t>::max());
+	EXPECT_EQ(
+		checker.CalcExpiryTime(header),
+		std::numeric_limits<uint64_t>::max());
 }
@@ -0,0 +1,1018 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <EclipseMonitor/Eth/EclipseMonitor.hpp>
+#include <EclipseMonitor/WorkerPool.hpp>
+
+#include "EthHistHdr_0_100.hpp"
+#include "EthHistHdr_Malformed.hpp"
+
+
+namespace EclipseMonitor_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+using namespace EclipseMonitor_Test;
+
+using namespace EclipseMonitor;
+using namespace EclipseMonitor::Eth;
+
+
+namespace
+{
+
+class TestTimestamper : public TimestamperBase
+{
+public:
+	TestTimestamper(TrustedTimestamp now = 0) :
+		TimestamperBase(),
+		m_now(now)
+	{}
+
+	virtual ~TestTimestamper() = default;
+
+	virtual TrustedTimestamp NowInSec() const override
+	{
+		// every call moves the clock forward by one second
+		return ++m_now;
+	}
+
+	mutable TrustedTimestamp m_now;
+}; // class TestTimestamper
+
+
+class TestRandomGenerator : public RandomGeneratorBase
+{
+public:
+	TestRandomGenerator() :
+		RandomGeneratorBase()
+	{}
+
+	virtual ~TestRandomGenerator() = default;
+
+	virtual void GenerateRandomBytes(uint8_t* buf, size_t len) const override
+	{
+		std::memset(buf, 0x5A, len);
+	}
+}; // class TestRandomGenerator
+
+
+struct TestMonitorRecord
+{
+	std::vector<BlockNumber> m_validated;
+	std::vector<BlockNumber> m_confirmed;
+}; // struct TestMonitorRecord
+
+
+static constexpr uint64_t sk_testCheckpointSize = 10;
+
+
+using SnapshotHashType =
+	typename EclipseMonitor::Eth::EclipseMonitor::SnapshotHashType;
+
+
+/**
+ * @brief Build a monitor for testing; if a snapshot is given, the monitor is
+ *        restored from it, and checked against the given trusted hash;
+ *        otherwise, it's planned to bootstrap with all testing headers
+ *
+ */
+std::unique_ptr<EclipseMonitor::Eth::EclipseMonitor> BuildTestMonitor(
+	TestMonitorRecord& record,
+	const std::vector<uint8_t>* snapshot = nullptr,
+	const SnapshotHashType* snapshotHash = nullptr,
+	TrustedTimestamp startTime = 0,
+	uint64_t checkpointSize = sk_testCheckpointSize
+)
+{
+	MonitorConfig mConf = BuildEthereumMonitorConfig();
+	mConf.get_checkpointSize() = checkpointSize;
+
+	auto onValidated = [&record](const HeaderMgr& header)
+	{
+		record.m_validated.push_back(header.GetNumber());
+	};
+	auto onConfirmed = [&record](const HeaderMgr& header)
+	{
+		record.m_confirmed.push_back(header.GetNumber());
+	};
+
+	if (snapshot != nullptr)
+	{
+		return SimpleObjects::Internal::make_unique<
+			EclipseMonitor::Eth::EclipseMonitor
+		>(
+			mConf,
+			SimpleObjects::Internal::make_unique<TestTimestamper>(startTime),
+			SimpleObjects::Internal::make_unique<TestRandomGenerator>(),
+			onValidated,
+			onConfirmed,
+			SimpleObjects::Internal::make_unique<Validator<MainnetConfig> >(
+				SimpleObjects::Internal::make_unique<MainnetDAA>()
+			),
+			SimpleObjects::Internal::make_unique<DiffCheckerMainNet>(
+				mConf,
+				SimpleObjects::Internal::make_unique<MainnetDAAEstimator>()
+			),
+			ContractAddr(),
+			EventTopic(),
+			*snapshot,
+			*snapshotHash
+		);
+	}
+
+	auto monitor =
+		SimpleObjects::Internal::make_unique<EclipseMonitor::Eth::EclipseMonitor>(
+			mConf,
+			SimpleObjects::Internal::make_unique<TestTimestamper>(startTime),
+			SimpleObjects::Internal::make_unique<TestRandomGenerator>(),
+			onValidated,
+			onConfirmed,
+			SimpleObjects::Internal::make_unique<Validator<MainnetConfig> >(
+				SimpleObjects::Internal::make_unique<MainnetDAA>()
+			),
+			SimpleObjects::Internal::make_unique<DiffCheckerMainNet>(
+				mConf,
+				SimpleObjects::Internal::make_unique<MainnetDAAEstimator>()
+			),
+			ContractAddr(),
+			EventTopic()
+		);
+
+	BlockNumber startBlkNum = 0;
+	monitor->RefreshBootstrapPlan(
+		GetEthHistHdr_0_100().size() - 1,
+		&startBlkNum
+	);
+
+	return monitor;
+}
+
+
+void ExpectSameResult(
+	const EclipseMonitorBase& monitor,
+	const TestMonitorRecord& record,
+	const EclipseMonitorBase& expMonitor,
+	const TestMonitorRecord& expRecord
+)
+{
+	EXPECT_EQ(monitor.GetPhase(), expMonitor.GetPhase());
+	EXPECT_EQ(monitor.GetMonitorSecState(), expMonitor.GetMonitorSecState());
+	EXPECT_EQ(record.m_validated, expRecord.m_validated);
+	EXPECT_EQ(record.m_confirmed, expRecord.m_confirmed);
+}
+
+} // namespace
+
+
+GTEST_TEST(TestEthEclipseMonitor, CountTestFile)
+{
+	static auto tmp = ++g_numOfTestFile;
+	(void)tmp;
+}
+
+
+GTEST_TEST(TestEthEclipseMonitor, UpdateBatchMatchesUpdate)
+{
+	const auto& headers = GetEthHistHdr_0_100();
+
+	// Expected results
+	TestMonitorRecord expRecord;
+	auto expMonitor = BuildTestMonitor(expRecord);
+	for (const auto& header : headers)
+	{
+		expMonitor->Update(header);
+	}
+
+	// bootstrap I must have ended, and some headers must be confirmed,
+	// otherwise this test is not meaningful
+	EXPECT_NE(expMonitor->GetPhase(), Phases::BootstrapI);
+	EXPECT_GT(expRecord.m_confirmed.size(), 0U);
+
+	// Test without worker pool
+	{
+		TestMonitorRecord record;
+		auto monitor = BuildTestMonitor(record);
+		EXPECT_NO_THROW(monitor->UpdateBatch(headers.begin(), headers.end()));
+
+		ExpectSameResult(*monitor, record, *expMonitor, expRecord);
+	}
+
+	// Test with worker pool
+	{
+		ThreadWorkerPool workerPool(3);
+		TestMonitorRecord record;
+		auto monitor = BuildTestMonitor(record);
+		EXPECT_NO_THROW(
+			monitor->UpdateBatch(headers.begin(), headers.end(), &workerPool)
+		);
+
+		ExpectSameResult(*monitor, record, *expMonitor, expRecord);
+	}
+
+	// Test with worker pool, in multiple batches
+	{
+		ThreadWorkerPool workerPool(2);
+		TestMonitorRecord record;
+		auto monitor = BuildTestMonitor(record);
+		EXPECT_NO_THROW(
+			monitor->UpdateBatch(
+				headers.begin(), headers.begin() + 42, &workerPool
+			)
+		);
+		EXPECT_NO_THROW(
+			monitor->UpdateBatch(
+				headers.begin() + 42, headers.end(), &workerPool
+			)
+		);
+
+		ExpectSameResult(*monitor, record, *expMonitor, expRecord);
+	}
+}
+
+
+GTEST_TEST(TestEthEclipseMonitor, UpdateOverloads)
+{
+	const auto& headers = GetEthHistHdr_0_100();
+
+	// Expected results
+	TestMonitorRecord expRecord;
+	auto expMonitor = BuildTestMonitor(expRecord);
+	for (const auto& header : headers)
+	{
+		expMonitor->Update(header);
+	}
+
+	// Test with rvalue header binaries, which bind to the const reference
+	{
+		TestMonitorRecord record;
+		auto monitor = BuildTestMonitor(record);
+		for (const auto& header : headers)
+		{
+			std::vector<uint8_t> headerCopy = header;
+			EXPECT_NO_THROW(monitor->Update(std::move(headerCopy)));
+		}
+
+		ExpectSameResult(*monitor, record, *expMonitor, expRecord);
+	}
+
+	// Test with header binaries stored in a large buffer
+	{
+		std::vector<uint8_t> buffer;
+		std::vector<std::pair<size_t, size_t> > ranges;
+		for (const auto& header : headers)
+		{
+			ranges.push_back(std::make_pair(buffer.size(), header.size()));
+			buffer.insert(buffer.end(), header.begin(), header.end());
+		}
+
+		TestMonitorRecord record;
+		auto monitor = BuildTestMonitor(record);
+		for (const auto& range : ranges)
+		{
+			EXPECT_NO_THROW(
+				monitor->Update(buffer.data() + range.first, range.second)
+			);
+		}
+
+		ExpectSameResult(*monitor, record, *expMonitor, expRecord);
+	}
+}
+
+
+GTEST_TEST(TestEthEclipseMonitor, UpdateBatchStopsAtFailure)
+{
+	ThreadWorkerPool workerPool(2);
+
+	// header failed to be parsed
+	{
+		std::vector<std::vector<uint8_t> > headers = {
+			GetEthHistHdr_0_100()[0],
+			GetEthHistHdr_0_100()[1],
+			std::vector<uint8_t>({ 0x00U, }),
+			GetEthHistHdr_0_100()[2],
+		};
+
+		TestMonitorRecord record;
+		auto monitor = BuildTestMonitor(record);
+		EXPECT_ANY_THROW(
+			monitor->UpdateBatch(headers.begin(), headers.end(), &workerPool)
+		);
+		EXPECT_EQ(record.m_validated, std::vector<BlockNumber>({ 0, 1, }));
+	}
+
+	// header failed to be validated
+	{
+		std::vector<std::vector<uint8_t> > headers = {
+			GetEthHistHdr_0_100()[0],
+			GetEthHeaderBin_1_ErrParentHash(),
+			GetEthHistHdr_0_100()[2],
+		};
+
+		TestMonitorRecord record;
+		auto monitor = BuildTestMonitor(record);
+		EXPECT_THROW(
+			monitor->UpdateBatch(headers.begin(), headers.end(), &workerPool),
+			EclipseMonitor::Exception
+		);
+		EXPECT_EQ(record.m_validated, std::vector<BlockNumber>({ 0, }));
+	}
+}
+
+
+GTEST_TEST(TestEthEclipseMonitor, UpdateBatchLinkageInBootstrapI)
+{
+	ThreadWorkerPool workerPool(3);
+	const auto& histHdrs = GetEthHistHdr_0_100();
+
+	// broken link in the middle of a chunk
+	{
+		std::vector<std::vector<uint8_t> > headers(
+			histHdrs.begin(), histHdrs.begin() + 6
+		);
+		headers.push_back(histHdrs[7]);
+		headers.push_back(histHdrs[8]);
+
+		TestMonitorRecord record;
+		auto monitor = BuildTestMonitor(record);
+		EXPECT_THROW(
+			monitor->UpdateBatch(headers.begin(), headers.end(), &workerPool),
+			EclipseMonitor::Exception
+		);
+		EXPECT_EQ(
+			record.m_validated,
+			std::vector<BlockNumber>({ 0, 1, 2, 3, 4, 5, })
+		);
+		EXPECT_EQ(monitor->GetPhase(), Phases::BootstrapI);
+	}
+
+	// a chunk that is linked internally, but not linked to the checkpoint
+	{
+		TestMonitorRecord record;
+		auto monitor = BuildTestMonitor(record);
+		EXPECT_NO_THROW(
+			monitor->UpdateBatch(
+				histHdrs.begin(), histHdrs.begin() + 5, &workerPool
+			)
+		);
+		EXPECT_THROW(
+			monitor->UpdateBatch(
+				histHdrs.begin() + 6, histHdrs.begin() + 12, &workerPool
+			),
+			EclipseMonitor::Exception
+		);
+		EXPECT_EQ(
+			record.m_validated,
+			std::vector<BlockNumber>({ 0, 1, 2, 3, 4, })
+		);
+
+		// the monitor can continue from where it stopped
+		EXPECT_NO_THROW(
+			monitor->UpdateBatch(
+				histHdrs.begin() + 5, histHdrs.end(), &workerPool
+			)
+		);
+
+		TestMonitorRecord expRecord;
+		auto expMonitor = BuildTestMonitor(expRecord);
+		for (const auto& header : histHdrs)
+		{
+			expMonitor->Update(header);
+		}
+		ExpectSameResult(*monitor, record, *expMonitor, expRecord);
+	}
+}
+
+
+
+GTEST_TEST(TestEthEclipseMonitor, SnapshotRestore)
+{
+	const auto& headers = GetEthHistHdr_0_100();
+
+	// take snapshots during bootstrap I, bootstrap II, and sync phase
+	for (size_t numOfHeaders : std::vector<size_t>({ 1, 35, 85, 100 }))
+	{
+		TestMonitorRecord expRecord;
+		auto expMonitor = BuildTestMonitor(expRecord);
+		for (size_t i = 0; i < numOfHeaders; ++i)
+		{
+			expMonitor->Update(headers[i]);
+		}
+		const Phases snapshotPhase = expMonitor->GetPhase();
+		const EclipseMonitorBase& expMonitorBase = *expMonitor;
+
+		const auto snapshot = expMonitor->TakeSnapshot();
+		const auto snapshotHash =
+			EclipseMonitor::Eth::EclipseMonitor::GetSnapshotHash(snapshot);
+		size_t numOfConfirmed = expRecord.m_confirmed.size();
+
+		// the clock keeps going after the restart
+		TestMonitorRecord record;
+		auto monitor = BuildTestMonitor(
+			record,
+			&snapshot,
+			&snapshotHash,
+			expMonitorBase.GetTimestamper().NowInSec()
+		);
+		const EclipseMonitorBase& monitorBase = *monitor;
+
+		EXPECT_EQ(
+			monitorBase.GetMonitorSecState(),
+			expMonitorBase.GetMonitorSecState()
+		);
+		EXPECT_EQ(monitor->GetStartBlockNum(), expMonitor->GetStartBlockNum());
+		EXPECT_EQ(
+			monitor->GetBootstrapIEndBlkNum(),
+			expMonitor->GetBootstrapIEndBlkNum()
+		);
+		EXPECT_EQ(
+			monitor->GetPlanedSyncBlkNum(),
+			expMonitor->GetPlanedSyncBlkNum()
+		);
+		// the restored monitor needs to sync again
+		EXPECT_EQ(
+			monitor->GetPhase(),
+			(snapshotPhase == Phases::BootstrapI) ?
+				Phases::BootstrapI : Phases::BootstrapII
+		);
+		// the snapshot of the restored monitor is the same, unless the phase
+		// is changed
+		if (monitor->GetPhase() == snapshotPhase)
+		{
+			EXPECT_EQ(
+				EclipseMonitor::Eth::EclipseMonitor::GetSnapshotHash(
+					monitor->TakeSnapshot()
+				),
+				snapshotHash
+			);
+		}
+
+		// both monitors continue with the remaining headers
+		for (size_t i = numOfHeaders; i < headers.size(); ++i)
+		{
+			expMonitor->Update(headers[i]);
+			monitor->Update(headers[i]);
+		}
+
+		EXPECT_EQ(
+			monitorBase.GetMonitorSecState(),
+			expMonitorBase.GetMonitorSecState()
+		);
+		EXPECT_EQ(
+			record.m_confirmed,
+			std::vector<BlockNumber>(
+				expRecord.m_confirmed.begin() + numOfConfirmed,
+				expRecord.m_confirmed.end()
+			)
+		);
+	}
+}
+
+
+GTEST_TEST(TestEthEclipseMonitor, SnapshotRestorePassedSyncPlan)
+{
+	const auto& headers = GetEthHistHdr_0_100();
+
+	TestMonitorRecord expRecord;
+	auto expMonitor = BuildTestMonitor(expRecord);
+	for (size_t i = 0; i < 80; ++i)
+	{
+		expMonitor->Update(headers[i]);
+	}
+	ASSERT_EQ(expMonitor->GetPhase(), Phases::BootstrapII);
+
+	// the sync block is planned at #82, which is passed before the snapshot
+	expMonitor->RefreshBootstrapPlan(82);
+	for (size_t i = 80; i < 85; ++i)
+	{
+		expMonitor->Update(headers[i]);
+	}
+	ASSERT_EQ(expMonitor->GetPhase(), Phases::Sync);
+	const EclipseMonitorBase& expMonitorBase = *expMonitor;
+	const auto snapshot = expMonitor->TakeSnapshot();
+	const auto snapshotHash =
+		EclipseMonitor::Eth::EclipseMonitor::GetSnapshotHash(snapshot);
+
+	TestMonitorRecord record;
+	auto monitor = BuildTestMonitor(
+		record,
+		&snapshot,
+		&snapshotHash,
+		expMonitorBase.GetTimestamper().NowInSec()
+	);
+	EXPECT_EQ(monitor->GetPhase(), Phases::BootstrapII);
+	EXPECT_EQ(monitor->GetPlanedSyncBlkNum(), 82U);
+
+	// the first header after the restore is past the plan, so the sync
+	// block is re-planned to it, instead of staying in bootstrap II forever
+	monitor->Update(headers[85]);
+	EXPECT_EQ(monitor->GetPlanedSyncBlkNum(), 85U);
+	EXPECT_EQ(monitor->GetPhase(), Phases::Sync);
+
+	// later headers don't change the plan
+	for (size_t i = 86; i < headers.size(); ++i)
+	{
+		monitor->Update(headers[i]);
+	}
+	EXPECT_EQ(monitor->GetPlanedSyncBlkNum(), 85U);
+}
+
+
+GTEST_TEST(TestEthEclipseMonitor, SnapshotIntegrity)
+{
+	const auto& headers = GetEthHistHdr_0_100();
+
+	TestMonitorRecord expRecord;
+	auto expMonitor = BuildTestMonitor(expRecord);
+	for (size_t i = 0; i < 85; ++i)
+	{
+		expMonitor->Update(headers[i]);
+	}
+	const auto snapshot = expMonitor->TakeSnapshot();
+	auto snapshotHash =
+		EclipseMonitor::Eth::EclipseMonitor::GetSnapshotHash(snapshot);
+
+	TestMonitorRecord record;
+
+	// corrupted snapshot
+	auto corrupted = snapshot;
+	corrupted[corrupted.size() / 2] ^= 0x01U;
+	EXPECT_ANY_THROW(
+		EclipseMonitor::Eth::EclipseMonitor::GetSnapshotHash(corrupted)
+	);
+	EXPECT_ANY_THROW(BuildTestMonitor(record, &corrupted, &snapshotHash));
+
+	// snapshot taken with a different configuration
+	EXPECT_THROW(
+		BuildTestMonitor(
+			record,
+			&snapshot,
+			&snapshotHash,
+			0,
+			sk_testCheckpointSize + 1
+		),
+		EclipseMonitor::Exception
+	);
+
+	// the snapshot is checked against the trusted hash
+	EXPECT_NO_THROW(BuildTestMonitor(record, &snapshot, &snapshotHash));
+	auto wrongHash = snapshotHash;
+	wrongHash[0] ^= 0x01U;
+	EXPECT_THROW(
+		BuildTestMonitor(record, &snapshot, &wrongHash),
+		EclipseMonitor::Exception
+	);
+
+	// a tampered snapshot with its embedded hash recomputed passes the
+	// integrity check, but not the trusted hash
+	const auto snapshotObj = SimpleRlp::ParseRlp(snapshot);
+	const auto& payloadBytes = snapshotObj.AsList()[0].AsBytes();
+	SimpleObjects::Bytes tamperedPayload(
+		payloadBytes.data(),
+		payloadBytes.data() + payloadBytes.size()
+	);
+	tamperedPayload[tamperedPayload.size() - 1] ^= 0x01U;
+	const auto tamperedHash = Keccak256(tamperedPayload);
+	SimpleObjects::List tamperedObj;
+	tamperedObj.push_back(tamperedPayload);
+	tamperedObj.push_back(
+		SimpleObjects::Bytes(tamperedHash.begin(), tamperedHash.end())
+	);
+	const auto tampered = SimpleRlp::WriteRlp(tamperedObj);
+	EXPECT_EQ(
+		EclipseMonitor::Eth::EclipseMonitor::GetSnapshotHash(tampered),
+		tamperedHash
+	);
+	EXPECT_THROW(
+		BuildTestMonitor(record, &tampered, &snapshotHash),
+		EclipseMonitor::Exception
+	);
+}
+
+
+GTEST_TEST(TestEthEclipseMonitor, BootstrapFromCheckpoint)
+{
+	const auto& headers = GetEthHistHdr_0_100();
+
+	// the trusted state after the second checkpoint window (blocks 10 - 19)
+	TestMonitorRecord trustedRecord;
+	auto trustedMonitor = BuildTestMonitor(trustedRecord);
+	for (size_t i = 0; i < 2 * sk_testCheckpointSize; ++i)
+	{
+		trustedMonitor->Update(headers[i]);
+	}
+	const EclipseMonitorBase& trustedMonitorBase = *trustedMonitor;
+	const MonitorSecState trustedSecState =
+		trustedMonitorBase.GetMonitorSecState();
+	ASSERT_EQ(trustedSecState.get_checkpointIter().GetVal(), 2U);
+
+	std::vector<std::vector<uint8_t> > window(
+		headers.begin() + sk_testCheckpointSize,
+		headers.begin() + (2 * sk_testCheckpointSize)
+	);
+
+	{
+		TestMonitorRecord record;
+		auto monitor = BuildTestMonitor(record);
+		const EclipseMonitorBase& monitorBase = *monitor;
+		EXPECT_NO_THROW(monitor->BootstrapFromCheckpoint(window, trustedSecState));
+
+		EXPECT_EQ(monitor->GetPhase(), Phases::BootstrapII);
+		EXPECT_EQ(monitorBase.GetMonitorSecState(), trustedSecState);
+		EXPECT_EQ(monitor->GetStartBlockNum(), sk_testCheckpointSize);
+		EXPECT_EQ(
+			monitor->GetBootstrapIEndBlkNum(),
+			(2 * sk_testCheckpointSize) - 1
+		);
+
+		// the following headers are accepted as usual
+		for (size_t i = 2 * sk_testCheckpointSize; i < headers.size(); ++i)
+		{
+			monitor->Update(headers[i]);
+		}
+		EXPECT_GT(
+			monitorBase.GetMonitorSecState().get_checkpointIter().GetVal(),
+			2U
+		);
+		ASSERT_GT(record.m_confirmed.size(), sk_testCheckpointSize);
+		EXPECT_EQ(
+			record.m_confirmed[sk_testCheckpointSize],
+			2 * sk_testCheckpointSize
+		);
+	}
+
+	// wrong number of headers
+	{
+		TestMonitorRecord record;
+		auto monitor = BuildTestMonitor(record);
+		auto shortWindow = window;
+		shortWindow.pop_back();
+		EXPECT_THROW(
+			monitor->BootstrapFromCheckpoint(shortWindow, trustedSecState),
+			EclipseMonitor::Exception
+		);
+	}
+
+	// broken hash chain
+	{
+		TestMonitorRecord record;
+		auto monitor = BuildTestMonitor(record);
+		auto brokenWindow = window;
+		brokenWindow[3] = headers[50];
+		EXPECT_THROW(
+			monitor->BootstrapFromCheckpoint(brokenWindow, trustedSecState),
+			EclipseMonitor::Exception
+		);
+	}
+
+	// window doesn't match the trusted checkpoint
+	{
+		TestMonitorRecord record;
+		auto monitor = BuildTestMonitor(record);
+		std::vector<std::vector<uint8_t> > otherWindow(
+			headers.begin(),
+			headers.begin() + sk_testCheckpointSize
+		);
+		EXPECT_THROW(
+			monitor->BootstrapFromCheckpoint(otherWindow, trustedSecState),
+			EclipseMonitor::Exception
+		);
+		EXPECT_EQ(monitor->GetPhase(), Phases::BootstrapI);
+	}
+
+	// headers have been added already
+	{
+		TestMonitorRecord record;
+		auto monitor = BuildTestMonitor(record);
+		monitor->Update(headers[0]);
+		EXPECT_THROW(
+			monitor->BootstrapFromCheckpoint(window, trustedSecState),
+			EclipseMonitor::Exception
+		);
+	}
+}
+
+
+GTEST_TEST(TestEthEclipseMonitor, PublishedStatus)
+{
+	const auto& headers = GetEthHistHdr_0_100();
+
+	TestMonitorRecord record;
+	auto monitor = BuildTestMonitor(record);
+
+	// initial status
+	auto status = monitor->GetStatus();
+	ASSERT_NE(status, nullptr);
+	EXPECT_EQ(status->GetPhase(), Phases::BootstrapI);
+	EXPECT_EQ(status->GetCheckpointIter(), 0U);
+	EXPECT_FALSE(status->HasTip());
+	EXPECT_EQ(status->GetNumOfActiveNodes(), 0U);
+
+	// the status is published after each update
+	HeaderMgr::HashType expTipHash = {{ 0 }};
+	for (size_t i = 0; i < 5; ++i)
+	{
+		monitor->Update(headers[i]);
+		HeaderMgr header(headers[i], 0);
+		expTipHash = header.GetHash();
+
+		status = monitor->GetStatus();
+		EXPECT_EQ(status->GetPhase(), Phases::BootstrapI);
+		EXPECT_TRUE(status->HasTip());
+		EXPECT_EQ(status->GetTipNum(), i);
+		EXPECT_EQ(status->GetTipHash(), expTipHash);
+	}
+
+	// the status held by the reader is not affected by later updates
+	auto oldStatus = status;
+	for (size_t i = 5; i < headers.size(); ++i)
+	{
+		monitor->Update(headers[i]);
+	}
+	EXPECT_EQ(oldStatus->GetTipNum(), 4U);
+	EXPECT_EQ(oldStatus->GetCheckpointIter(), 0U);
+
+	HeaderMgr lastHeader(headers.back(), 0);
+	const EclipseMonitorBase& monitorBase = *monitor;
+	const auto& secState = monitorBase.GetMonitorSecState();
+
+	status = monitor->GetStatus();
+	EXPECT_EQ(status->GetPhase(), monitor->GetPhase());
+	EXPECT_EQ(
+		status->GetCheckpointIter(),
+		secState.get_checkpointIter().GetVal()
+	);
+	EXPECT_GT(status->GetCheckpointIter(), 0U);
+	EXPECT_EQ(
+		status->GetCheckpointNum(),
+		BlkNumTypeTrait::FromBytes(secState.get_checkpointNum())
+	);
+	EXPECT_EQ(
+		std::vector<uint8_t>(
+			status->GetCheckpointHash().begin(),
+			status->GetCheckpointHash().end()
+		),
+		std::vector<uint8_t>(
+			secState.get_checkpointHash().begin(),
+			secState.get_checkpointHash().end()
+		)
+	);
+	EXPECT_TRUE(status->HasTip());
+	EXPECT_EQ(status->GetTipNum(), lastHeader.GetNumber());
+	EXPECT_EQ(status->GetTipHash(), lastHeader.GetHash());
+	EXPECT_EQ(
+		status->IsSynced(),
+		monitor->GetSyncMsgMgr().GetLastSyncState()->IsSynced()
+	);
+
+	// a header that changes nothing (i.e., its parent is already gone)
+	// doesn't publish a new status
+	monitor->Update(headers[5]);
+	EXPECT_EQ(monitor->GetStatus(), status);
+}
+
+
+GTEST_TEST(TestEthEclipseMonitor, PublishedStatusConcurrentRead)
+{
+	const auto& headers = GetEthHistHdr_0_100();
+
+	TestMonitorRecord record;
+	auto monitor = BuildTestMonitor(record);
+
+	std::atomic_bool isDone(false);
+	bool isConsistent = true;
+	size_t numOfReads = 0;
+	std::thread reader(
+		[&monitor, &isDone, &isConsistent, &numOfReads]()
+		{
+			BlockNumber lastTipNum = 0;
+			uint64_t lastChkptIter = 0;
+			while (!isDone.load())
+			{
+				auto status = monitor->GetStatus();
+				// progress made by the monitor never goes backward
+				if (
+					(status->HasTip() && (status->GetTipNum() < lastTipNum)) ||
+					(status->GetCheckpointIter() < lastChkptIter)
+				)
+				{
+					isConsistent = false;
+				}
+				lastTipNum = status->GetTipNum();
+				lastChkptIter = status->GetCheckpointIter();
+				++numOfReads;
+			}
+		}
+	);
+
+	for (const auto& header : headers)
+	{
+		monitor->Update(header);
+	}
+	isDone.store(true);
+	reader.join();
+
+	EXPECT_TRUE(isConsistent);
+	EXPECT_GT(numOfReads, 0U);
+	EXPECT_EQ(monitor->GetStatus()->GetTipNum(), headers.size() - 1);
+}
+
+
+GTEST_TEST(TestEthEclipseMonitor, Metrics)
+{
+	const auto& headers = GetEthHistHdr_0_100();
+
+	BasicMetrics::Reset();
+
+	TestMonitorRecord record;
+	auto monitor = BuildTestMonitor(record);
+	for (const auto& header : headers)
+	{
+		monitor->Update(header);
+	}
+
+	const uint64_t numOfUpdates =
+		BasicMetrics::GetCount(MetricCounter::UpdateBootstrapI) +
+		BasicMetrics::GetCount(MetricCounter::UpdateBootstrapII) +
+		BasicMetrics::GetCount(MetricCounter::UpdateSync) +
+		BasicMetrics::GetCount(MetricCounter::UpdateRuntime);
+	EXPECT_EQ(numOfUpdates, headers.size());
+	EXPECT_EQ(
+		BasicMetrics::GetCount(MetricCounter::UpdateBootstrapI),
+		monitor->GetBootstrapIEndBlkNum() + 1
+	);
+	EXPECT_EQ(
+		BasicMetrics::GetLatencyCount(MetricLatency::UpdateBootstrapI),
+		BasicMetrics::GetCount(MetricCounter::UpdateBootstrapI)
+	);
+	EXPECT_EQ(
+		BasicMetrics::GetLatencyCount(MetricLatency::HeaderParse),
+		headers.size()
+	);
+	EXPECT_EQ(
+		BasicMetrics::GetLatencyCount(MetricLatency::HeaderHash),
+		headers.size()
+	);
+	// all headers except the genesis one are validated
+	EXPECT_EQ(
+		BasicMetrics::GetLatencyCount(MetricLatency::Validate),
+		headers.size() - 1
+	);
+	EXPECT_GT(BasicMetrics::GetLatencyCount(MetricLatency::DiffCheck), 0U);
+	EXPECT_EQ(
+		BasicMetrics::GetLatencyCount(MetricLatency::HeaderCallback),
+		record.m_validated.size() + record.m_confirmed.size()
+	);
+
+	const EclipseMonitorBase& monitorBase = *monitor;
+	EXPECT_EQ(
+		BasicMetrics::GetCount(MetricCounter::CheckpointComplete),
+		monitorBase.GetMonitorSecState().get_checkpointIter().GetVal()
+	);
+
+	auto status = monitor->GetStatus();
+	EXPECT_EQ(
+		BasicMetrics::GetGauge(MetricGauge::NumOfActiveNodes),
+		status->GetNumOfActiveNodes()
+	);
+	EXPECT_EQ(
+		BasicMetrics::GetGauge(MetricGauge::NumOfOfflineNodes),
+		status->GetNumOfOfflineNodes()
+	);
+	EXPECT_GT(BasicMetrics::GetGauge(MetricGauge::NumOfForkTreeNodes), 0U);
+}
+
+
+GTEST_TEST(TestEthEclipseMonitor, BatchConfirmedCallback)
+{
+	const auto& headers = GetEthHistHdr_0_100();
+
+	std::vector<BlockNumber> batchConfirmed;
+	size_t numOfBatches = 0;
+	auto onBatch = [&batchConfirmed, &numOfBatches](
+		const std::pair<BlockNumber, BlockNumber>& blkNumRange,
+		const HeaderSummary* summaries,
+		size_t numOfSummaries
+	)
+	{
+		ASSERT_GT(numOfSummaries, 0U);
+		EXPECT_EQ(blkNumRange.first, summaries[0].GetNumber());
+		EXPECT_EQ(
+			blkNumRange.second,
+			summaries[numOfSummaries - 1].GetNumber()
+		);
+		for (size_t i = 0; i < numOfSummaries; ++i)
+		{
+			batchConfirmed.push_back(summaries[i].GetNumber());
+		}
+		++numOfBatches;
+	};
+
+	// with both the per-header and the batch callbacks
+	TestMonitorRecord record;
+	auto monitor = BuildTestMonitor(record);
+	monitor->SetOnHeadersConfirmed(onBatch);
+	for (const auto& header : headers)
+	{
+		monitor->Update(header);
+	}
+	EXPECT_GT(record.m_confirmed.size(), 0U);
+	EXPECT_EQ(batchConfirmed, record.m_confirmed);
+	const EclipseMonitorBase& monitorBase = *monitor;
+	EXPECT_EQ(
+		numOfBatches,
+		monitorBase.GetMonitorSecState().get_checkpointIter().GetVal()
+	);
+
+	// with the batch callback only
+	batchConfirmed.clear();
+	MonitorConfig mConf = BuildEthereumMonitorConfig();
+	mConf.get_checkpointSize() = sk_testCheckpointSize;
+	EclipseMonitor::Eth::EclipseMonitor batchOnlyMonitor(
+		mConf,
+		SimpleObjects::Internal::make_unique<TestTimestamper>(),
+		SimpleObjects::Internal::make_unique<TestRandomGenerator>(),
+		[](const HeaderMgr&){},
+		nullptr,
+		SimpleObjects::Internal::make_unique<Validator<MainnetConfig> >(
+			SimpleObjects::Internal::make_unique<MainnetDAA>()
+		),
+		SimpleObjects::Internal::make_unique<DiffCheckerMainNet>(
+			mConf,
+			SimpleObjects::Internal::make_unique<MainnetDAAEstimator>()
+		),
+		ContractAddr(),
+		EventTopic()
+	);
+	BlockNumber startBlkNum = 0;
+	batchOnlyMonitor.RefreshBootstrapPlan(headers.size() - 1, &startBlkNum);
+	batchOnlyMonitor.SetOnHeadersConfirmed(onBatch);
+	for (const auto& header : headers)
+	{
+		batchOnlyMonitor.Update(header);
+	}
+	EXPECT_EQ(batchConfirmed, record.m_confirmed);
+}
+
+
+GTEST_TEST(TestEthEclipseMonitor, StaticDispatchMonitor)
+{
+	using StaticMonitor = BasicEclipseMonitor<
+		Validator<MainnetConfig, MainnetDAA>,
+		GenericDiffCheckerImpl<MainnetConfig, MainnetDAAEstimator>
+	>;
+
+	const auto& headers = GetEthHistHdr_0_100();
+
+	// Expected results
+	TestMonitorRecord expRecord;
+	auto expMonitor = BuildTestMonitor(expRecord);
+	for (const auto& header : headers)
+	{
+		expMonitor->Update(header);
+	}
+
+	MonitorConfig mConf = BuildEthereumMonitorConfig();
+	mConf.get_checkpointSize() = sk_testCheckpointSize;
+
+	TestMonitorRecord record;
+	StaticMonitor monitor(
+		mConf,
+		SimpleObjects::Internal::make_unique<TestTimestamper>(),
+		SimpleObjects::Internal::make_unique<TestRandomGenerator>(),
+		[&record](const HeaderMgr& header)
+		{
+			record.m_validated.push_back(header.GetNumber());
+		},
+		[&record](const HeaderMgr& header)
+		{
+			record.m_confirmed.push_back(header.GetNumber());
+		},
+		Validator<MainnetConfig, MainnetDAA>(MainnetDAA()),
+		GenericDiffCheckerImpl<MainnetConfig, MainnetDAAEstimator>(
+			mConf,
+			MainnetDAAEstimator()
+		),
+		ContractAddr(),
+		EventTopic()
+	);
+	BlockNumber startBlkNum = 0;
+	monitor.RefreshBootstrapPlan(headers.size() - 1, &startBlkNum);
+	EXPECT_NO_THROW(monitor.UpdateBatch(headers.begin(), headers.end()));
+
+	ExpectSameResult(monitor, record, *expMonitor, expRecord);
+
+	// both monitors generate the same snapshot
+	EXPECT_EQ(monitor.TakeSnapshot(), expMonitor->TakeSnapshot());
+}
@@ -6,10 +6,13 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 #include <EclipseMonitor/Eth/AbiParser.hpp>
 #include <EclipseMonitor/Eth/EventManager.hpp>
 
 #include "BlockData.hpp"
+#include "EthTransaction.hpp"
 
 
 namespace EclipseMonitor_Test
@@ -274,3 +277,234 @@ GTEST_TEST(TestEthEventManager, TestDecentSyncMsgV2)
 
 	EXPECT_TRUE(isEventFound);
 }
+
+
+GTEST_TEST(TestEthEventManager, TxnCallSubscriptions)
+{
+	const auto headerB15415840 =
+		BlockData::ReadBinary(
+			BlockData::GetRlpFilePath("mainnet_b_15415840.header")
+		);
+	const auto txnB15415840 =
+		BlockData::ReadRlp("mainnet_b_15415840.txns");
+	const auto& txnList = txnB15415840.AsList();
+
+	const HeaderMgr headerMgr(headerB15415840, 0);
+
+	// 0x9f8f72aa9304c8b593d555f12ef6589cc3a579a2
+	const ContractAddr contractAddr = {
+		0X9FU, 0X8FU, 0X72U, 0XAAU, 0X93U, 0X04U, 0XC8U, 0XB5U,
+		0X93U, 0XD5U, 0X55U, 0XF1U, 0X2EU, 0XF6U, 0X58U, 0X9CU,
+		0XC3U, 0XA5U, 0X79U, 0XA2U,
+	};
+	const FuncSelector transferSelector =
+		TxnCallDescription::GetSelector("transfer(address,uint256)");
+	const FuncSelector expTransferSelector = { 0XA9U, 0X05U, 0X9CU, 0XBBU };
+	ASSERT_EQ(transferSelector, expTransferSelector);
+
+	// expected numbers of matches, by checking all parsed transactions
+	size_t expNumOfCalls = 0;
+	size_t expNumOfTransfers = 0;
+	TransactionsMgr eagerMgr(txnList);
+	for (size_t i = 0; i < eagerMgr.GetNumOfTransactions(); ++i)
+	{
+		const auto& txn = eagerMgr.GetTransaction(i);
+		const auto& to = txn.GetContractAddr();
+		const auto& data = txn.GetContactParams();
+		if ((to.size() == contractAddr.size()) &&
+			std::equal(contractAddr.begin(), contractAddr.end(), to.data()))
+		{
+			++expNumOfCalls;
+			if ((data.size() >= transferSelector.size()) &&
+				std::equal(
+					transferSelector.begin(),
+					transferSelector.end(),
+					data.data()
+				))
+			{
+				++expNumOfTransfers;
+			}
+		}
+	}
+	ASSERT_GT(expNumOfTransfers, 0U);
+
+	EventManager eventMgr;
+	size_t numOfGetterCalls = 0;
+	auto txnsGetter =
+		[&](BlockNumber) -> const SimpleObjects::ListBaseObj&
+		{
+			++numOfGetterCalls;
+			return txnList;
+		};
+
+	// transactions are not fetched without any subscription
+	eventMgr.CheckTxnCalls(headerMgr, txnsGetter);
+	EXPECT_EQ(numOfGetterCalls, 0U);
+
+	size_t numOfCalls = 0;
+	size_t numOfTransfers = 0;
+	size_t numOfOthers = 0;
+	EventCallbackId callsId = eventMgr.ListenTxnCalls(
+		TxnCallDescription(
+			contractAddr,
+			[&](
+				const HeaderMgr&,
+				const TransactionView& txn,
+				EventCallbackId id
+			) -> void
+			{
+				EXPECT_EQ(id, callsId);
+				EXPECT_TRUE(txn.IsContractAddr(contractAddr));
+				++numOfCalls;
+			}
+		)
+	);
+	EventCallbackId transfersId = eventMgr.ListenTxnCalls(
+		TxnCallDescription(
+			contractAddr,
+			transferSelector,
+			[&](
+				const HeaderMgr&,
+				const TransactionView& txn,
+				EventCallbackId id
+			) -> void
+			{
+				EXPECT_EQ(id, transfersId);
+				auto data = txn.GetContactParams();
+				ASSERT_GE(data.GetPayloadSize(), transferSelector.size());
+				EXPECT_TRUE(
+					std::equal(
+						transferSelector.begin(),
+						transferSelector.end(),
+						data.GetPayload()
+					)
+				);
+				++numOfTransfers;
+			}
+		)
+	);
+	eventMgr.ListenTxnCalls(
+		TxnCallDescription(
+			contractAddr,
+			TxnCallDescription::GetSelector("approve(address,uint256)"),
+			[&](const HeaderMgr&, const TransactionView&, EventCallbackId)
+			{
+				++numOfOthers;
+			}
+		)
+	);
+	EXPECT_EQ(eventMgr.GetNumOfTxnListeners(), 3U);
+	EXPECT_EQ(eventMgr.GetNumOfListeners(), 0U);
+
+	eventMgr.CheckTxnCalls(headerMgr, txnsGetter);
+	EXPECT_EQ(numOfGetterCalls, 1U);
+	EXPECT_EQ(numOfCalls, expNumOfCalls);
+	EXPECT_EQ(numOfTransfers, expNumOfTransfers);
+	EXPECT_EQ(numOfOthers, 0U);
+
+	// cancelled subscriptions are not notified
+	eventMgr.Cancel(callsId);
+	eventMgr.Cancel(transfersId);
+	EXPECT_EQ(eventMgr.GetNumOfTxnListeners(), 1U);
+	eventMgr.CheckTxnCalls(headerMgr, txnsGetter);
+	EXPECT_EQ(numOfGetterCalls, 2U);
+	EXPECT_EQ(numOfCalls, expNumOfCalls);
+	EXPECT_EQ(numOfTransfers, expNumOfTransfers);
+
+	// transactions not matching the root are rejected
+	const auto headerB15209997 =
+		BlockData::ReadBinary(
+			BlockData::GetRlpFilePath("mainnet_b_15209997.header")
+		);
+	const HeaderMgr otherHeaderMgr(headerB15209997, 0);
+	EXPECT_THROW(
+		eventMgr.CheckTxnCalls(otherHeaderMgr, txnsGetter),
+		EclipseMonitor::Exception
+	);
+}
+
+
+GTEST_TEST(TestEthEventManager, TxnCallsWithTypedTxns)
+{
+	// a post-Dencun block is made from block 15415840, by appending a blob
+	// transaction, a set code transaction, and a transaction of a type
+	// unknown to us
+	const auto txnB15415840 =
+		BlockData::ReadRlp("mainnet_b_15415840.txns");
+	SimpleObjects::List txnList;
+	for (const auto& txn : txnB15415840.AsList())
+	{
+		txnList.push_back(txn.AsBytes());
+	}
+	txnList.push_back(BlobTxn());
+	txnList.push_back(SetCodeTxn());
+	SimpleObjects::Bytes unknownTxn = SetCodeTxn();
+	unknownTxn[0] = 0x05U;
+	txnList.push_back(unknownTxn);
+
+	auto rawHeader = BlockData::ReadHeader("mainnet_b_15415840.header");
+	rawHeader.get_TransactionsRoot() =
+		TransactionsMgr(txnList, true).GetRootHashBytes();
+	const HeaderMgr headerMgr(SimpleRlp::WriteRlp(rawHeader), 0);
+
+	// 0x9f8f72aa9304c8b593d555f12ef6589cc3a579a2
+	const ContractAddr contractAddr = {
+		0X9FU, 0X8FU, 0X72U, 0XAAU, 0X93U, 0X04U, 0XC8U, 0XB5U,
+		0X93U, 0XD5U, 0X55U, 0XF1U, 0X2EU, 0XF6U, 0X58U, 0X9CU,
+		0XC3U, 0XA5U, 0X79U, 0XA2U,
+	};
+	const FuncSelector transferSelector =
+		TxnCallDescription::GetSelector("transfer(address,uint256)");
+
+	// expected number of transfers in the original block
+	size_t expNumOfTransfers = 0;
+	TransactionsMgr origMgr(txnB15415840.AsList(), true);
+	for (size_t i = 0; i < origMgr.GetNumOfTransactions(); ++i)
+	{
+		auto txn = origMgr.GetTransactionView(i);
+		auto data = txn.GetContactParams();
+		if (txn.IsContractAddr(contractAddr) &&
+			(data.GetPayloadSize() >= transferSelector.size()) &&
+			std::equal(
+				transferSelector.begin(),
+				transferSelector.end(),
+				data.GetPayload()
+			))
+		{
+			++expNumOfTransfers;
+		}
+	}
+
+	std::vector<TxnVersion> versions;
+	EventManager eventMgr;
+	eventMgr.ListenTxnCalls(
+		TxnCallDescription(
+			contractAddr,
+			transferSelector,
+			[&](const HeaderMgr&, const TransactionView& txn, EventCallbackId)
+			{
+				versions.push_back(txn.GetVersion());
+			}
+		)
+	);
+	auto txnsGetter =
+		[&](BlockNumber) -> const SimpleObjects::ListBaseObj&
+		{
+			return txnList;
+		};
+
+	EXPECT_NO_THROW(eventMgr.CheckTxnCalls(headerMgr, txnsGetter));
+	ASSERT_EQ(versions.size(), expNumOfTransfers + 2);
+	EXPECT_EQ(versions[versions.size() - 2], TxnVersion::Blob);
+	EXPECT_EQ(versions[versions.size() - 1], TxnVersion::SetCode);
+
+	// the transaction of the unknown type is skipped by the search as well
+	TransactionsMgr txnsMgr(txnList, true);
+	EXPECT_FALSE(
+		txnsMgr.IsTransactionSupported(txnsMgr.GetNumOfTransactions() - 1)
+	);
+	EXPECT_EQ(
+		txnsMgr.SearchTransactions(contractAddr).size(),
+		origMgr.SearchTransactions(contractAddr).size() + 2
+	);
+}
@@ -0,0 +1,282 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+
+#include <string>
+
+#ifndef _WIN32
+#include <EclipseMonitor/Eth/CheckpointMgr.hpp>
+#include <EclipseMonitor/Eth/HeaderArchive.hpp>
+#endif // !_WIN32
+
+#include "EthHistHdr_0_100.hpp"
+
+
+namespace EclipseMonitor_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+using namespace EclipseMonitor_Test;
+
+
+GTEST_TEST(TestEthHeaderArchive, CountTestFile)
+{
+	static auto tmp = ++g_numOfTestFile;
+	(void)tmp;
+}
+
+
+#ifndef _WIN32
+
+using namespace EclipseMonitor;
+using namespace EclipseMonitor::Eth;
+
+
+namespace
+{
+
+class TestArchivePath
+{
+public:
+
+	explicit TestArchivePath(const std::string& name) :
+		m_path(::testing::TempDir() + "EclipseMonitorTest_" + name)
+	{
+		Remove();
+	}
+
+	~TestArchivePath()
+	{
+		Remove();
+	}
+
+	const std::string& Get() const
+	{
+		return m_path;
+	}
+
+private:
+
+	void Remove()
+	{
+		std::remove((m_path + ".rec").c_str());
+		std::remove((m_path + ".idx").c_str());
+		std::remove((m_path + ".idx.tmp").c_str());
+	}
+
+	std::string m_path;
+}; // class TestArchivePath
+
+
+HeaderSummary BuildSummary(BlockNumber number)
+{
+	HeaderSummary::HashType hash = HeaderSummary::HashType();
+	HeaderSummary::HashType parentHash = HeaderSummary::HashType();
+	// spread the numbers over the hash table
+	const uint64_t mixed = number * 0x9E3779B97F4A7C15ULL;
+	for (size_t i = 0; i < sizeof(number); ++i)
+	{
+		hash[i] = static_cast<uint8_t>(mixed >> (i * 8));
+		parentHash[i] = static_cast<uint8_t>(number >> (i * 8));
+	}
+	return HeaderSummary(
+		number,
+		number * 10,
+		number * 100,
+		0,
+		hash,
+		parentHash
+	);
+}
+
+} // namespace
+
+
+GTEST_TEST(TestEthHeaderArchive, FeedFromCheckpoint)
+{
+	static constexpr size_t testingChkptSize = 10;
+
+	TestArchivePath path("FeedFromCheckpoint");
+	HeaderArchive archive(path.Get());
+	EXPECT_TRUE(archive.IsEmpty());
+	EXPECT_THROW(archive.GetFirstNumber(), Exception);
+
+	// confirmed headers are given by the checkpoint manager, in the same
+	// way as the monitor calls the header confirmed callback
+	EclipseMonitor::MonitorConfig mConf;
+	mConf.get_checkpointSize() = testingChkptSize;
+	std::unique_ptr<CheckpointMgr> chkptMgr;
+	chkptMgr = SimpleObjects::Internal::make_unique<CheckpointMgr>(
+		mConf,
+		[&chkptMgr, &archive](){
+			chkptMgr->IterateCurrWindow(
+				[&archive](const HeaderMgr& header)
+				{
+					archive.Append(header);
+				}
+			);
+		});
+	for (const auto& rawHeader : GetEthHistHdr_0_100())
+	{
+		chkptMgr->AddHeader(
+			SimpleObjects::Internal::make_unique<HeaderMgr>(rawHeader, 0)
+		);
+	}
+
+	ASSERT_EQ(archive.GetNumOfRecords(), GetEthHistHdr_0_100().size());
+	EXPECT_EQ(archive.GetFirstNumber(), 0);
+	EXPECT_EQ(archive.GetLastNumber(), GetEthHistHdr_0_100().size() - 1);
+
+	for (const auto& rawHeader : GetEthHistHdr_0_100())
+	{
+		HeaderMgr header(rawHeader, 0);
+		HeaderSummary byNum;
+		HeaderSummary byHash;
+		ASSERT_TRUE(archive.FindByNumber(header.GetNumber(), byNum));
+		ASSERT_TRUE(archive.FindByHash(header.GetHash(), byHash));
+		EXPECT_EQ(byNum.GetNumber(), header.GetNumber());
+		EXPECT_EQ(byNum.GetHash(), header.GetHash());
+		EXPECT_EQ(byNum.GetTime(), header.GetTime());
+		EXPECT_EQ(byNum.GetDiff(), header.GetDiff());
+		EXPECT_EQ(byHash.GetNumber(), header.GetNumber());
+		EXPECT_EQ(
+			byHash.GetParentHash(),
+			HeaderSummary::FromHeader(header).GetParentHash()
+		);
+		EXPECT_TRUE(archive.IsConfirmed(header.GetNumber(), header.GetHash()));
+	}
+
+	HeaderSummary summary;
+	EXPECT_FALSE(archive.FindByNumber(GetEthHistHdr_0_100().size(), summary));
+	EXPECT_FALSE(archive.FindByHash(BuildSummary(1).GetHash(), summary));
+	EXPECT_FALSE(archive.IsConfirmed(1, BuildSummary(1).GetHash()));
+
+	// appending a confirmed header again is ignored
+	HeaderMgr header5(GetEthHistHdr_0_100()[5], 0);
+	EXPECT_NO_THROW(archive.Append(header5));
+	EXPECT_EQ(archive.GetNumOfRecords(), GetEthHistHdr_0_100().size());
+	// but a different header with the same number is rejected
+	EXPECT_THROW(archive.Append(BuildSummary(5)), Exception);
+	// and so is a gap
+	EXPECT_THROW(
+		archive.Append(BuildSummary(GetEthHistHdr_0_100().size() + 1)),
+		Exception
+	);
+}
+
+
+GTEST_TEST(TestEthHeaderArchive, GrowAndReopen)
+{
+	// more than the initial capacity of both files
+	static constexpr size_t sk_numOfRecords = 3000;
+	static constexpr BlockNumber sk_firstNum = 12345;
+
+	TestArchivePath path("GrowAndReopen");
+	{
+		HeaderArchive archive(path.Get());
+		HeaderArchive reader(path.Get(), true);
+		EXPECT_THROW(reader.Append(BuildSummary(sk_firstNum)), Exception);
+
+		for (size_t i = 0; i < sk_numOfRecords; ++i)
+		{
+			archive.Append(BuildSummary(sk_firstNum + i));
+		}
+		archive.Flush();
+
+		// the reader sees the new records after refreshing
+		EXPECT_LE(reader.GetNumOfRecords(), sk_numOfRecords);
+		reader.Refresh();
+		EXPECT_EQ(reader.GetNumOfRecords(), sk_numOfRecords);
+		HeaderSummary summary;
+		ASSERT_TRUE(reader.FindByHash(
+			BuildSummary(sk_firstNum + sk_numOfRecords - 1).GetHash(),
+			summary
+		));
+		EXPECT_EQ(summary.GetNumber(), sk_firstNum + sk_numOfRecords - 1);
+	}
+
+	HeaderArchive archive(path.Get());
+	ASSERT_EQ(archive.GetNumOfRecords(), sk_numOfRecords);
+	EXPECT_EQ(archive.GetFirstNumber(), sk_firstNum);
+	for (size_t i = 0; i < sk_numOfRecords; ++i)
+	{
+		HeaderSummary exp = BuildSummary(sk_firstNum + i);
+		HeaderSummary summary;
+		ASSERT_TRUE(archive.FindByHash(exp.GetHash(), summary));
+		EXPECT_EQ(summary.GetNumber(), exp.GetNumber());
+		ASSERT_TRUE(archive.FindByNumber(exp.GetNumber(), summary));
+		EXPECT_EQ(summary.GetHash(), exp.GetHash());
+		EXPECT_EQ(summary.GetParentHash(), exp.GetParentHash());
+		EXPECT_EQ(summary.GetTime(), exp.GetTime());
+		EXPECT_EQ(summary.GetDiff(), exp.GetDiff());
+	}
+
+	archive.Append(BuildSummary(sk_firstNum + sk_numOfRecords));
+	EXPECT_EQ(archive.GetNumOfRecords(), sk_numOfRecords + 1);
+}
+
+GTEST_TEST(TestEthHeaderArchive, ReadWhileRebuilding)
+{
+	// the index is rebuilt when the load factor of the initial capacity
+	// (1024) goes beyond 3/4
+	static constexpr size_t sk_numBeforeRebuild = 700;
+	static constexpr size_t sk_numAfterRebuild = 800;
+	static constexpr BlockNumber sk_firstNum = 100;
+
+	TestArchivePath path("ReadWhileRebuilding");
+	HeaderArchive archive(path.Get());
+	for (size_t i = 0; i < sk_numBeforeRebuild; ++i)
+	{
+		archive.Append(BuildSummary(sk_firstNum + i));
+	}
+
+	HeaderArchive reader(path.Get(), true);
+	HeaderSummary summary;
+
+	// leftovers of an interrupted rebuild don't matter
+	const std::string tmpPath = path.Get() + ".idx.tmp";
+	std::FILE* tmpFile = std::fopen(tmpPath.c_str(), "wb");
+	ASSERT_NE(tmpFile, nullptr);
+	std::fputs("garbage", tmpFile);
+	std::fclose(tmpFile);
+
+	for (size_t i = sk_numBeforeRebuild; i < sk_numAfterRebuild; ++i)
+	{
+		archive.Append(BuildSummary(sk_firstNum + i));
+	}
+
+	// the reader keeps the old index, which is still complete for the
+	// records it has seen
+	for (size_t i = 0; i < sk_numBeforeRebuild; ++i)
+	{
+		const auto hash = BuildSummary(sk_firstNum + i).GetHash();
+		ASSERT_TRUE(reader.FindByHash(hash, summary));
+		EXPECT_EQ(summary.GetNumber(), sk_firstNum + i);
+	}
+
+	// and it switches to the new index after refreshing
+	reader.Refresh();
+	EXPECT_EQ(reader.GetNumOfRecords(), sk_numAfterRebuild);
+	for (size_t i = 0; i < sk_numAfterRebuild; ++i)
+	{
+		const auto hash = BuildSummary(sk_firstNum + i).GetHash();
+		ASSERT_TRUE(reader.FindByHash(hash, summary));
+		EXPECT_EQ(summary.GetNumber(), sk_firstNum + i);
+	}
+
+	// a restarted writer finds all records as well
+	HeaderArchive reopened(path.Get());
+	for (size_t i = 0; i < sk_numAfterRebuild; ++i)
+	{
+		const auto hash = BuildSummary(sk_firstNum + i).GetHash();
+		ASSERT_TRUE(reopened.FindByHash(hash, summary));
+	}
+}
+
+#endif // !_WIN32
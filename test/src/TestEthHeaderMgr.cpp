@@ -75,3 +75,37 @@ GTEST_TEST(TestEthHeaderMgr, Header_0)
 		header.GetDiff(),
 		Difficulty(17179869184ULL));
 }
+
+GTEST_TEST(TestEthHeaderMgr, FromBufferRange)
+{
+	uint64_t trustedTime = 1234567890;
+
+	// put multiple headers in one large buffer
+	std::vector<uint8_t> buffer;
+	std::vector<std::pair<size_t, size_t> > ranges;
+	for (size_t i = 0; i < 5; ++i)
+	{
+		const auto& input = GetEthHistHdr_0_100()[i];
+		ranges.push_back(std::make_pair(buffer.size(), input.size()));
+		buffer.insert(buffer.end(), input.begin(), input.end());
+	}
+
+	for (size_t i = 0; i < ranges.size(); ++i)
+	{
+		HeaderMgr expHeader(GetEthHistHdr_0_100()[i], trustedTime);
+		HeaderMgr header(
+			buffer.data() + ranges[i].first,
+			ranges[i].second,
+			trustedTime
+		);
+
+		EXPECT_EQ(header.GetRawHeader(), expHeader.GetRawHeader());
+		EXPECT_EQ(header.GetTrustedTime(), expHeader.GetTrustedTime());
+		EXPECT_EQ(header.GetHash(), expHeader.GetHash());
+		EXPECT_EQ(header.GetHashObj(), expHeader.GetHashObj());
+		EXPECT_EQ(header.GetNumber(), expHeader.GetNumber());
+		EXPECT_EQ(header.GetTime(), expHeader.GetTime());
+		EXPECT_EQ(header.GetDiff(), expHeader.GetDiff());
+		EXPECT_EQ(header.HasUncle(), expHeader.HasUncle());
+	}
+}
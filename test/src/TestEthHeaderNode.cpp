@@ -92,3 +92,219 @@ GTEST_TEST(TestEthHeaderNode, AddChildAndFindDesc)
 		root = std::move(child);
 	}
 }
+
+GTEST_TEST(TestEthHeaderNode, MultipleChildren)
+{
+	// testing sync state
+	std::shared_ptr<SyncState> devSyncState =
+		std::make_shared<SyncState>(SyncState::GetDevSyncState());
+
+	std::unique_ptr<HeaderNode> root =
+		SimpleObjects::Internal::make_unique<HeaderNode>(
+			SimpleObjects::Internal::make_unique<HeaderMgr>(
+				GetEthHistHdr_0_100()[0], 0
+			),
+			devSyncState
+		);
+
+	// Add more children than the inline storage can hold
+	std::vector<HeaderNode*> children;
+	for (size_t i = 1; i <= 4; ++i)
+	{
+		auto header = SimpleObjects::Internal::make_unique<HeaderMgr>(
+			GetEthHistHdr_0_100()[i], 0);
+		children.push_back(root->AddChild(std::move(header), devSyncState));
+		EXPECT_EQ(root->GetNumOfChildren(), i);
+		EXPECT_EQ(children.back()->GetParent(), root.get());
+	}
+
+	// child #i has i descendants
+	for (size_t i = 0; i < children.size(); ++i)
+	{
+		HeaderNode* currPtr = children[i];
+		for (size_t j = 0; j < i; ++j)
+		{
+			auto header = SimpleObjects::Internal::make_unique<HeaderMgr>(
+				GetEthHistHdr_0_100()[10 + j], 0);
+			currPtr = currPtr->AddChild(std::move(header), devSyncState);
+		}
+	}
+
+	EXPECT_EQ(root->ReleaseChildHasNDesc(4), nullptr);
+
+	// the child having the most descendants is released
+	auto child = root->ReleaseChildHasNDesc(2);
+	ASSERT_NE(child, nullptr);
+	EXPECT_EQ(child.get(), children[3]);
+	EXPECT_EQ(child->GetParent(), nullptr);
+	EXPECT_EQ(root->GetNumOfChildren(), 3);
+
+	// descendants are still counted correctly after the release
+	HeaderNode* currPtr = children[0];
+	for (size_t j = 0; j < 3; ++j)
+	{
+		auto header = SimpleObjects::Internal::make_unique<HeaderMgr>(
+			GetEthHistHdr_0_100()[20 + j], 0);
+		currPtr = currPtr->AddChild(std::move(header), devSyncState);
+	}
+
+	child = root->ReleaseChildHasNDesc(3);
+	ASSERT_NE(child, nullptr);
+	EXPECT_EQ(child.get(), children[0]);
+	EXPECT_EQ(root->GetNumOfChildren(), 2);
+
+	// children[1] is moved to the front of the children list
+	auto header = SimpleObjects::Internal::make_unique<HeaderMgr>(
+		GetEthHistHdr_0_100()[30], 0);
+	currPtr = children[1]->AddChild(std::move(header), devSyncState);
+	EXPECT_EQ(root->ReleaseChildHasNDesc(3), nullptr);
+
+	header = SimpleObjects::Internal::make_unique<HeaderMgr>(
+		GetEthHistHdr_0_100()[31], 0);
+	currPtr->AddChild(std::move(header), devSyncState);
+
+	child = root->ReleaseChildHasNDesc(3);
+	ASSERT_NE(child, nullptr);
+	EXPECT_EQ(child.get(), children[1]);
+	EXPECT_EQ(root->GetNumOfChildren(), 1);
+
+	child = root->ReleaseChildHasNDesc(1);
+	ASSERT_NE(child, nullptr);
+	EXPECT_EQ(child.get(), children[2]);
+	EXPECT_EQ(root->GetNumOfChildren(), 0);
+
+	EXPECT_EQ(root->ReleaseChildHasNDesc(0), nullptr);
+
+	// the node can take new children after all children are released
+	header = SimpleObjects::Internal::make_unique<HeaderMgr>(
+		GetEthHistHdr_0_100()[1], 0);
+	root->AddChild(std::move(header), devSyncState);
+	EXPECT_EQ(root->GetNumOfChildren(), 1);
+	EXPECT_NE(root->ReleaseChildHasNDesc(0), nullptr);
+}
+
+GTEST_TEST(TestEthHeaderNode, ReleaseSubtree)
+{
+	// testing sync state
+	std::shared_ptr<SyncState> devSyncState =
+		std::make_shared<SyncState>(SyncState::GetDevSyncState());
+
+	std::unique_ptr<HeaderNode> root =
+		SimpleObjects::Internal::make_unique<HeaderNode>(
+			SimpleObjects::Internal::make_unique<HeaderMgr>(
+				GetEthHistHdr_0_100()[0], 0
+			),
+			devSyncState
+		);
+
+	// root -> a -> b -> c
+	//           -> d
+	//      -> e
+	size_t hdrIdx = 1;
+	auto addChild = [&](HeaderNode* parent) -> HeaderNode*
+	{
+		auto header = SimpleObjects::Internal::make_unique<HeaderMgr>(
+			GetEthHistHdr_0_100()[hdrIdx++], 0);
+		return parent->AddChild(std::move(header), devSyncState);
+	};
+	HeaderNode* a = addChild(root.get());
+	HeaderNode* b = addChild(a);
+	HeaderNode* c = addChild(b);
+	HeaderNode* d = addChild(a);
+	HeaderNode* e = addChild(root.get());
+	(void)c;
+
+	EXPECT_EQ(root->GetNumOfDesc(), 5);
+	EXPECT_EQ(root->GetNumOfDescOfChild(0), 3);
+	EXPECT_EQ(root->GetNumOfDescOfChild(1), 0);
+	EXPECT_EQ(root->GetMaxDescChildIdx(), 0);
+	EXPECT_EQ(a->GetMaxDescChildIdx(), 0);
+	EXPECT_EQ(d->GetIdxInParent(), 1);
+	EXPECT_EQ(e->GetIdxInParent(), 1);
+
+	size_t numOfNodes = 0;
+	root->ForEachInSubtree([&numOfNodes](HeaderNode*) { ++numOfNodes; });
+	EXPECT_EQ(numOfNodes, 6);
+
+	// release b -> c; ancestors are updated
+	auto subtree = a->ReleaseChild(0);
+	EXPECT_EQ(subtree.get(), b);
+	EXPECT_EQ(subtree->GetParent(), nullptr);
+	EXPECT_EQ(subtree->GetNumOfDesc(), 1);
+	EXPECT_EQ(a->GetNumOfChildren(), 1);
+	EXPECT_EQ(d->GetIdxInParent(), 0);
+	EXPECT_EQ(root->GetNumOfDesc(), 3);
+	EXPECT_EQ(root->GetNumOfDescOfChild(0), 1);
+
+	// e becomes the child with the most descendants
+	addChild(addChild(e));
+	EXPECT_EQ(root->GetMaxDescChildIdx(), 1);
+	EXPECT_EQ(root->ReleaseChildHasNDesc(2).get(), e);
+
+	EXPECT_THROW(root->ReleaseChild(1), Exception);
+	EXPECT_EQ(root->ReleaseChild(0).get(), a);
+	EXPECT_EQ(root->GetNumOfDesc(), 0);
+}
+
+GTEST_TEST(TestEthHeaderNode, PooledAllocation)
+{
+	// testing sync state
+	std::shared_ptr<SyncState> devSyncState =
+		std::make_shared<SyncState>(SyncState::GetDevSyncState());
+
+	HeaderNode::ReleaseFree();
+	HeaderMgr::ReleaseFree();
+	EXPECT_EQ(HeaderNode::GetNumOfFree(), 0);
+	EXPECT_EQ(HeaderMgr::GetNumOfFree(), 0);
+
+	auto node = SimpleObjects::Internal::make_unique<HeaderNode>(
+		SimpleObjects::Internal::make_unique<HeaderMgr>(
+			GetEthHistHdr_0_100()[0], 0
+		),
+		devSyncState
+	);
+	const void* nodeAddr = node.get();
+	const void* headerAddr = &(node->GetHeader());
+	EXPECT_EQ(node->GetExpiryGen(), 0);
+	node->SetExpiryGen(5);
+
+	// freed objects are kept in the pool
+	node.reset();
+	EXPECT_EQ(HeaderNode::GetNumOfFree(), 1);
+	EXPECT_EQ(HeaderMgr::GetNumOfFree(), 1);
+
+	// and they are recycled by the following allocations
+	node = SimpleObjects::Internal::make_unique<HeaderNode>(
+		SimpleObjects::Internal::make_unique<HeaderMgr>(
+			GetEthHistHdr_0_100()[1], 0
+		),
+		devSyncState
+	);
+	EXPECT_EQ(HeaderNode::GetNumOfFree(), 0);
+	EXPECT_EQ(HeaderMgr::GetNumOfFree(), 0);
+	EXPECT_EQ(node.get(), nodeAddr);
+	EXPECT_EQ(&(node->GetHeader()), headerAddr);
+	// the recycled node doesn't inherit the expiry generation
+	EXPECT_EQ(node->GetExpiryGen(), 0);
+	EXPECT_EQ(
+		node->GetHeader().GetRawHeader(),
+		HeaderMgr(GetEthHistHdr_0_100()[1], 0).GetRawHeader()
+	);
+
+	// the pool does not keep more than its capacity
+	std::vector<std::unique_ptr<HeaderNode> > nodes;
+	for (size_t i = 0; i < HeaderNode::sk_maxNumOfFree + 1; ++i)
+	{
+		nodes.push_back(
+			SimpleObjects::Internal::make_unique<HeaderNode>(
+				nullptr,
+				devSyncState
+			)
+		);
+	}
+	nodes.clear();
+	EXPECT_EQ(HeaderNode::GetNumOfFree(), HeaderNode::sk_maxNumOfFree);
+
+	HeaderNode::ReleaseFree();
+	EXPECT_EQ(HeaderNode::GetNumOfFree(), 0);
+}
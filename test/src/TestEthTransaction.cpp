@@ -5,6 +5,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 #include <EclipseMonitor/Eth/Transaction.hpp>
 #include <SimpleObjects/SimpleObjects.hpp>
 #include <SimpleRlp/SimpleRlp.hpp>
@@ -317,3 +319,133 @@ GTEST_TEST(TestEthTransaction, DynamicFeeTxn_15415840)
 	EXPECT_EQ(expDataObj, mgr.GetContactParams());
 }
 
+
+
+GTEST_TEST(TestEthTransaction, TransactionView_15415840)
+{
+	const SimpleObjects::Bytes* txnBytesList[] = {
+		&LegacyTxn_15415840(),
+		&AccessListTxn_15415840(),
+		&DynamicFeeTxn_15415840(),
+	};
+	const TxnVersion expVersions[] = {
+		TxnVersion::Legacy,
+		TxnVersion::AccessList,
+		TxnVersion::DynamicFee,
+	};
+
+	for (size_t i = 0; i < 3; ++i)
+	{
+		const SimpleObjects::Bytes& txnBytes = *(txnBytesList[i]);
+		Transaction txn = Transaction::FromBytes(txnBytes);
+		TransactionView view = TransactionView::FromBytes(txnBytes);
+
+		EXPECT_EQ(view.GetVersion(), expVersions[i]);
+
+		auto addr = view.GetContractAddr();
+		EXPECT_EQ(
+			SimpleObjects::Bytes(
+				addr.GetPayload(),
+				addr.GetPayload() + addr.GetPayloadSize()
+			),
+			txn.GetContractAddr()
+		);
+
+		auto params = view.GetContactParams();
+		EXPECT_EQ(
+			SimpleObjects::Bytes(
+				params.GetPayload(),
+				params.GetPayload() + params.GetPayloadSize()
+			),
+			txn.GetContactParams()
+		);
+
+		ContractAddr contractAddr;
+		std::copy(
+			addr.GetPayload(),
+			addr.GetPayload() + addr.GetPayloadSize(),
+			contractAddr.begin()
+		);
+		EXPECT_TRUE(view.IsContractAddr(contractAddr));
+		contractAddr[0] ^= 0xFFU;
+		EXPECT_FALSE(view.IsContractAddr(contractAddr));
+	}
+
+	// truncated binary
+	const SimpleObjects::Bytes& txnBytes = DynamicFeeTxn_15415840();
+	EXPECT_THROW(
+		TransactionView::FromBytes(txnBytes.data(), txnBytes.size() - 1),
+		EclipseMonitor::Exception
+	);
+	EXPECT_THROW(
+		TransactionView::FromBytes(txnBytes.data(), 0),
+		EclipseMonitor::Exception
+	);
+}
+
+
+GTEST_TEST(TestEthTransaction, BlobAndSetCodeTxn)
+{
+	// 0x9f8f72aa9304c8b593d555f12ef6589cc3a579a2
+	const SimpleObjects::Bytes expAddr({
+		0X9FU, 0X8FU, 0X72U, 0XAAU, 0X93U, 0X04U, 0XC8U, 0XB5U,
+		0X93U, 0XD5U, 0X55U, 0XF1U, 0X2EU, 0XF6U, 0X58U, 0X9CU,
+		0XC3U, 0XA5U, 0X79U, 0XA2U,
+	});
+	const SimpleObjects::Bytes* txnBytesList[] = {
+		&BlobTxn(),
+		&SetCodeTxn(),
+	};
+	const TxnVersion expVersions[] = {
+		TxnVersion::Blob,
+		TxnVersion::SetCode,
+	};
+
+	for (size_t i = 0; i < 2; ++i)
+	{
+		const SimpleObjects::Bytes& txnBytes = *(txnBytesList[i]);
+		EXPECT_TRUE(IsTxnTypeSupported(txnBytes[0]));
+
+		Transaction txn = Transaction::FromBytes(txnBytes);
+		EXPECT_EQ(txn.GetContractAddr(), expAddr);
+		EXPECT_EQ(txn.GetContactParams().size(), 68U);
+
+		TransactionView view = TransactionView::FromBytes(txnBytes);
+		EXPECT_EQ(view.GetVersion(), expVersions[i]);
+		auto params = view.GetContactParams();
+		EXPECT_EQ(
+			SimpleObjects::Bytes(
+				params.GetPayload(),
+				params.GetPayload() + params.GetPayloadSize()
+			),
+			txn.GetContactParams()
+		);
+
+		ContractAddr contractAddr;
+		std::copy(
+			expAddr.data(),
+			expAddr.data() + expAddr.size(),
+			contractAddr.begin()
+		);
+		EXPECT_TRUE(view.IsContractAddr(contractAddr));
+	}
+
+	// legacy transactions start with the RLP list
+	EXPECT_TRUE(IsTxnTypeSupported(LegacyTxn_15415840()[0]));
+
+	// unknown typed transaction envelopes
+	SimpleObjects::Bytes unknownTxn = SetCodeTxn();
+	for (uint8_t txnType : { 0x00U, 0x05U, 0x7fU })
+	{
+		unknownTxn[0] = txnType;
+		EXPECT_FALSE(IsTxnTypeSupported(unknownTxn[0]));
+		EXPECT_THROW(
+			Transaction::FromBytes(unknownTxn),
+			EclipseMonitor::Exception
+		);
+		EXPECT_THROW(
+			TransactionView::FromBytes(unknownTxn),
+			EclipseMonitor::Exception
+		);
+	}
+}
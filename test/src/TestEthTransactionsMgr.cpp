@@ -5,6 +5,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 #include <EclipseMonitor/Eth/HeaderMgr.hpp>
 #include <EclipseMonitor/Eth/TransactionsMgr.hpp>
 #include <EclipseMonitor/Eth/Trie/Trie.hpp>
@@ -68,3 +70,91 @@ GTEST_TEST(TestEthTransactionsMgr, Block15209997)
 		headerMgr.GetRawHeader().get_TransactionsRoot()
 	);
 }
+
+
+GTEST_TEST(TestEthTransactionsMgr, LazyDecoding)
+{
+	const auto headerB15415840 =
+		BlockData::ReadBinary(
+			BlockData::GetRlpFilePath("mainnet_b_15415840.header")
+		);
+	const auto txnB15415840 =
+		BlockData::ReadRlp("mainnet_b_15415840.txns");
+
+	const HeaderMgr headerMgr(headerB15415840, 0);
+
+	TransactionsMgr eagerMgr(txnB15415840.AsList());
+	TransactionsMgr lazyMgr(txnB15415840.AsList(), true);
+
+	EXPECT_FALSE(eagerMgr.IsLazy());
+	EXPECT_TRUE(lazyMgr.IsLazy());
+	EXPECT_EQ(
+		lazyMgr.GetRootHashBytes(),
+		headerMgr.GetRawHeader().get_TransactionsRoot()
+	);
+	ASSERT_EQ(
+		lazyMgr.GetNumOfTransactions(),
+		txnB15415840.AsList().size()
+	);
+	ASSERT_GT(lazyMgr.GetNumOfTransactions(), 0U);
+
+	// the views decode the same fields as the parsed transactions
+	for (size_t i = 0; i < lazyMgr.GetNumOfTransactions(); ++i)
+	{
+		const Transaction& txn = eagerMgr.GetTransaction(i);
+		TransactionView view = lazyMgr.GetTransactionView(i);
+
+		auto addr = view.GetContractAddr();
+		EXPECT_EQ(
+			SimpleObjects::Bytes(
+				addr.GetPayload(),
+				addr.GetPayload() + addr.GetPayloadSize()
+			),
+			txn.GetContractAddr()
+		);
+		auto params = view.GetContactParams();
+		EXPECT_EQ(
+			SimpleObjects::Bytes(
+				params.GetPayload(),
+				params.GetPayload() + params.GetPayloadSize()
+			),
+			txn.GetContactParams()
+		);
+	}
+	EXPECT_THROW(
+		lazyMgr.GetTransaction(0),
+		EclipseMonitor::Exception
+	);
+	EXPECT_THROW(
+		lazyMgr.GetTransactionView(lazyMgr.GetNumOfTransactions()),
+		EclipseMonitor::Exception
+	);
+
+	// search by the `to` address of the first transaction
+	ContractAddr addr;
+	{
+		auto addrView = lazyMgr.GetTransactionView(0).GetContractAddr();
+		ASSERT_EQ(addrView.GetPayloadSize(), addr.size());
+		std::copy(
+			addrView.GetPayload(),
+			addrView.GetPayload() + addrView.GetPayloadSize(),
+			addr.begin()
+		);
+	}
+	size_t expNumOfMatches = 0;
+	for (size_t i = 0; i < eagerMgr.GetNumOfTransactions(); ++i)
+	{
+		const auto& txnAddr = eagerMgr.GetTransaction(i).GetContractAddr();
+		if ((txnAddr.size() == addr.size()) &&
+			std::equal(addr.begin(), addr.end(), txnAddr.data()))
+		{
+			++expNumOfMatches;
+		}
+	}
+	auto matches = lazyMgr.SearchTransactions(addr);
+	EXPECT_EQ(matches.size(), expNumOfMatches);
+	for (const auto& match : matches)
+	{
+		EXPECT_TRUE(match.IsContractAddr(addr));
+	}
+}
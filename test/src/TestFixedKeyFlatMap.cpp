@@ -0,0 +1,164 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+
+#include <EclipseMonitor/Internal/FixedKeyFlatMap.hpp>
+
+
+namespace EclipseMonitor_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+using namespace EclipseMonitor_Test;
+
+using namespace EclipseMonitor;
+
+
+namespace
+{
+
+using TestMap = Internal::FixedKeyFlatMap<32, size_t>;
+using TestKey = typename TestMap::KeyType;
+
+
+TestKey BuildKey(uint64_t hashPart, uint8_t tail)
+{
+	TestKey key = {{ 0 }};
+	for (size_t i = 0; i < sizeof(hashPart); ++i)
+	{
+		key[i] = static_cast<uint8_t>(hashPart >> (i * 8));
+	}
+	key[key.size() - 1] = tail;
+	return key;
+}
+
+} // namespace
+
+
+GTEST_TEST(TestFixedKeyFlatMap, CountTestFile)
+{
+	static auto tmp = ++g_numOfTestFile;
+	(void)tmp;
+}
+
+
+GTEST_TEST(TestFixedKeyFlatMap, InsertFindErase)
+{
+	TestMap map;
+	EXPECT_TRUE(map.IsEmpty());
+	EXPECT_EQ(map.GetCapacity(), 0);
+	EXPECT_EQ(map.Find(BuildKey(1, 0)), nullptr);
+	EXPECT_EQ(map.Erase(BuildKey(1, 0)), 0);
+
+	EXPECT_TRUE(map.Insert(BuildKey(1, 0), 10));
+	EXPECT_TRUE(map.Insert(BuildKey(2, 0), 20));
+	EXPECT_FALSE(map.Insert(BuildKey(1, 0), 11));
+	EXPECT_EQ(map.Size(), 2);
+	EXPECT_EQ(map.GetCapacity(), TestMap::sk_minCapacity);
+
+	ASSERT_NE(map.Find(BuildKey(1, 0)), nullptr);
+	EXPECT_EQ(*map.Find(BuildKey(1, 0)), 10);
+	ASSERT_NE(map.Find(BuildKey(2, 0)), nullptr);
+	EXPECT_EQ(*map.Find(BuildKey(2, 0)), 20);
+	// same hash part, but different key
+	EXPECT_EQ(map.Find(BuildKey(1, 1)), nullptr);
+
+	map.InsertOrAssign(BuildKey(1, 0), 12);
+	map.InsertOrAssign(BuildKey(3, 0), 30);
+	EXPECT_EQ(map.Size(), 3);
+	EXPECT_EQ(*map.Find(BuildKey(1, 0)), 12);
+	EXPECT_EQ(*map.Find(BuildKey(3, 0)), 30);
+
+	EXPECT_EQ(map.Erase(BuildKey(1, 0)), 1);
+	EXPECT_EQ(map.Erase(BuildKey(1, 0)), 0);
+	EXPECT_EQ(map.Find(BuildKey(1, 0)), nullptr);
+	EXPECT_EQ(map.Size(), 2);
+
+	size_t sum = 0;
+	map.ForEach(
+		[&sum](const TestKey&, size_t val)
+		{
+			sum += val;
+		}
+	);
+	EXPECT_EQ(sum, 50);
+
+	map.Clear();
+	EXPECT_TRUE(map.IsEmpty());
+	EXPECT_EQ(map.Find(BuildKey(2, 0)), nullptr);
+	EXPECT_EQ(map.GetCapacity(), TestMap::sk_minCapacity);
+}
+
+
+GTEST_TEST(TestFixedKeyFlatMap, CollisionsAndRandomOps)
+{
+	static constexpr size_t sk_numOfOps = 20000;
+
+	std::mt19937_64 rng(12345);
+	TestMap map;
+	std::map<TestKey, size_t> expMap;
+
+	for (size_t i = 0; i < sk_numOfOps; ++i)
+	{
+		// only a few distinct hash values, so there are lots of collisions
+		// and long probe sequences, which wrap around the end of the table
+		uint64_t hashPart = rng() % 8;
+		hashPart |= (rng() % 2) << 60;
+		TestKey key = BuildKey(hashPart, static_cast<uint8_t>(rng() % 16));
+
+		switch (rng() % 3)
+		{
+		case 0:
+		{
+			bool expRes = expMap.insert(std::make_pair(key, i)).second;
+			EXPECT_EQ(map.Insert(key, i), expRes);
+			break;
+		}
+		case 1:
+			EXPECT_EQ(map.Erase(key), expMap.erase(key));
+			break;
+		default:
+		{
+			auto expIt = expMap.find(key);
+			const size_t* val = map.Find(key);
+			if (expIt == expMap.end())
+			{
+				EXPECT_EQ(val, nullptr);
+			}
+			else
+			{
+				ASSERT_NE(val, nullptr);
+				EXPECT_EQ(*val, expIt->second);
+			}
+			break;
+		}
+		}
+		ASSERT_EQ(map.Size(), expMap.size());
+	}
+
+	// all remaining entries can still be found
+	for (const auto& item : expMap)
+	{
+		const size_t* val = map.Find(item.first);
+		ASSERT_NE(val, nullptr);
+		EXPECT_EQ(*val, item.second);
+	}
+	size_t numOfEntries = 0;
+	map.ForEach(
+		[&numOfEntries, &expMap](const TestKey& key, size_t val)
+		{
+			++numOfEntries;
+			auto expIt = expMap.find(key);
+			ASSERT_NE(expIt, expMap.end());
+			EXPECT_EQ(val, expIt->second);
+		}
+	);
+	EXPECT_EQ(numOfEntries, expMap.size());
+}
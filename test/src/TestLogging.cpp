@@ -0,0 +1,250 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <EclipseMonitor/Logging.hpp>
+#include <EclipseMonitor/LogRingDrainer.hpp>
+
+
+namespace EclipseMonitor_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+using namespace EclipseMonitor_Test;
+
+using namespace EclipseMonitor;
+
+
+namespace
+{
+
+class RecordingLogger
+{
+public:
+
+	RecordingLogger(std::vector<std::string>& records) :
+		m_records(&records)
+	{}
+
+	void Debug(const std::string& msg) const
+	{
+		m_records->push_back("DEBUG: " + msg);
+	}
+
+	void Info(const std::string& msg) const
+	{
+		m_records->push_back("INFO: " + msg);
+	}
+
+	void Warn(const std::string& msg) const
+	{
+		m_records->push_back("WARN: " + msg);
+	}
+
+	void Error(const std::string& msg) const
+	{
+		m_records->push_back("ERROR: " + msg);
+	}
+
+private:
+
+	std::vector<std::string>* m_records;
+}; // class RecordingLogger
+
+
+using TestRing = LogRingBuffer<4, 16>;
+
+
+std::vector<std::string> DrainToStrings(TestRing& ring)
+{
+	std::vector<std::string> res;
+	ring.Drain(
+		[&res](const TestRing::Record* records, size_t numOfRecords)
+		{
+			for (size_t i = 0; i < numOfRecords; ++i)
+			{
+				res.push_back(
+					std::string(GetLogLevelName(records[i].m_level)) + " " +
+					records[i].GetName() + ": " + records[i].GetMsg()
+				);
+			}
+		}
+	);
+	return res;
+}
+
+} // namespace
+
+
+GTEST_TEST(TestLogging, CountTestFile)
+{
+	static auto tmp = ++g_numOfTestFile;
+	(void)tmp;
+}
+
+
+GTEST_TEST(TestLogging, LevelsEnabledForTesting)
+{
+	// the testing logger is given, so the minimum level defaults to debug
+	static_assert(
+		Logger::IsEnabled(LogLevel::Debug) &&
+		Logger::IsEnabled(LogLevel::Info) &&
+		Logger::IsEnabled(LogLevel::Warn) &&
+		Logger::IsEnabled(LogLevel::Error),
+		"All levels should be enabled for testing"
+	);
+}
+
+
+GTEST_TEST(TestLogging, StringAndLazyMessages)
+{
+	std::vector<std::string> records;
+	LoggerAdaptor<RecordingLogger> logger((RecordingLogger(records)));
+
+	const std::string str = "string";
+	logger.Debug("literal");
+	logger.Info(str);
+	logger.Warn(str + " concatenated");
+	logger.Error(std::string("error"));
+
+	size_t numOfCalls = 0;
+	logger.Debug([&numOfCalls]() -> std::string
+	{
+		++numOfCalls;
+		return std::string("lazy debug");
+	});
+	logger.Info([&]() { return "lazy " + str; });
+	logger.Warn([]() { return std::string("lazy warn"); });
+	logger.Error([]() { return std::string("lazy error"); });
+
+	EXPECT_EQ(numOfCalls, 1U);
+	EXPECT_EQ(
+		records,
+		std::vector<std::string>({
+			"DEBUG: literal",
+			"INFO: string",
+			"WARN: string concatenated",
+			"ERROR: error",
+			"DEBUG: lazy debug",
+			"INFO: lazy string",
+			"WARN: lazy warn",
+			"ERROR: lazy error",
+		})
+	);
+}
+
+
+GTEST_TEST(TestLogging, RingBufferPushAndDrain)
+{
+	TestRing ring;
+	EXPECT_TRUE(DrainToStrings(ring).empty());
+
+	EXPECT_TRUE(ring.TryPush(LogLevel::Info, "A", "msg 1"));
+	EXPECT_TRUE(ring.TryPush(LogLevel::Warn, "B", "msg 2"));
+	EXPECT_EQ(
+		DrainToStrings(ring),
+		std::vector<std::string>({ "INFO A: msg 1", "WARN B: msg 2", })
+	);
+	EXPECT_TRUE(DrainToStrings(ring).empty());
+
+	// the pending records wrap around the end of the ring, and the messages
+	// beyond the capacity are dropped
+	for (size_t i = 0; i < 6; ++i)
+	{
+		EXPECT_EQ(
+			ring.TryPush(LogLevel::Debug, "C", std::to_string(i)),
+			i < 4
+		);
+	}
+	EXPECT_EQ(ring.GetNumOfDropped(), 2U);
+	size_t numOfCalls = 0;
+	size_t numOfRecords = ring.Drain(
+		[&numOfCalls](const TestRing::Record*, size_t)
+		{
+			++numOfCalls;
+		}
+	);
+	EXPECT_EQ(numOfRecords, 4U);
+	EXPECT_EQ(numOfCalls, 2U);
+
+	// long names and messages are truncated
+	EXPECT_TRUE(ring.TryPush(
+		LogLevel::Error,
+		std::string(40, 'N'),
+		"0123456789ABCDEF-truncated"
+	));
+	EXPECT_EQ(
+		DrainToStrings(ring),
+		std::vector<std::string>({
+			"ERROR " + std::string(32, 'N') + ": 0123456789ABCDEF",
+		})
+	);
+}
+
+
+GTEST_TEST(TestLogging, RingBufferLoggerWithDrainer)
+{
+	using Ring = LogRingBuffer<1024, 64>;
+	auto ring = std::make_shared<Ring>();
+
+	std::vector<std::string> written;
+	size_t numOfBatches = 0;
+	{
+		LogRingDrainer<Ring> drainer(
+			ring,
+			[&written, &numOfBatches](
+				const Ring::Record* records,
+				size_t numOfRecords
+			)
+			{
+				++numOfBatches;
+				for (size_t i = 0; i < numOfRecords; ++i)
+				{
+					written.push_back(records[i].GetMsg());
+				}
+			},
+			std::chrono::milliseconds(1)
+		);
+
+		LoggerAdaptor<RingBufferLogger<Ring> > logger(
+			RingBufferLogger<Ring>("Test", ring)
+		);
+
+		// the producer runs on another thread, while the drainer is running
+		std::thread producer(
+			[&logger]()
+			{
+				for (size_t i = 0; i < 100; ++i)
+				{
+					logger.Info([i]() { return std::to_string(i); });
+				}
+			}
+		);
+		producer.join();
+		drainer.Flush();
+		EXPECT_EQ(written.size(), 100U);
+
+		// the remaining records are drained on destruction
+		logger.Debug("last");
+	}
+
+	EXPECT_EQ(ring->GetNumOfDropped(), 0U);
+	ASSERT_EQ(written.size(), 101U);
+	for (size_t i = 0; i < 100; ++i)
+	{
+		EXPECT_EQ(written[i], std::to_string(i));
+	}
+	EXPECT_EQ(written.back(), "last");
+	EXPECT_GT(numOfBatches, 0U);
+	EXPECT_LE(numOfBatches, 101U);
+}
@@ -0,0 +1,180 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <type_traits>
+
+#include <EclipseMonitor/Metrics.hpp>
+#include <EclipseMonitor/Eth/EventManager.hpp>
+
+#include "BlockData.hpp"
+
+
+namespace EclipseMonitor_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+using namespace EclipseMonitor_Test;
+
+using namespace EclipseMonitor;
+using namespace EclipseMonitor::Eth;
+
+
+GTEST_TEST(TestMetrics, CountTestFile)
+{
+	static auto tmp = ++g_numOfTestFile;
+	(void)tmp;
+}
+
+
+GTEST_TEST(TestMetrics, SelectedByHeader)
+{
+	static_assert(
+		std::is_same<Metrics, BasicMetrics>::value,
+		"The metrics header for testing should select BasicMetrics"
+	);
+	const bool isEnabled = Metrics::sk_isEnabled;
+	EXPECT_TRUE(isEnabled);
+}
+
+
+GTEST_TEST(TestMetrics, CountersAndGauges)
+{
+	BasicMetrics::Reset();
+	EXPECT_EQ(BasicMetrics::GetCount(MetricCounter::BloomPositive), 0U);
+
+	BasicMetrics::AddCount(MetricCounter::BloomPositive);
+	BasicMetrics::AddCount(MetricCounter::BloomPositive, 3);
+	BasicMetrics::AddCount(MetricCounter::ReceiptMatch);
+	EXPECT_EQ(BasicMetrics::GetCount(MetricCounter::BloomPositive), 4U);
+	EXPECT_EQ(BasicMetrics::GetCount(MetricCounter::ReceiptMatch), 1U);
+
+	BasicMetrics::SetGauge(MetricGauge::NumOfActiveNodes, 10);
+	BasicMetrics::SetGauge(MetricGauge::NumOfActiveNodes, 7);
+	EXPECT_EQ(BasicMetrics::GetGauge(MetricGauge::NumOfActiveNodes), 7U);
+
+	// counters can be updated from multiple threads
+	std::thread thr1(
+		[]()
+		{
+			for (size_t i = 0; i < 1000; ++i)
+			{
+				BasicMetrics::AddCount(MetricCounter::CheckpointComplete);
+			}
+		}
+	);
+	std::thread thr2(
+		[]()
+		{
+			for (size_t i = 0; i < 1000; ++i)
+			{
+				BasicMetrics::AddCount(MetricCounter::CheckpointComplete);
+			}
+		}
+	);
+	thr1.join();
+	thr2.join();
+	EXPECT_EQ(
+		BasicMetrics::GetCount(MetricCounter::CheckpointComplete),
+		2000U
+	);
+
+	BasicMetrics::Reset();
+	EXPECT_EQ(BasicMetrics::GetCount(MetricCounter::BloomPositive), 0U);
+	EXPECT_EQ(BasicMetrics::GetGauge(MetricGauge::NumOfActiveNodes), 0U);
+}
+
+
+GTEST_TEST(TestMetrics, LatencyHistogram)
+{
+	EXPECT_EQ(BasicMetrics::GetBucketIdx(0), 0U);
+	EXPECT_EQ(BasicMetrics::GetBucketIdx(1), 1U);
+	EXPECT_EQ(BasicMetrics::GetBucketIdx(2), 2U);
+	EXPECT_EQ(BasicMetrics::GetBucketIdx(3), 2U);
+	EXPECT_EQ(BasicMetrics::GetBucketIdx(4), 3U);
+	EXPECT_EQ(BasicMetrics::GetBucketIdx(1023), 10U);
+	EXPECT_EQ(BasicMetrics::GetBucketIdx(1024), 11U);
+	const size_t numOfBuckets = BasicMetrics::sk_numOfBuckets;
+	EXPECT_EQ(BasicMetrics::GetBucketIdx(UINT64_MAX), numOfBuckets - 1);
+
+	BasicMetrics::Reset();
+	BasicMetrics::AddLatencyNanoSec(MetricLatency::Validate, 0);
+	BasicMetrics::AddLatencyNanoSec(MetricLatency::Validate, 3);
+	BasicMetrics::AddLatencyNanoSec(MetricLatency::Validate, 1000);
+	BasicMetrics::AddLatencyNanoSec(MetricLatency::Validate, 1001);
+	EXPECT_EQ(BasicMetrics::GetLatencyCount(MetricLatency::Validate), 4U);
+	EXPECT_EQ(BasicMetrics::GetLatencySum(MetricLatency::Validate), 2004U);
+	EXPECT_EQ(BasicMetrics::GetLatencyBucket(MetricLatency::Validate, 0), 1U);
+	EXPECT_EQ(BasicMetrics::GetLatencyBucket(MetricLatency::Validate, 2), 1U);
+	EXPECT_EQ(BasicMetrics::GetLatencyBucket(MetricLatency::Validate, 10), 2U);
+	EXPECT_EQ(BasicMetrics::GetLatencyCount(MetricLatency::DiffCheck), 0U);
+
+	auto start = BasicMetrics::Now();
+	BasicMetrics::AddLatency(MetricLatency::DiffCheck, start);
+	EXPECT_EQ(BasicMetrics::GetLatencyCount(MetricLatency::DiffCheck), 1U);
+
+	BasicMetrics::Reset();
+	EXPECT_EQ(BasicMetrics::GetLatencyCount(MetricLatency::Validate), 0U);
+	EXPECT_EQ(BasicMetrics::GetLatencySum(MetricLatency::Validate), 0U);
+	EXPECT_EQ(BasicMetrics::GetLatencyBucket(MetricLatency::Validate, 10), 0U);
+}
+
+
+GTEST_TEST(TestMetrics, EventManagerMetrics)
+{
+	const auto headerB8628615 =
+		BlockData::ReadBinary(
+			BlockData::GetRlpFilePath("testnet_b_8628615.header")
+		);
+	const auto receiptsB8628615 =
+		BlockData::ReadRlp("testnet_b_8628615.receipts");
+
+	BasicMetrics::Reset();
+	const HeaderMgr headerMgr(headerB8628615, 0);
+	EXPECT_EQ(BasicMetrics::GetLatencyCount(MetricLatency::HeaderHash), 1U);
+
+	// DecentSyncMsgV2 address = 0x74Be867FBD89bC3507F145b36ba76cd0B1bF4f1A
+	const ContractAddr decentSyncV2Addr = {
+		0X74U, 0XBEU, 0X86U, 0X7FU, 0XBDU, 0X89U, 0XBCU, 0X35U,
+		0X07U, 0XF1U, 0X45U, 0XB3U, 0X6BU, 0XA7U, 0X6CU, 0XD0U,
+		0XB1U, 0XBFU, 0X4FU, 0X1AU,
+	};
+
+	size_t numOfEvents = 0;
+	EventManager eventMgr;
+	eventMgr.Listen(EventDescription(
+		decentSyncV2Addr,
+		std::vector<EventTopic>(),
+		[&numOfEvents](
+			const HeaderMgr&,
+			const ReceiptLogEntry&,
+			EventCallbackId
+		) -> void
+		{
+			++numOfEvents;
+		}
+	));
+
+	eventMgr.CheckEvents(
+		headerMgr,
+		[&receiptsB8628615](BlockNumber) -> const SimpleObjects::ListBaseObj&
+		{
+			return receiptsB8628615.AsList();
+		}
+	);
+
+	EXPECT_GT(numOfEvents, 0U);
+	EXPECT_EQ(BasicMetrics::GetCount(MetricCounter::BloomPositive), 1U);
+	EXPECT_EQ(BasicMetrics::GetCount(MetricCounter::ReceiptMatch), 1U);
+	EXPECT_EQ(BasicMetrics::GetLatencyCount(MetricLatency::ReceiptsFetch), 1U);
+	EXPECT_EQ(BasicMetrics::GetLatencyCount(MetricLatency::ReceiptsVerify), 1U);
+	EXPECT_EQ(
+		BasicMetrics::GetLatencyCount(MetricLatency::EventCallback),
+		numOfEvents
+	);
+}
@@ -53,6 +53,8 @@ GTEST_TEST(TestMonitorReport, MonitorConfig)
 		EXPECT_EQ(mConf.get_minDiffPercent().GetVal(),  103);
 		EXPECT_EQ(mConf.get_maxWaitTime().GetVal(),     400);
 		EXPECT_EQ(mConf.get_syncMaxWaitTime().GetVal(), 13);
+		EXPECT_EQ(mConf.get_maxChildrenPerNode().GetVal(), 16);
+		EXPECT_EQ(mConf.get_maxLiveNodes().GetVal(),    4096);
 	}
 }
 
@@ -0,0 +1,106 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include <EclipseMonitor/Internal/SortedWindow.hpp>
+
+
+namespace EclipseMonitor_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+using namespace EclipseMonitor_Test;
+
+using namespace EclipseMonitor;
+
+
+GTEST_TEST(TestSortedWindow, CountTestFile)
+{
+	static auto tmp = ++g_numOfTestFile;
+	(void)tmp;
+}
+
+
+GTEST_TEST(TestSortedWindow, PushAndPercentile)
+{
+	Internal::SortedWindow<uint64_t> window(5);
+	EXPECT_TRUE(window.IsEmpty());
+	EXPECT_EQ(window.GetCapacity(), 5);
+	EXPECT_THROW(window.GetPercentile(50), Exception);
+	EXPECT_THROW(window.GetNth(0), Exception);
+
+	for (uint64_t val : { 30, 10, 50, 20, 40 })
+	{
+		window.Push(val);
+	}
+	EXPECT_EQ(window.Size(), 5);
+	EXPECT_EQ(window.GetPercentile(0), 10);
+	EXPECT_EQ(window.GetPercentile(50), 30);
+	EXPECT_EQ(window.GetPercentile(100), 50);
+	EXPECT_EQ(window.GetNth(1), 20);
+	EXPECT_THROW(window.GetNth(5), Exception);
+	EXPECT_THROW(window.GetPercentile(101), Exception);
+
+	// 30 is the oldest, and it's evicted
+	window.Push(60);
+	EXPECT_EQ(window.Size(), 5);
+	EXPECT_EQ(window.GetNth(0), 10);
+	EXPECT_EQ(window.GetNth(2), 40);
+	EXPECT_EQ(window.GetNth(4), 60);
+
+	Internal::SortedWindow<uint64_t> other(3);
+	other.Push(1);
+	window.Swap(other);
+	EXPECT_EQ(window.Size(), 1);
+	EXPECT_EQ(window.GetCapacity(), 3);
+	EXPECT_EQ(other.Size(), 5);
+	EXPECT_EQ(other.GetCapacity(), 5);
+
+	other.Clear();
+	EXPECT_TRUE(other.IsEmpty());
+	other.Push(7);
+	EXPECT_EQ(other.GetPercentile(50), 7);
+}
+
+
+GTEST_TEST(TestSortedWindow, SlidingRandomValues)
+{
+	static constexpr size_t sk_windowSize = 17;
+
+	std::mt19937_64 rng(54321);
+	Internal::SortedWindow<uint64_t> window(sk_windowSize);
+	std::deque<uint64_t> expWindow;
+
+	for (size_t i = 0; i < 5000; ++i)
+	{
+		// a small range, so there are lots of duplicates
+		uint64_t val = rng() % 32;
+		window.Push(val);
+		expWindow.push_back(val);
+		if (expWindow.size() > sk_windowSize)
+		{
+			expWindow.pop_front();
+		}
+
+		std::vector<uint64_t> expSorted(expWindow.begin(), expWindow.end());
+		std::sort(expSorted.begin(), expSorted.end());
+		ASSERT_EQ(window.Size(), expSorted.size());
+		for (size_t j = 0; j < expSorted.size(); ++j)
+		{
+			ASSERT_EQ(window.GetNth(j), expSorted[j]);
+		}
+		EXPECT_EQ(
+			window.GetPercentile(50),
+			expSorted[expSorted.size() / 2]
+		);
+	}
+}
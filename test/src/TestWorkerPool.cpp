@@ -0,0 +1,106 @@
+// Copyright (c) 2023 Haofan Zheng
+// Use of this source code is governed by an MIT-style
+// license that can be found in the LICENSE file or at
+// https://opensource.org/licenses/MIT.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include <EclipseMonitor/Exceptions.hpp>
+#include <EclipseMonitor/WorkerPool.hpp>
+
+
+namespace EclipseMonitor_Test
+{
+	extern size_t g_numOfTestFile;
+}
+
+using namespace EclipseMonitor_Test;
+
+using namespace EclipseMonitor;
+
+
+GTEST_TEST(TestWorkerPool, CountTestFile)
+{
+	static auto tmp = ++g_numOfTestFile;
+	(void)tmp;
+}
+
+
+GTEST_TEST(TestWorkerPool, ParallelFor)
+{
+	ThreadWorkerPool workerPool(3);
+	EXPECT_EQ(workerPool.GetNumOfThreads(), 3U);
+
+	std::vector<size_t> res(1000, 0);
+	workerPool.ParallelFor(
+		res.size(),
+		[&res](size_t i)
+		{
+			res[i] = i * 2;
+		}
+	);
+	for (size_t i = 0; i < res.size(); ++i)
+	{
+		EXPECT_EQ(res[i], i * 2);
+	}
+
+	// exceptions are passed to the caller
+	EXPECT_THROW(
+		workerPool.ParallelFor(
+			res.size(),
+			[](size_t i)
+			{
+				if (i == 500)
+				{
+					throw EclipseMonitor::Exception("Test exception");
+				}
+			}
+		),
+		EclipseMonitor::Exception
+	);
+
+	// the pool is still usable after an exception
+	std::atomic<size_t> count(0);
+	workerPool.ParallelFor(
+		res.size(),
+		[&count](size_t)
+		{
+			++count;
+		}
+	);
+	EXPECT_EQ(count.load(), res.size());
+}
+
+
+GTEST_TEST(TestWorkerPool, NoWorkerThread)
+{
+	ThreadWorkerPool workerPool(0);
+	EXPECT_EQ(workerPool.GetNumOfThreads(), 0U);
+
+	std::vector<size_t> res(100, 0);
+	workerPool.ParallelFor(
+		res.size(),
+		[&res](size_t i)
+		{
+			res[i] = i + 1;
+		}
+	);
+	for (size_t i = 0; i < res.size(); ++i)
+	{
+		EXPECT_EQ(res[i], i + 1);
+	}
+
+	// nothing to do
+	EXPECT_NO_THROW(
+		workerPool.ParallelFor(
+			0,
+			[](size_t)
+			{
+				throw EclipseMonitor::Exception("Should not be called");
+			}
+		)
+	);
+}